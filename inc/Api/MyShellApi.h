@@ -0,0 +1,149 @@
+/**
+ * @file MyShellApi.h
+ * @author Bottini, Franco Nicolas.
+ * @brief Define la API embebible de MyShell (libmyshell) para ejecutar pipelines desde otros programas.
+ *        La API es reentrante: todo el estado vive en un myshell_context, no instala manejadores de señales,
+ *        no imprime en la terminal y solo espera a los procesos que ella misma creo (por PID y pidfd).
+ *        Los procesos se crean con posix_spawn, por lo que puede usarse desde programas con varios hilos.
+ *        Cada contexto debe usarse desde un unico hilo a la vez; distintos contextos son independientes.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __MYSHELL_API_H__
+#define __MYSHELL_API_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Codigo de salida de un proceso que no pudo ejecutarse **/
+#define MYSHELL_EXIT_NOT_FOUND 127
+
+/** Tipos opacos: su contenido solo se conoce dentro de la biblioteca **/
+typedef struct myshell_context myshell_context;
+typedef struct myshell_job myshell_job;
+
+/** Funcion invocada cuando finaliza un trabajo. Puede liberar el trabajo con myshell_job_free **/
+typedef void (*myshell_callback)(myshell_job *mj, int status, void *data);
+
+/**
+ * @brief Crea un contexto de ejecucion.
+ *
+ * @return myshell_context* Contexto creado. NULL en caso de error (errno indica la causa).
+ */
+myshell_context* myshell_context_new(void);
+
+/**
+ * @brief Libera un contexto. Los trabajos que siguen en ejecucion reciben SIGKILL y son esperados,
+ *        pero no se invoca su funcion ni se liberan.
+ *
+ * @param ctx Contexto a liberar.
+ */
+void myshell_context_free(myshell_context *ctx);
+
+/**
+ * @brief Obtiene un descriptor que queda listo para lectura cuando algun proceso del contexto finaliza.
+ *        Puede registrarse en poll, epoll o en el bucle de eventos del llamador.
+ *
+ * @param ctx Contexto a consultar.
+ * @return int Descriptor a esperar.
+ */
+int myshell_context_fd(myshell_context *ctx);
+
+/**
+ * @brief Atiende los procesos finalizados e invoca la funcion de cada trabajo completado.
+ *
+ * @param ctx Contexto a atender.
+ * @param timeout_ms Tiempo maximo de espera en milisegundos. 0 para no bloquear, -1 para esperar indefinidamente.
+ * @return int Cantidad de trabajos completados. -1 en caso de error (errno indica la causa).
+ */
+int myshell_context_dispatch(myshell_context *ctx, int timeout_ms);
+
+/**
+ * @brief Crea un trabajo vacio. Los descriptores se heredan del llamador hasta que se indiquen otros.
+ *
+ * @return myshell_job* Trabajo creado. NULL en caso de error (errno indica la causa).
+ */
+myshell_job* myshell_job_new(void);
+
+/**
+ * @brief Agrega un proceso al final del pipeline del trabajo.
+ *
+ * @param mj Trabajo al cual agregar el proceso.
+ * @param argv Argumentos del proceso terminados en NULL. Se copian.
+ * @return int 0 en caso de exito. -1 si argv esta vacio, el trabajo ya fue lanzado o no hay memoria (errno
+ *         indica la causa).
+ */
+int myshell_job_add_process(myshell_job *mj, char *const argv[]);
+
+/**
+ * @brief Indica los descriptores del trabajo: entrada del primer proceso, salida del ultimo y error de todos.
+ *        Los descriptores siguen perteneciendo al llamador.
+ *
+ * @param mj Trabajo a configurar.
+ * @param in_fd Descriptor de entrada. -1 para heredarlo.
+ * @param out_fd Descriptor de salida. -1 para heredarlo.
+ * @param err_fd Descriptor de error. -1 para heredarlo.
+ */
+void myshell_job_set_fds(myshell_job *mj, int in_fd, int out_fd, int err_fd);
+
+/**
+ * @brief Indica la funcion a invocar desde myshell_context_dispatch cuando finalice el trabajo.
+ *
+ * @param mj Trabajo a configurar.
+ * @param callback Funcion a invocar.
+ * @param data Dato del llamador pasado a la funcion.
+ */
+void myshell_job_set_callback(myshell_job *mj, myshell_callback callback, void *data);
+
+/**
+ * @brief Lanza el pipeline del trabajo en un grupo de procesos propio.
+ *
+ * @param ctx Contexto en el cual lanzarlo.
+ * @param mj Trabajo a lanzar.
+ * @return int 0 en caso de exito. -1 en caso de error (errno indica la causa). Un proceso que no puede
+ *         ejecutarse no es un error: finaliza con MYSHELL_EXIT_NOT_FOUND.
+ */
+int myshell_job_launch(myshell_context *ctx, myshell_job *mj);
+
+/**
+ * @brief Espera la finalizacion de un trabajo, invoca su funcion y retorna su codigo de salida.
+ *
+ * @param mj Trabajo a esperar.
+ * @return int Codigo de salida del ultimo proceso (128 + señal si fue terminado por una señal).
+ */
+int myshell_job_wait(myshell_job *mj);
+
+/**
+ * @brief Obtiene el codigo de salida de un trabajo.
+ *
+ * @param mj Trabajo a consultar.
+ * @return int Codigo de salida del ultimo proceso. -1 si todavia esta en ejecucion.
+ */
+int myshell_job_status(myshell_job *mj);
+
+/**
+ * @brief Envia una señal al grupo de procesos de un trabajo en ejecucion.
+ *
+ * @param mj Trabajo a señalar.
+ * @param sig Señal a enviar.
+ * @return int 0 en caso de exito. -1 en caso de error (errno indica la causa).
+ */
+int myshell_job_signal(myshell_job *mj, int sig);
+
+/**
+ * @brief Libera un trabajo que no esta en ejecucion.
+ *
+ * @param mj Trabajo a liberar.
+ */
+void myshell_job_free(myshell_job *mj);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__MYSHELL_API_H__
@@ -17,10 +17,18 @@
 #include <string.h>
 #include <unistd.h>
 #include <errno.h>
+#include <sys/stat.h>
 
 #include "Job/JobControl.h"
+#include "Job/JobParallel.h"
+#include "Job/JobServer.h"
+#include "Job/JobCoproc.h"
+#include "Job/JobSubst.h"
+#include "Job/JobCache.h"
 #include "Utilities/Utilities.h"
 
+extern int stdin_reserved; /** 1 si la shell lee sus comandos de la entrada estandar o atiende clientes, y los builtins no deben consumirla **/
+
 /**
  * @brief Cambia de directorio de trabajo.
  * 
@@ -57,6 +65,148 @@ void execute_kill(char* args);
  */
 void execute_fg(char* args);
 
+/**
+ * @brief Reanuda la ejecucion de un trabajo detenido en segundo plano.
+ * 
+ * @param args Argumentos de ejecucion del comando.
+ */
+void execute_bg(char* args);
+
+/**
+ * @brief Espera la finalizacion de todos los trabajos, de los trabajos dados o del primero que finalice (-n).
+ * 
+ * @param args Argumentos de ejecucion del comando.
+ */
+void execute_wait(char* args);
+
+/**
+ * @brief Ejecuta una plantilla de comando sobre una lista de argumentos con a lo sumo N trabajos simultaneos.
+ *        Uso: parallel [-j N] [--tag] [--keep-order] cmd {} [::: args... | :::: archivos...].
+ *        Sin ':::' ni '::::', o con el archivo '-', los argumentos se leen de la entrada estandar, uno por linea.
+ *        Si la shell lee su script de la entrada estandar, solo se admite una terminal.
+ * 
+ * @param args Argumentos de ejecucion del comando.
+ */
+void execute_parallel(char* args);
+
+/**
+ * @brief Habilita, deshabilita o muestra el estado del zygote de creacion de procesos.
+ *        Uso: zygote [on | off].
+ * 
+ * @param args Argumentos de ejecucion del comando.
+ */
+void execute_zygote(char* args);
+
+/**
+ * @brief Lanza un trabajo en segundo plano cuando los trabajos dados finalizan con exito. Si alguno falla,
+ *        el trabajo se cancela. Uso: after %N [%N ...] command &.
+ * 
+ * @param args Argumentos de ejecucion del comando.
+ */
+void execute_after(char* args);
+
+/**
+ * @brief Ejecuta el comando de una sustitucion $(...) y agrega su salida al buffer. El comando echo
+ *        sin redirecciones ni pipes se resuelve en el mismo proceso, sin fork.
+ * 
+ * @param command Comando a ejecutar. Se modifica durante el analisis.
+ * @param out Buffer al cual se agrega la salida.
+ * @return int Codigo de salida del comando.
+ */
+int substitute_command(char* command, job_buffer* out);
+
+/**
+ * @brief Configura o muestra el planificador de trabajos en segundo plano, o lanza un trabajo con prioridad.
+ *        Uso: sched [-n N] [fifo | priority] | sched -p N command &.
+ * 
+ * @param args Argumentos de ejecucion del comando.
+ */
+void execute_sched(char* args);
+
+/**
+ * @brief Lanza un coproceso con su entrada y salida conectadas a la shell, cierra su entrada o lista los abiertos.
+ *        Uso: coproc [-u NAME] command | coproc -c [NAME] | coproc.
+ * 
+ * @param args Argumentos de ejecucion del comando.
+ */
+void execute_coproc(char* args);
+
+/**
+ * @brief Escribe una linea en la entrada de un coproceso. Uso: write [-u NAME] text.
+ * 
+ * @param args Argumentos de ejecucion del comando.
+ */
+void execute_write(char* args);
+
+/**
+ * @brief Lee una linea de la salida de un coproceso y la muestra. Falla si se agota el tiempo o el coproceso
+ *        cerro su salida. Uso: read [-u NAME] [-t seconds].
+ * 
+ * @param args Argumentos de ejecucion del comando.
+ */
+void execute_read(char* args);
+
+/**
+ * @brief Evalua una expresion condicional en el mismo proceso y deja el resultado en last_exit_status:
+ *        0 si es verdadera, 1 si es falsa y 2 si es invalida. Admite -n, -z, -e, -f, -d, -r, -w, -x, -s,
+ *        =, !=, -eq, -ne, -lt, -le, -gt, -ge, ! y los conectores -a y -o. Uso: test expr.
+ * 
+ * @param args Argumentos de ejecucion del comando.
+ */
+void execute_test(char* args);
+
+/**
+ * @brief Igual a execute_test, con la expresion cerrada por ']'. Uso: [ expr ].
+ * 
+ * @param args Argumentos de ejecucion del comando.
+ */
+void execute_bracket(char* args);
+
+/**
+ * @brief Finaliza con exito, sin crear procesos.
+ * 
+ * @param args Argumentos de ejecucion del comando. Se ignoran.
+ */
+void execute_true(char* args);
+
+/**
+ * @brief Finaliza con error, sin crear procesos.
+ * 
+ * @param args Argumentos de ejecucion del comando. Se ignoran.
+ */
+void execute_false(char* args);
+
+/**
+ * @brief Exporta variables a los procesos hijos. Uso: export [NAME[=valor] ...]. Sin argumentos lista las
+ *        variables exportadas.
+ * 
+ * @param args Argumentos de ejecucion del comando.
+ */
+void execute_export(char* args);
+
+/**
+ * @brief Elimina variables de la shell. Uso: unset [-v] NAME [NAME ...].
+ * 
+ * @param args Argumentos de ejecucion del comando.
+ */
+void execute_unset(char* args);
+
+/**
+ * @brief Ejecuta un comando memoizado. Uso: cache [-d archivo]... [-e NAME]... [-m] [--] cmd [< in] [> out].
+ *        '-d' declara una dependencia, '-e' agrega una variable a la clave y '-m' resume los archivos por
+ *        fecha de modificacion en lugar del contenido.
+ * 
+ * @param args Argumentos de ejecucion del comando.
+ */
+void execute_cache(char* args);
+
+/**
+ * @brief Muestra los contadores e histogramas internos del control de trabajos.
+ * 
+ * @param args Argumentos de ejecucion del comando. "--json" para salida en formato JSON, "--reset" para reiniciar las metricas.
+ */
+void execute_stats(char* args);
+
 /**
  * @brief Finaliza la ejecucion del programa.
  *
@@ -78,6 +228,15 @@ void execute_clr(char* args);
  */
 void execute_extern(char* args);
 
+/**
+ * @brief Construye un trabajo a partir de una linea de comandos, separando la pipeline en procesos
+ *        y obteniendo las redirecciones de cada uno. El trabajo no se lanza.
+ * 
+ * @param args Linea de comandos sin el operador '&'. Se modifica durante el analisis.
+ * @return job* Trabajo construido. Puede no tener procesos si la linea esta vacia.
+ */
+job* build_job(char* args);
+
 /**
  * @brief Obtiene el modo de ejecucion en que se debe ejecutar un trabajo de acuerdo a partir de los argumentos dados.
  * 
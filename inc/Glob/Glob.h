@@ -0,0 +1,76 @@
+/**
+ * @file Glob.h
+ * @author Bottini, Franco Nicolas.
+ * @brief Define la expansion de nombres de archivo con '*', '?', '[...]' y '**'. Los directorios se leen con
+ *        getdents64 sobre un buffer grande y se guardan en una cache que dura una linea de comandos, de modo
+ *        que varios patrones sobre el mismo directorio lo recorren una sola vez. Los resultados se ordenan con
+ *        un quicksort de cadenas multiclave, que escala a directorios con millones de entradas.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __GLOB_H__
+#define __GLOB_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include "../Trace/Trace.h"
+#include "../Utilities/Utilities.h"
+
+/** Tamaño del buffer de lectura de getdents64 **/
+#define GLOB_DENTS_BUFFER (256 * 1024)
+
+/** Capacidad inicial de la tabla de directorios cacheados. Debe ser potencia de 2 **/
+#define GLOB_CACHE_INITIAL 16
+
+/** Estructura de datos que define el listado de un directorio **/
+typedef struct glob_dir
+{
+    char *path;         /** Ruta del directorio, "." para el directorio de trabajo **/
+    char *names;        /** Nombres de las entradas, terminados en '\0' y contiguos **/
+    size_t *offsets;    /** Posicion de cada nombre en names **/
+    unsigned char *types; /** Tipo de cada entrada (DT_DIR, DT_REG, DT_LNK, DT_UNKNOWN, ...) **/
+    size_t count;       /** Numero de entradas, sin '.' ni '..' **/
+    int error;          /** 1 si el directorio no se pudo leer **/
+} glob_dir;
+
+/** Estructura de datos que define la cache de directorios de una linea de comandos **/
+typedef struct glob_cache
+{
+    glob_dir **slots;   /** Tabla hash de directorios, por ruta **/
+    size_t cap;         /** Capacidad de la tabla **/
+    size_t used;        /** Directorios cacheados **/
+} glob_cache;
+
+/**
+ * @brief Indica si una palabra tiene caracteres especiales de patron: '*', '?' o un '[' cerrado.
+ *
+ * @param word Palabra a evaluar.
+ * @return int 1 si es un patron. 0 en caso contrario.
+ */
+int has_glob_chars(const char *word);
+
+/**
+ * @brief Expande cada patron de una linea por los archivos que coinciden, ordenados y separados por espacios.
+ *        Un patron sin coincidencias queda tal cual, al igual que las palabras entre comillas y los destinos
+ *        de redirecciones. Los archivos ocultos solo coinciden si el patron empieza con '.'.
+ *
+ * @param line Linea a expandir.
+ * @return char* Linea expandida, que debe liberarse.
+ */
+char* expand_globs(const char *line);
+
+#endif //__GLOB_H__
@@ -0,0 +1,82 @@
+/**
+ * @file JobCache.h
+ * @author Bottini, Franco Nicolas.
+ * @brief Define la memoizacion de comandos deterministas. La clave de un comando resume su texto, el directorio
+ *        de trabajo, las variables que influyen en el resultado y el contenido (o la fecha de modificacion) de
+ *        sus entradas redirigidas y dependencias declaradas. Las salidas se guardan en un almacen local
+ *        direccionado por contenido y, si la clave ya existe, se reproducen sin lanzar el trabajo.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __JOB_CACHE_H__
+#define __JOB_CACHE_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "JobControl.h"
+#include "JobSubst.h"
+#include "JobEnv.h"
+#include "../Trace/Trace.h"
+#include "../Utilities/Utilities.h"
+
+/** Variable de entorno con el directorio del almacen. Por defecto $XDG_CACHE_HOME/myshell o ~/.cache/myshell **/
+#define CACHE_ENV_VAR "MYSHELL_CACHE"
+
+/** Version del formato de las claves. Cambiarla invalida las entradas guardadas **/
+#define CACHE_KEY_VERSION "myshell-cache-1"
+
+/** Variables que siempre forman parte de la clave **/
+#define CACHE_KEY_VARS { "PATH", "LANG", "LC_ALL", "LC_COLLATE", "LC_CTYPE", "LC_NUMERIC", "LC_TIME", "TZ" }
+
+/** Estructura de datos que define un resumen de 128 bits **/
+typedef struct cache_digest
+{
+    uint64_t h[2];      /** Mitades del resumen **/
+} cache_digest;
+
+/** Estructura de datos que define las redirecciones de un comando memoizado **/
+typedef struct cache_redirections
+{
+    char **inputs;      /** Archivos redirigidos con '<', que forman parte de la clave **/
+    int n_inputs;       /** Cantidad de entradas **/
+    char *output;       /** Destino de '> archivo'. NULL si la salida no se redirige **/
+    char *error;        /** Destino de '2> archivo'. NULL si la salida de errores no se redirige **/
+} cache_redirections;
+
+/** Opciones de un comando memoizado **/
+typedef struct cache_options
+{
+    char **deps;        /** Archivos de los que depende el resultado, ademas de las entradas redirigidas **/
+    int n_deps;         /** Cantidad de dependencias **/
+    char **vars;        /** Variables adicionales que forman parte de la clave **/
+    int n_vars;         /** Cantidad de variables adicionales **/
+    int use_mtime;      /** 1 para resumir los archivos por tamaño y fecha de modificacion en lugar del contenido **/
+} cache_options;
+
+/**
+ * @brief Ejecuta un comando memoizado. Si su clave esta en el almacen, reproduce la salida estandar, la salida
+ *        de errores y el codigo de salida guardados. Si no, ejecuta el trabajo capturando sus salidas y las
+ *        guarda. Las redirecciones '> archivo' y '2> archivo' las resuelve la cache, para poder reproducirlas.
+ *
+ * @param command Linea de comandos a ejecutar. Se modifica durante el analisis.
+ * @param opt Opciones de la memoizacion.
+ * @param builder Funcion que construye el trabajo a partir de la linea de comandos.
+ * @return int Codigo de salida del comando. -1 si el comando no puede memoizarse (segundo plano, sustitucion de
+ *         procesos, '&>' o una entrada que no es un archivo regular), en cuyo caso no se ejecuta ni se modifica.
+ */
+int run_cached(char *command, cache_options *opt, job_builder builder);
+
+#endif //__JOB_CACHE_H__
@@ -21,8 +21,17 @@
 #include <fcntl.h>
 #include <string.h>
 #include <errno.h>
+#include <sys/epoll.h>
+#include <sys/syscall.h>
 
 #include "JobList.h"
+#include "JobMetrics.h"
+#include "JobOutput.h"
+#include "Zygote.h"
+#include "JobFanout.h"
+#include "JobEnv.h"
+#include "JobShm.h"
+#include "../Trace/Trace.h"
 #include "../Utilities/Utilities.h"
 
 /** Filtros admitidos para la busqueda de procesos **/
@@ -30,21 +39,84 @@ typedef enum PROCESS_FILTERS
 {
     PROC_FILTER_ALL,        /** Todos los procesos **/
     PROC_FILTER_DONE,       /** Procesos finalizados **/
-    PROC_FILTER_REMAINING   /** Procesos activos **/
+    PROC_FILTER_REMAINING,  /** Procesos activos **/
+    PROC_FILTER_RUNNING,    /** Procesos en ejecucion o reanudados **/
+    PROC_FILTER_STOPPED     /** Procesos suspendidos **/
 } PROCESS_FILTERS;
 
+/** Estructura de datos que define una consulta del listado de trabajos **/
+typedef struct jobs_query
+{
+    PROCESS_FILTERS filter;     /** Un trabajo se lista si alguno de sus procesos pasa el filtro **/
+    uint64_t since;             /** Instante en ns desde el cual debe haber cambiado el estado del proceso. 0 para no filtrar **/
+    int json;                   /** 1 para emitir JSON en lugar de texto **/
+    int pids_only;              /** 1 para listar solo los PID de los procesos que pasan el filtro **/
+} jobs_query;
+
 typedef enum SOURCE_CLEAN
 {
     SOURCE_HANDLER,
     SOURCE_FOREGROUND_EXECUTION,
     SOURCE_REANUDE_FG,
-    SOURCE_KILL
+    SOURCE_KILL,
+    SOURCE_WAIT
 } SOURCE_CLEAN;
 
+/** Variable de entorno con el maximo inicial de trabajos en segundo plano en ejecucion **/
+#define SCHEDULER_ENV_VAR "MYSHELL_MAX_JOBS"
+
+/** Politicas de orden de la cola de admision de trabajos en segundo plano **/
+typedef enum QUEUE_POLICIES
+{
+    QUEUE_FIFO,         /** Se admite el trabajo encolado primero **/
+    QUEUE_PRIORITY      /** Se admite el trabajo de mayor prioridad; a igual prioridad, el encolado primero **/
+} QUEUE_POLICIES;
+
+/** Estructura de datos que define la configuracion del planificador de trabajos en segundo plano **/
+typedef struct job_scheduler
+{
+    int max_running;        /** Maximo de trabajos en segundo plano en ejecucion. 0 si no hay limite **/
+    QUEUE_POLICIES policy;  /** Politica de orden de la cola **/
+} job_scheduler;
+
+/** Cantidad de trabajos finalizados cuyo codigo de salida se conserva al removerlos del listado **/
+#define FINISHED_JOBS_KEPT 64
+
+/** Estructura de datos que define un trabajo en segundo plano finalizado y removido del listado **/
+typedef struct finished_job
+{
+    int id;             /** ID del trabajo. 0 si la entrada esta libre **/
+    int exit_code;      /** Codigo de salida del trabajo **/
+} finished_job;
+
+/** Estructura de datos que define un descriptor registrado en un job_waiter **/
+typedef struct wait_source
+{
+    struct wait_source *next;   /** Siguiente descriptor registrado del mismo trabajo **/
+    int fd;                     /** Descriptor registrado (pidfd o salida capturada) **/
+    job *j;                     /** Trabajo al que pertenece. NULL para el canal de errores compartido **/
+    process *p;                 /** Proceso del pidfd. NULL si el descriptor es la salida capturada del trabajo **/
+} wait_source;
+
+/** Estructura de datos que permite esperar la finalizacion de un conjunto de trabajos **/
+typedef struct job_waiter
+{
+    int epfd;                       /** Instancia de epoll **/
+    int pending;                    /** Trabajos registrados que todavia no finalizaron **/
+    wait_source *channel;           /** Registro del canal de errores compartido **/
+    struct sigaction old_action;    /** Accion previa de SIGINT, restaurada al cerrar **/
+} job_waiter;
+
 extern const char* PROCESS_STATUS_STRING[]; /** String-array de los estados de un proceso **/
 
 extern int flag_work_tube_printed; /** Se pone en uno cuando se imprime el contenido de una pipe por la terminal **/
 
+extern int last_exit_status; /** Codigo de salida del ultimo trabajo esperado por la shell **/
+
+extern int job_control_interactive; /** 1 si la shell controla la terminal (modo interactivo o batch desde una terminal) **/
+
+extern job_scheduler scheduler; /** Configuracion del planificador de trabajos en segundo plano **/
+
 /**
  * @brief Inicializa el control de trabajos.
  * 
@@ -52,11 +124,45 @@ extern int flag_work_tube_printed; /** Se pone en uno cuando se imprime el conte
 void job_control_init(void);
 
 /**
- * @brief Se ejecuta al recibir la señal SIGCHLD.
+ * @brief Inicializa el control de trabajos sin terminal: no toma la terminal ni crea un grupo de procesos
+ *        propio, solo instala el manejador de SIGCHLD.
+ * 
+ */
+void job_control_init_headless(void);
+
+/**
+ * @brief Prepara una copia de la shell creada con fork para ejecutar comandos por su cuenta: olvida los trabajos,
+ *        el canal de errores y el zygote heredados, que siguen a cargo de la shell original.
+ * 
+ */
+void job_control_detach(void);
+
+/**
+ * @brief Se ejecuta al recibir la señal SIGCHLD. Solo recolecta los procesos finalizados, registra su estado
+ *        y marca que hay cambios para process_job_changes.
  * 
  */
 void childend_handler();
 
+/**
+ * @brief Atiende los cambios registrados por el manejador de SIGCHLD: informa y remueve los trabajos completados
+ *        y lanza los trabajos encolados que entren. Se invoca desde el bucle principal de la shell.
+ * 
+ */
+void process_job_changes(void);
+
+/**
+ * @brief Bloquea la entrega de SIGCHLD para que el manejador no modifique el listado de trabajos mientras se opera sobre el.
+ * 
+ */
+void block_sigchld(void);
+
+/**
+ * @brief Desbloquea la entrega de SIGCHLD. Las señales pendientes se atienden en ese momento.
+ * 
+ */
+void unblock_sigchld(void);
+
 /**
  * @brief Remueve de la lista los trabajos completados.
  * 
@@ -64,6 +170,26 @@ void childend_handler();
  */
 void clean_done_job(SOURCE_CLEAN source);
 
+/**
+ * @brief Lanza los trabajos encolados mientras haya lugar bajo el maximo de trabajos en segundo plano en ejecucion.
+ * 
+ */
+void schedule_jobs(void);
+
+/**
+ * @brief Cuenta los trabajos en segundo plano que ocupan un lugar del planificador (lanzados, no detenidos ni completados).
+ * 
+ * @return int Cantidad de trabajos en ejecucion.
+ */
+int count_running_jobs(void);
+
+/**
+ * @brief Cuenta los trabajos en la cola de admision.
+ * 
+ * @return int Cantidad de trabajos encolados.
+ */
+int count_queued_jobs(void);
+
 /**
  * @brief Actualiza el estado de un proceso.
  * 
@@ -80,7 +206,8 @@ void update_process_status(process *p, PROCESS_STATUS status);
 void wait_for_job(job *j, int catch_stoped);
 
 /**
- * @brief Ejecuta todos los procesos de un trabajo.
+ * @brief Ejecuta todos los procesos de un trabajo. Un trabajo en segundo plano se encola si el planificador
+ *        ya tiene el maximo de trabajos en ejecucion.
  * 
  * @param j Trabajo a ejecutar.
  * @param mode Modo de ejecucion del trabajo.
@@ -93,10 +220,20 @@ void launch_job(job *j, EXECUTION_MODES mode);
  * 
  * @param j Trabajo al cual pertenece el proceso.
  * @param p Proceso a ejecutar.
+ * @param pgid Process group ID del trabajo. 0 para crear un grupo nuevo, -1 para conservar el grupo de la shell.
  * @return int Estado del proceso ejecutado.
  */
 void launch_process(process *p, pid_t pgid, int in_fd, int out_fd, int err_fd, EXECUTION_MODES mode);
 
+/**
+ * @brief Espera a que un proceso recien creado ejecute exec y registra la latencia o el fallo en las metricas.
+ * 
+ * @param exec_status Pipe con close-on-exec por el cual el proceso hijo informa un fallo de exec.
+ * @param t_spawn Instante en nanosegundos previo al fork del proceso.
+ * @param latency Histograma donde registrar la latencia.
+ */
+void wait_exec_status(int exec_status[2], uint64_t t_spawn, histogram *latency);
+
 /**
  * @brief Reaunuda en primer plano la ejecucion de un trabajo detenido identificado por su ID.
  * 
@@ -104,6 +241,105 @@ void launch_process(process *p, pid_t pgid, int in_fd, int out_fd, int err_fd, E
  */
 void reanude_job_fg(int id_job);
 
+/**
+ * @brief Reaunuda en segundo plano la ejecucion de un trabajo detenido identificado por su ID.
+ * 
+ * @param id_job ID del trabajo que se quiere reaunudar.
+ */
+void reanude_job_bg(int id_job);
+
+/**
+ * @brief Inicializa un job_waiter. Bloquea SIGCHLD hasta que se cierre, de modo que los trabajos
+ *        registrados solo sean recolectados por el. SIGINT interrumpe la espera.
+ * 
+ * @param w job_waiter a inicializar.
+ * @return int 0 en caso de exito. -1 en caso de error.
+ */
+int job_waiter_init(job_waiter *w);
+
+/**
+ * @brief Registra un trabajo en un job_waiter abriendo un pidfd por proceso activo. La salida capturada
+ *        del trabajo tambien se registra y se lee a medida que llega.
+ * 
+ * @param w job_waiter donde registrar el trabajo.
+ * @param j Trabajo a registrar.
+ * @return int 1 si el trabajo ya finalizo. 0 si quedo registrado. -1 si no puede esperarse (detenido).
+ */
+int job_waiter_add(job_waiter *w, job *j);
+
+/**
+ * @brief Espera hasta que finalice alguno de los trabajos registrados. Cada evento atendido corresponde
+ *        a un proceso que termino o a salida disponible, por lo que el costo es proporcional a los eventos.
+ * 
+ * @param w job_waiter a consultar.
+ * @return job* Trabajo finalizado. NULL si no quedan trabajos registrados o si la espera fue interrumpida.
+ */
+job* job_waiter_next(job_waiter *w);
+
+/**
+ * @brief Atiende los eventos disponibles de un job_waiter sin bloquear. Su descriptor epoll puede
+ *        registrarse en otro bucle de eventos e invocarse cuando este listo para lectura.
+ * 
+ * @param w job_waiter a consultar.
+ * @return job* Trabajo finalizado. NULL si no hay mas eventos disponibles o si llego salida de un trabajo, que el
+ *         llamador puede entregar antes de volver a consultar.
+ */
+job* job_waiter_poll(job_waiter *w);
+
+/**
+ * @brief Suspende o reanuda la lectura de la salida capturada de un trabajo registrado en un job_waiter.
+ *        Mientras esta suspendida, el trabajo se bloquea al llenar su pipe de salida.
+ * 
+ * @param w job_waiter donde esta registrado el trabajo.
+ * @param j Trabajo a regular.
+ * @param paused 1 para suspender la lectura. 0 para reanudarla.
+ */
+void job_waiter_throttle(job_waiter *w, job *j, int paused);
+
+/**
+ * @brief Determina si la espera de un job_waiter fue interrumpida con SIGINT.
+ * 
+ * @param w job_waiter a consultar.
+ * @return int 1 si fue interrumpida. 0 en caso contrario.
+ */
+int job_waiter_interrupted(job_waiter *w);
+
+/**
+ * @brief Termina con SIGKILL un trabajo administrado que no llego a finalizar, lo espera, cierra su
+ *        captura de salida y lo remueve de la lista. Debe invocarse con SIGCHLD bloqueado.
+ * 
+ * @param j Trabajo a abortar.
+ */
+void abort_managed_job(job *j);
+
+/**
+ * @brief Libera los recursos de un job_waiter, restaura SIGINT y desbloquea SIGCHLD.
+ * 
+ * @param w job_waiter a cerrar.
+ */
+void job_waiter_close(job_waiter *w);
+
+/**
+ * @brief Espera la finalizacion de un conjunto de trabajos utilizando pidfds y epoll,
+ *        de modo que cada evento atendido corresponde a un proceso que efectivamente termino.
+ * 
+ * @param ids IDs de los trabajos a esperar. NULL para esperar todos los trabajos que no esten detenidos.
+ * @param n Cantidad de IDs del array.
+ * @param any 1 para retornar cuando finalice el primer trabajo. 0 para esperar a todos.
+ * @return int Codigo de salida del ultimo trabajo finalizado. 127 si algun trabajo no existe ni finalizo recientemente.
+ */
+int wait_jobs(int *ids, int n, int any);
+
+/**
+ * @brief Busca el codigo de salida de un trabajo en segundo plano que ya finalizo y fue removido del listado. Se
+ *        conservan los ultimos FINISHED_JOBS_KEPT; un ID que se reasigna a otro trabajo en segundo plano se olvida.
+ * 
+ * @param id ID del trabajo.
+ * @param exit_code Donde se guarda el codigo de salida.
+ * @return int 1 si el trabajo se encontro. 0 en caso contrario.
+ */
+int get_finished_job(int id, int *exit_code);
+
 /**
  * @brief Fuerza la finalizacion de todos los trabajos del listado.
  * 
@@ -123,6 +359,23 @@ void kill_job(int id_job);
  */
 void print_job_all_status();
 
+/**
+ * @brief Indica si un proceso pasa un filtro.
+ * 
+ * @param p Proceso a evaluar.
+ * @param filter Filtro a aplicar.
+ * @return int 1 si el proceso pasa el filtro. 0 en caso contrario.
+ */
+int match_process_filter(process *p, PROCESS_FILTERS filter);
+
+/**
+ * @brief Imprime los trabajos que cumplen una consulta, como texto o como JSON. La salida se arma completa en
+ *        memoria y se emite con una sola escritura, de modo que quien la lea no obtiene un listado a medias.
+ * 
+ * @param q Consulta a resolver.
+ */
+void print_jobs(const jobs_query *q);
+
 /**
  * @brief Imprime por consola el estado de un trabajo dado.
  * 
@@ -0,0 +1,108 @@
+/**
+ * @file JobCoproc.h
+ * @author Bottini, Franco Nicolas.
+ * @brief Define los coprocesos: trabajos en segundo plano de larga duracion cuya entrada y salida estandar
+ *        quedan conectadas a la shell por pipes persistentes. Cada coproceso se identifica por un nombre y
+ *        se le escriben y leen lineas con builtins, de modo que un unico proceso atiende muchos pedidos.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __JOB_COPROC_H__
+#define __JOB_COPROC_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <errno.h>
+
+#include "JobControl.h"
+#include "JobParallel.h"
+
+/** Nombre de los coprocesos lanzados sin nombre **/
+#define COPROC_DEFAULT_NAME "COPROC"
+
+/** Estructura de datos que define un coproceso **/
+typedef struct coproc
+{
+    struct coproc *next;    /** Siguiente coproceso de la lista **/
+    char *name;             /** Nombre del coproceso **/
+    int id;                 /** ID del trabajo lanzado **/
+    pid_t pgid;             /** Grupo de procesos del trabajo, para no confundirlo con otro que reutilice el ID **/
+    int write_fd;           /** Extremo de escritura conectado a la entrada del coproceso. -1 si ya se cerro **/
+    int read_fd;            /** Extremo de lectura conectado a la salida del coproceso **/
+    job_buffer pending;     /** Salida leida que todavia no forma una linea completa **/
+} coproc;
+
+/**
+ * @brief Lanza un coproceso con launch_job.
+ *
+ * @param name Nombre del coproceso. NULL para COPROC_DEFAULT_NAME.
+ * @param command Linea de comandos del coproceso, sin el operador '&'. Se modifica durante el analisis.
+ * @param builder Funcion que construye el trabajo a partir de la linea de comandos.
+ * @return coproc* Coproceso creado. NULL en caso de error.
+ */
+coproc* coproc_start(const char *name, char *command, job_builder builder);
+
+/**
+ * @brief Busca un coproceso por nombre.
+ *
+ * @param name Nombre del coproceso. NULL para COPROC_DEFAULT_NAME.
+ * @return coproc* Coproceso encontrado. NULL si no existe.
+ */
+coproc* coproc_find(const char *name);
+
+/**
+ * @brief Escribe datos en la entrada de un coproceso.
+ *
+ * @param c Coproceso destino.
+ * @param data Datos a escribir.
+ * @param len Longitud de los datos.
+ * @return int 0 en caso de exito. -1 en caso de error (EPIPE si el coproceso ya no lee).
+ */
+int coproc_write(coproc *c, const char *data, size_t len);
+
+/**
+ * @brief Lee una linea de la salida de un coproceso. Ctrl-C interrumpe la espera.
+ *
+ * @param c Coproceso origen.
+ * @param line Buffer donde se deja la linea, sin el salto de linea. Se reemplaza su contenido.
+ * @param timeout_ms Tiempo maximo de espera en milisegundos. -1 para esperar indefinidamente.
+ * @return int 1 si se leyo una linea. 0 si el coproceso cerro su salida. -1 si se agoto el tiempo o hubo un error.
+ */
+int coproc_read_line(coproc *c, job_buffer *line, int timeout_ms);
+
+/**
+ * @brief Cierra la entrada de un coproceso, que recibe fin de archivo. Su salida sigue disponible.
+ *
+ * @param c Coproceso a cerrar.
+ */
+void coproc_close_input(coproc *c);
+
+/**
+ * @brief Libera un coproceso y cierra sus descriptores. El trabajo sigue en el listado hasta que finalice.
+ *
+ * @param c Coproceso a liberar.
+ */
+void coproc_free(coproc *c);
+
+/**
+ * @brief Libera todos los coprocesos. Cada uno recibe fin de archivo en su entrada y puede finalizar, por lo que se
+ * llama antes de esperar a los trabajos al salir de la shell.
+ *
+ */
+void coproc_free_all(void);
+
+/**
+ * @brief Muestra los coprocesos abiertos.
+ *
+ */
+void print_coprocs(void);
+
+#endif //__JOB_COPROC_H__
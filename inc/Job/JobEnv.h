@@ -0,0 +1,126 @@
+/**
+ * @file JobEnv.h
+ * @author Bottini, Franco Nicolas.
+ * @brief Define la tabla de variables de la shell y el bloque de entorno de los procesos hijos. Cada variable
+ *        es local o exportada; el array envp con las exportadas se arma una sola vez por cada cambio y se pasa
+ *        tal cual a exec, en lugar de modificar el entorno del proceso con setenv.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __JOB_ENV_H__
+#define __JOB_ENV_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+
+/** Capacidad inicial de la tabla de variables. Debe ser potencia de 2 **/
+#define ENV_TABLE_INITIAL 64
+
+/** Estructura de datos que define una variable de la shell **/
+typedef struct env_var
+{
+    struct env_var *next;   /** Siguiente variable de la misma posicion de la tabla **/
+    char *entry;            /** Variable en la forma "NAME=valor", que tambien es la entrada del bloque de entorno **/
+    size_t name_len;        /** Longitud del nombre **/
+    int exported;           /** 1 si la variable se pasa a los procesos hijos **/
+    size_t index;           /** Posicion en el bloque de entorno, si esta exportada **/
+} env_var;
+
+/** Estructura de datos que define un valor reemplazado por una asignacion temporal **/
+typedef struct env_saved
+{
+    char *name;             /** Nombre de la variable **/
+    char *entry;            /** Entrada anterior. NULL si la variable no existia **/
+    int exported;           /** 1 si la variable estaba exportada **/
+} env_saved;
+
+/**
+ * @brief Indica si una palabra es una asignacion 'NAME=valor'.
+ *
+ * @param word Palabra a evaluar.
+ * @return size_t Longitud del nombre. 0 si no es una asignacion.
+ */
+size_t env_assignment(const char *word);
+
+/**
+ * @brief Obtiene el valor de una variable. En el primer uso la tabla se carga con el entorno del proceso.
+ *
+ * @param name Nombre de la variable.
+ * @return const char* Valor de la variable, valido hasta que se modifique. NULL si no esta definida.
+ */
+const char* env_get(const char *name);
+
+/**
+ * @brief Asigna el valor de una variable. Una variable nueva es local, y una existente conserva su estado.
+ *
+ * @param name Nombre de la variable.
+ * @param value Valor a asignar.
+ * @return int 0 en caso de exito. -1 si el nombre no es valido.
+ */
+int env_set(const char *name, const char *value);
+
+/**
+ * @brief Marca una variable como exportada, asignando su valor si se indica.
+ *
+ * @param name Nombre de la variable.
+ * @param value Valor a asignar. NULL para conservar el actual.
+ * @return int 0 en caso de exito. -1 si el nombre no es valido.
+ */
+int env_export(const char *name, const char *value);
+
+/**
+ * @brief Elimina una variable.
+ *
+ * @param name Nombre de la variable.
+ * @return int 0 en caso de exito. -1 si el nombre no es valido.
+ */
+int env_unset(const char *name);
+
+/**
+ * @brief Aplica una asignacion temporal, exportada, guardando el valor anterior para restaurarlo.
+ *
+ * @param assignment Asignacion 'NAME=valor'.
+ * @param saved Donde se guarda el valor anterior.
+ * @return int 0 en caso de exito. -1 si no es una asignacion valida.
+ */
+int env_push(const char *assignment, env_saved *saved);
+
+/**
+ * @brief Restaura un valor guardado por env_push.
+ *
+ * @param saved Valor guardado, que se libera.
+ */
+void env_pop(env_saved *saved);
+
+/**
+ * @brief Obtiene el bloque de entorno con las variables exportadas. Solo se vuelve a armar si alguna
+ *        variable exportada cambio desde la ultima llamada.
+ *
+ * @return char** Array terminado en NULL, valido hasta el proximo cambio. No debe liberarse.
+ */
+char** env_block(void);
+
+/**
+ * @brief Arma el bloque de entorno de un comando con asignaciones propias, que reemplazan o se agregan a las
+ *        variables exportadas. Las entradas se comparten con el bloque de la shell.
+ *
+ * @param assignments Asignaciones 'NAME=valor' terminadas en NULL.
+ * @return char** Array terminado en NULL, que debe liberarse con free.
+ */
+char** env_block_with(char **assignments);
+
+/**
+ * @brief Imprime las variables exportadas ordenadas por nombre, en la forma 'export NAME="valor"'.
+ *
+ * @param out Archivo de salida.
+ */
+void env_print(FILE *out);
+
+#endif //__JOB_ENV_H__
@@ -0,0 +1,48 @@
+/**
+ * @file JobFanout.h
+ * @author Bottini, Franco Nicolas.
+ * @brief Define el proceso de reparto (fan-out) del operador '|+': copia la salida de un productor a varios
+ *        consumidores dentro del kernel, con tee(2) y splice(2), sin pasar los datos por espacio de usuario.
+ *        El proceso lo crea la shell con fork como una etapa mas de la pipeline y no ejecuta ningun programa.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __JOB_FANOUT_H__
+#define __JOB_FANOUT_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <limits.h>
+#include <string.h>
+#include <errno.h>
+
+#include "JobList.h"
+
+/** Nombre del proceso de reparto dentro de la pipeline. Sus argumentos son las salidas /dev/fd/N adicionales **/
+#define FANOUT_COMMAND "[fanout]"
+
+/**
+ * @brief Determina si un proceso es el proceso de reparto de un operador '|+'.
+ *
+ * @param p Proceso a consultar.
+ * @return int 1 si es un proceso de reparto. 0 en caso contrario.
+ */
+int is_fanout_process(process *p);
+
+/**
+ * @brief Copia la entrada estandar a la salida estandar y a cada descriptor /dev/fd/N de los argumentos
+ *        hasta el fin de archivo, y finaliza el proceso. Un consumidor que termina deja de recibir datos
+ *        sin afectar a los demas. Se invoca en el proceso hijo en lugar de exec.
+ *
+ * @param p Proceso de reparto.
+ */
+void run_fanout(process *p);
+
+#endif //__JOB_FANOUT_H__
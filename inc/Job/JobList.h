@@ -14,6 +14,8 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
 
 #include "../Utilities/Utilities.h"
 
@@ -36,18 +38,39 @@ typedef enum PROCESS_STATUS
     STATUS_NEW,         /** Nuevo proceso **/
     STATUS_TERMINATED,  /** Proceso terminado antes de completarse **/
     STATUS_QUIT,        /** Salgo del proceso antes de completarse **/
-    STATUS_READY        /** Proceso agregado a un trabajo listo para correr **/
+    STATUS_READY,       /** Proceso agregado a un trabajo listo para correr **/
+    STATUS_QUEUED       /** Proceso de un trabajo en espera de ser admitido por el planificador **/
 } PROCESS_STATUS;
 
+/** Estructura de datos que define un buffer de salida capturada **/
+typedef struct job_buffer
+{
+    char *data;         /** Datos capturados **/
+    size_t len, cap;    /** Longitud y capacidad del buffer **/
+} job_buffer;
+
+/** Funcion que ejecuta una linea de comandos dentro de la shell y retorna su codigo de salida **/
+typedef int (*command_runner)(char *command);
+
 /** Estructura de datos que define un proceso **/
 typedef struct process 
 {
     struct process *next;               /** Siguiente proceso en la lista **/
     int argc;                           /** Numero de argumentos para el proceso **/
     char **argv;                        /** Array de argumentos del proceso **/
+    int envc;                           /** Numero de asignaciones propias del proceso **/
+    char **env;                         /** Asignaciones 'NAME=valor' previas al comando, terminadas en NULL. NULL si no hay **/
     char *input_path, *output_path;     /** Paths de entrada y salida de los resultados**/
+    char *error_path;                   /** Path de la salida de errores. NULL si no se redirige a un archivo **/
+    int merge_error;                    /** 1 si la salida de errores se une a la salida estandar ('2>&1' o '&>') **/
     pid_t pid;                          /** Process ID **/
     PROCESS_STATUS status;              /** Estado del proceso **/
+    uint64_t changed;                   /** Instante del ultimo cambio de estado en nanosegundos. 0 si no cambio **/
+    int exit_code;                      /** Codigo de salida (128 + señal si fue terminado por una señal) **/
+    int pidfd;                          /** Descriptor pidfd abierto mientras se espera al proceso. -1 si no hay **/
+    struct rusage usage;                /** Recursos consumidos, informados por wait4 al recolectar el proceso **/
+    int shm_slot;                       /** Fila de la tabla de trabajos en memoria compartida. -1 si no tiene **/
+    command_runner runner;              /** Ejecuta argv[1] en la copia de la shell en lugar de exec. NULL si se ejecuta argv **/
 } process;
 
 /** Estructura de datos que define un trabajo **/
@@ -58,7 +81,22 @@ typedef struct job
     struct process *first_process;  /** Primer proceso de la lista **/
     pid_t pgid;                     /** Process group ID **/
     EXECUTION_MODES mode;           /** Modo de ejecucion **/
-    int io_fd[2], err_fd[2];        /** Pipes de comunicacion **/
+    int out_fd;                     /** Extremo de lectura de la salida capturada. -1 si no se captura **/
+    job_buffer out, err;            /** Salidas estandar y de error capturadas **/
+    uint64_t start_time;            /** Instante de lanzamiento en nanosegundos **/
+    int waited;                     /** 1 si el trabajo esta registrado en un job_waiter **/
+    int managed;                    /** 1 si el trabajo es recolectado por un builtin y no por el manejador de SIGCHLD **/
+    struct wait_source *sources;    /** Descriptores registrados en el job_waiter que espera al trabajo **/
+    int priority;                   /** Prioridad de admision en la cola de trabajos. Mayor valor, antes se admite **/
+    int wait_target;                /** 1 si el builtin wait espera la finalizacion del trabajo **/
+    int *after;                     /** IDs de los trabajos que deben completarse con exito antes de lanzarlo **/
+    int n_after;                    /** Cantidad de dependencias pendientes **/
+    int after_failed;               /** 1 si alguna dependencia finalizo con error. El trabajo no se lanza **/
+    struct job **dependents;        /** Trabajos que lo nombran con after. Se resuelven una vez, al finalizar el trabajo **/
+    int n_dependents;               /** Cantidad de trabajos dependientes **/
+    int stdin_fd, stdout_fd;        /** Entrada del primer proceso y salida del ultimo provistas por la shell. -1 si no hay **/
+    struct job *substs;             /** Sustituciones de procesos <(...) y >(...), lanzadas y recolectadas junto al trabajo **/
+    int subst_fd;                   /** Extremo del pipe que el trabajo principal recibe como /dev/fd/N. -1 si no es una sustitucion **/
 } job;
 
 extern job *first_job; /** Primer trabajo de la lista **/
@@ -66,7 +104,7 @@ extern job *first_job; /** Primer trabajo de la lista **/
 /**
  * @brief Crea un nuevo trabajo.
  * 
- * @return job* Trabajo creado.
+ * @return job* Trabajo creado. NULL si no hay memoria.
  */
 job* new_job();
 
@@ -80,6 +118,15 @@ job* new_job();
  */
 process* new_process(char *command, char* infile, char* outfile);
 
+/**
+ * @brief Crea un nuevo proceso a partir de argumentos ya separados.
+ * 
+ * @param argv Array de argumentos terminado en NULL. El proceso toma posesion del array y de sus cadenas.
+ * @param argc Numero de argumentos.
+ * @return process* Proceso creado. NULL si no hay memoria; argv sigue perteneciendo al llamador.
+ */
+process* new_process_argv(char **argv, int argc);
+
 /**
  * @brief Agrega un trabajo a la lista de trabajos.
  * 
@@ -112,7 +159,8 @@ void remove_job(job *j);
 job* get_last_job();
 
 /**
- * @brief Obtiene el trabajo al cual pertenece un proceso a partir de su Process ID.
+ * @brief Obtiene el trabajo al cual pertenece un proceso a partir de su Process ID. Los procesos de una
+ *        sustitucion pertenecen al trabajo que la contiene.
  * 
  * @param pid Process ID del proceso a buscar dentro de los trabajos.
  * @return job* Trabajo al cual pertenece el proceso dado. NULL en caso de no existir ningun proceso con el PID dado.
@@ -136,13 +184,21 @@ job* get_job_by_id(int id_job);
 job* get_job_parent(job *j);
 
 /**
- * @brief Determina si un trabajo completo su ejecucion.
+ * @brief Determina si un trabajo completo su ejecucion, incluidas sus sustituciones de procesos.
  * 
  * @param j Trabajo que se quiere consultar si esta terminado.
  * @return int 1 si el trabajo esta completo. 0 si el trabajo no esta completo.
  */
 int is_job_completed(job *j);
 
+/**
+ * @brief Obtiene el codigo de salida de un trabajo, que corresponde al del ultimo proceso de su pipeline.
+ * 
+ * @param j Trabajo del cual se quiere obtener el codigo de salida.
+ * @return int Codigo de salida del trabajo.
+ */
+int get_job_exit_code(job *j);
+
 /**
  * @brief Determina si el trabajo esta en ejecucion.
  * 
@@ -159,6 +215,14 @@ int is_job_runnig(job* j);
  */
 int is_job_stoped(job* j);
 
+/**
+ * @brief Determina si el trabajo esta en la cola de admision.
+ * 
+ * @param j Trabajo que se quiere consultar si esta en cola.
+ * @return int 1 si el trabajo esta en cola. 0 si el trabajo ya fue lanzado.
+ */
+int is_job_queued(job* j);
+
 /**
  * @brief Determina si hay algun trabajo corriendo en primer plano.
  * 
@@ -215,7 +279,7 @@ int is_process_stoped(process *p);
 void set_process_status(process* p, PROCESS_STATUS status);
 
 /**
- * @brief Libera la memoria alocada por un trabajo.
+ * @brief Libera la memoria alocada por un trabajo y sus sustituciones, cerrando los pipes de estas.
  * 
  * @param j Trabajo a liberar.
  */
@@ -0,0 +1,109 @@
+/**
+ * @file JobMetrics.h
+ * @author Bottini, Franco Nicolas.
+ * @brief Define los contadores e histogramas internos del control de trabajos.
+ *        Los histogramas son de estilo HDR: cada potencia de dos se divide en sub-buckets lineales,
+ *        lo que mantiene un error relativo acotado con memoria fija.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __JOB_METRICS_H__
+#define __JOB_METRICS_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../Utilities/Utilities.h"
+
+/** Bits de precision de cada potencia de dos de los histogramas **/
+#define HIST_SUB_BITS 3
+
+/** Cantidad de sub-buckets lineales por potencia de dos **/
+#define HIST_SUB_COUNT (1 << HIST_SUB_BITS)
+
+/** Cantidad total de buckets de un histograma **/
+#define HIST_BUCKETS ((64 - HIST_SUB_BITS + 1) * HIST_SUB_COUNT)
+
+/** Estructura de datos que define un histograma de latencias **/
+typedef struct histogram
+{
+    uint64_t count;                 /** Cantidad de muestras registradas **/
+    uint64_t sum;                   /** Suma de todas las muestras **/
+    uint64_t min, max;              /** Muestras minima y maxima **/
+    uint64_t buckets[HIST_BUCKETS]; /** Conteo de muestras por bucket **/
+} histogram;
+
+/** Estructura de datos que agrupa las metricas del control de trabajos **/
+typedef struct job_metrics
+{
+    uint64_t jobs_launched;         /** Trabajos lanzados **/
+    uint64_t jobs_queued;           /** Trabajos en segundo plano encolados por el planificador **/
+    uint64_t processes_forked;      /** Procesos creados con fork **/
+    uint64_t exec_failures;         /** Procesos que no pudieron ejecutar exec **/
+    uint64_t jobs_reaped;           /** Trabajos finalizados y removidos del listado **/
+    uint64_t signals_received;      /** Señales atendidas por la shell **/
+    uint64_t jobs_active;           /** Trabajos presentes en el listado **/
+    uint64_t jobs_peak;             /** Maximo de trabajos concurrentes **/
+    histogram spawn_latency;        /** Latencia desde el fork hasta el exec (ns) **/
+    histogram zygote_latency;       /** Latencia desde el pedido al zygote hasta el exec (ns) **/
+    histogram job_duration;         /** Duracion de los trabajos (ns) **/
+} job_metrics;
+
+extern job_metrics metrics; /** Metricas globales del control de trabajos **/
+
+/**
+ * @brief Registra una muestra en un histograma.
+ *
+ * @param h Histograma sobre el cual registrar.
+ * @param value Valor de la muestra.
+ */
+void histogram_record(histogram *h, uint64_t value);
+
+/**
+ * @brief Obtiene el valor correspondiente a un percentil de un histograma.
+ *
+ * @param h Histograma a consultar.
+ * @param percentile Percentil a obtener (0 a 100).
+ * @return uint64_t Valor aproximado del percentil. 0 si el histograma esta vacio.
+ */
+uint64_t histogram_percentile(histogram *h, double percentile);
+
+/**
+ * @brief Registra el lanzamiento de un trabajo y actualiza el maximo de trabajos concurrentes.
+ *
+ */
+void metrics_job_launched(void);
+
+/**
+ * @brief Registra la finalizacion de un trabajo.
+ *
+ * @param duration Duracion del trabajo en nanosegundos.
+ */
+void metrics_job_reaped(uint64_t duration);
+
+/**
+ * @brief Reinicia todas las metricas excepto la cantidad de trabajos activos.
+ *
+ */
+void metrics_reset(void);
+
+/**
+ * @brief Imprime las metricas en formato de texto legible.
+ *
+ * @param fp Archivo donde imprimir.
+ */
+void metrics_print_text(FILE *fp);
+
+/**
+ * @brief Imprime las metricas en formato JSON.
+ *
+ * @param fp Archivo donde imprimir.
+ */
+void metrics_print_json(FILE *fp);
+
+#endif //__JOB_METRICS_H__
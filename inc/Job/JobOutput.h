@@ -0,0 +1,133 @@
+/**
+ * @file JobOutput.h
+ * @author Bottini, Franco Nicolas.
+ * @brief Define la captura de la salida de los trabajos con asignacion perezosa de descriptores.
+ *        La salida de error de todos los trabajos se multiplexa por un unico socket de flujo compartido;
+ *        cada porcion leida se atribuye a su trabajo a partir del PID del emisor (SCM_CREDENTIALS).
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __JOB_OUTPUT_H__
+#define __JOB_OUTPUT_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+
+#include "JobList.h"
+#include "../Utilities/Utilities.h"
+
+/** Tamaño del buffer de lectura de la salida de los trabajos **/
+#define JOB_OUTPUT_CHUNK 65536
+
+/** Tamaño solicitado para los buffers del canal de errores compartido **/
+#define JOB_OUTPUT_SOCKBUF (4 * 1024 * 1024)
+
+/**
+ * @brief Eleva el limite blando de descriptores abiertos (RLIMIT_NOFILE) hasta el limite duro.
+ *
+ */
+void raise_fd_limit(void);
+
+/**
+ * @brief Restaura el limite blando de descriptores que la shell tenia antes de elevarlo. Se invoca en cada
+ *        proceso hijo antes de exec, para que los programas no hereden un limite que no pidieron.
+ *
+ */
+void restore_fd_limit(void);
+
+/**
+ * @brief Obtiene el extremo de escritura del canal de errores compartido, creandolo en el primer uso.
+ *
+ * @return int Descriptor del extremo de escritura. -1 en caso de error (errno indica la causa).
+ */
+int job_error_channel(void);
+
+/**
+ * @brief Obtiene un descriptor de /dev/null compartido para la entrada de los trabajos en segundo plano.
+ *
+ * @return int Descriptor abierto en modo lectura. -1 en caso de error (errno indica la causa).
+ */
+int job_null_input(void);
+
+/**
+ * @brief Lee todos los datos pendientes del canal de errores y los agrega al buffer del trabajo emisor.
+ *        Los datos de procesos que no pertenecen a ningun trabajo se imprimen directamente.
+ *
+ */
+void drain_job_output(void);
+
+/**
+ * @brief Obtiene el extremo de lectura del canal de errores compartido.
+ *
+ * @return int Descriptor del extremo de lectura. -1 si el canal todavia no fue creado.
+ */
+int job_error_reader(void);
+
+/**
+ * @brief Cierra el canal de errores compartido heredado de la shell que hizo fork. La copia de la shell crea
+ *        su propio canal en el primer uso, de modo que no lee los errores de los trabajos de la original.
+ *
+ */
+void forget_error_channel(void);
+
+/**
+ * @brief Agrega datos a un buffer de salida capturada.
+ *
+ * @param b Buffer al cual agregar los datos.
+ * @param data Datos a agregar.
+ * @param len Cantidad de bytes a agregar.
+ */
+void append_job_buffer(job_buffer *b, const char *data, size_t len);
+
+/**
+ * @brief Agrega texto con formato a un buffer de salida capturada.
+ *
+ * @param b Buffer al cual agregar el texto.
+ * @param format Formato, como en printf.
+ */
+void append_job_format(job_buffer *b, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief Escribe el contenido de un buffer en un descriptor con una sola llamada a write, salvo que la
+ *        escritura sea parcial o se interrumpa.
+ *
+ * @param fd Descriptor de destino.
+ * @param b Buffer a escribir.
+ * @return int 0 en caso de exito. -1 si la escritura falla.
+ */
+int write_job_buffer(int fd, const job_buffer *b);
+
+/**
+ * @brief Reserva un descriptor para capturar la salida de un trabajo en segundo plano. La captura puede ocupar
+ *        como maximo la mitad del limite de descriptores; el resto queda disponible para pidfds, pipelines y redirecciones.
+ *
+ * @return int 0 si hay descriptores disponibles. -1 si se alcanzo el limite (errno se establece en EMFILE).
+ */
+int reserve_capture_fd(void);
+
+/**
+ * @brief Libera un descriptor reservado con reserve_capture_fd.
+ *
+ */
+void release_capture_fd(void);
+
+/**
+ * @brief Determina si un error corresponde al agotamiento de descriptores de archivo.
+ *
+ * @param err Codigo de error a evaluar.
+ * @return int 1 si se agotaron los descriptores. 0 en caso contrario.
+ */
+int is_fd_exhausted(int err);
+
+#endif //__JOB_OUTPUT_H__
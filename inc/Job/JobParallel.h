@@ -0,0 +1,63 @@
+/**
+ * @file JobParallel.h
+ * @author Bottini, Franco Nicolas.
+ * @brief Define la ejecucion en abanico (fan-out) de un comando sobre una lista de argumentos,
+ *        con un maximo de trabajos concurrentes. Los trabajos se lanzan con launch_job y forman
+ *        parte del listado de trabajos mientras se ejecutan.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __JOB_PARALLEL_H__
+#define __JOB_PARALLEL_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "JobControl.h"
+
+/** Cadena que se reemplaza por el argumento en la plantilla del comando **/
+#define PARALLEL_PLACEHOLDER "{}"
+
+/** Codigo de salida maximo, como en GNU parallel **/
+#define PARALLEL_MAX_EXIT 101
+
+/** Funcion que construye un trabajo a partir de una linea de comandos **/
+typedef job* (*job_builder)(char *command);
+
+/** Opciones de ejecucion en paralelo **/
+typedef struct parallel_options
+{
+    int max_jobs;       /** Maximo de trabajos concurrentes **/
+    int tag;            /** 1 para anteponer el argumento a cada linea de salida **/
+    int keep_order;     /** 1 para emitir las salidas en el orden de los argumentos **/
+} parallel_options;
+
+/**
+ * @brief Expande la plantilla de un comando reemplazando cada aparicion de {} por el argumento.
+ *        Si la plantilla no contiene {}, el argumento se agrega al final.
+ *
+ * @param template Plantilla del comando.
+ * @param arg Argumento a insertar.
+ * @return char* Comando expandido. Debe liberarse con free.
+ */
+char* expand_parallel_template(const char *template, const char *arg);
+
+/**
+ * @brief Ejecuta la plantilla una vez por argumento con a lo sumo max_jobs trabajos simultaneos.
+ *        La salida de cada trabajo se captura y se emite agrupada cuando el trabajo finaliza.
+ *
+ * @param template Plantilla del comando.
+ * @param args Argumentos sobre los que se ejecuta la plantilla.
+ * @param n Cantidad de argumentos.
+ * @param opt Opciones de ejecucion.
+ * @param builder Funcion que construye cada trabajo a partir del comando expandido.
+ * @return int Cantidad de trabajos fallidos (hasta PARALLEL_MAX_EXIT).
+ */
+int run_parallel(const char *template, char **args, int n, parallel_options *opt, job_builder builder);
+
+#endif //__JOB_PARALLEL_H__
@@ -0,0 +1,99 @@
+/**
+ * @file JobServer.h
+ * @author Bottini, Franco Nicolas.
+ * @brief Define el modo servidor de MyShell. La shell escucha en un socket UNIX local, recibe lineas de comandos
+ *        o argv ya separados, los ejecuta con el control de trabajos y devuelve la salida estandar, la salida de error
+ *        y el codigo de salida de cada trabajo. Todos los clientes se atienden desde un unico bucle de eventos.
+ *
+ *        Protocolo: cada mensaje es una trama formada por un server_frame seguido de len bytes de datos.
+ *        Cliente a servidor: 'c' linea de comandos, que una copia de la shell ejecuta como con -c; 'a' argumentos
+ *        terminados en NUL, ejecutados directamente.
+ *        Servidor a cliente: 'o' salida estandar; 'e' salida de error; 'x' codigo de salida (int32_t).
+ *        Cada cliente ejecuta sus pedidos en orden, uno a la vez; distintos clientes se ejecutan en forma concurrente.
+ *        Si un cliente no lee sus respuestas, la lectura de la salida de su trabajo se suspende.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __JOB_SERVER_H__
+#define __JOB_SERVER_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+
+#include "JobControl.h"
+#include "JobParallel.h"
+
+/** Opcion de linea de comandos que inicia el modo servidor **/
+#define SERVER_OPTION "--server"
+
+/** Trama con una linea de comandos **/
+#define SERVER_FRAME_COMMAND 'c'
+
+/** Trama con argumentos terminados en NUL **/
+#define SERVER_FRAME_ARGV 'a'
+
+/** Trama con salida estandar de un trabajo **/
+#define SERVER_FRAME_STDOUT 'o'
+
+/** Trama con salida de error de un trabajo **/
+#define SERVER_FRAME_STDERR 'e'
+
+/** Trama con el codigo de salida de un trabajo **/
+#define SERVER_FRAME_EXIT 'x'
+
+/** Longitud maxima de los datos de una trama recibida **/
+#define SERVER_MAX_FRAME (1024 * 1024)
+
+/** Bytes pendientes de envio a un cliente a partir de los cuales se suspende la lectura de la salida de su trabajo **/
+#define SERVER_MAX_OUTPUT (1024 * 1024)
+
+/** Nombre del proceso que ejecuta una linea de comandos recibida en una copia de la shell **/
+#define SERVER_SCRIPT_COMMAND "[script]"
+
+/** Cantidad maxima de eventos atendidos por iteracion del bucle **/
+#define SERVER_MAX_EVENTS 64
+
+/** Encabezado de una trama del protocolo **/
+typedef struct server_frame
+{
+    uint8_t type;           /** Tipo de trama **/
+    uint8_t reserved[3];    /** Reservado, en cero **/
+    uint32_t len;           /** Longitud de los datos que siguen al encabezado **/
+} server_frame;
+
+/** Estructura de datos que define un cliente conectado **/
+typedef struct server_client
+{
+    struct server_client *next;     /** Siguiente cliente de la lista **/
+    int fd;                         /** Socket del cliente **/
+    job_buffer in;                  /** Datos recibidos todavia no procesados **/
+    job_buffer out;                 /** Datos pendientes de envio **/
+    size_t out_off;                 /** Bytes de out ya enviados **/
+    uint32_t events;                /** Eventos registrados en epoll para el socket **/
+    int eof;                        /** 1 si el cliente no enviara mas pedidos **/
+    int closing;                    /** 1 si la conexion se perdio y el cliente debe liberarse **/
+    int throttled;                  /** 1 si la lectura de la salida del trabajo esta suspendida **/
+    job *j;                         /** Trabajo en ejecucion. NULL si no hay **/
+} server_client;
+
+/**
+ * @brief Ejecuta la shell en modo servidor hasta recibir SIGINT o SIGTERM.
+ *
+ * @param path Ruta del socket UNIX. Si existe, se reemplaza.
+ * @param runner Funcion que ejecuta una linea de comandos en la copia de la shell creada para cada trama 'c'.
+ * @return int 0 si el servidor finalizo normalmente. -1 en caso de error.
+ */
+int run_server(const char *path, command_runner runner);
+
+#endif //__JOB_SERVER_H__
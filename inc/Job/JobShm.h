@@ -0,0 +1,115 @@
+/**
+ * @file JobShm.h
+ * @author Bottini, Franco Nicolas.
+ * @brief Define la tabla de trabajos publicada en memoria compartida. Cada proceso de los trabajos ocupa una
+ *        fila de un archivo en /dev/shm mapeado con mmap, que se actualiza con cada cambio de estado. Las
+ *        escrituras se protegen con un seqlock, de modo que un monitor externo obtiene una copia consistente
+ *        sin bloqueos y sin comunicarse con la shell.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __JOB_SHM_H__
+#define __JOB_SHM_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+#include "JobList.h"
+#include "../Utilities/Utilities.h"
+
+/** Variable de entorno que habilita la publicacion de la tabla de trabajos **/
+#define JOB_SHM_ENV_VAR "MYSHELL_JOB_TABLE"
+
+/** Formato del path de la tabla, con el PID de la shell **/
+#define JOB_SHM_PATH "/dev/shm/myshell-%d.jobs"
+
+/** Identificador del formato de la tabla ("MYSHJOBS") **/
+#define JOB_SHM_MAGIC 0x53424F4A4853594DULL
+
+/** Version del formato de la tabla. Cambia si cambia la disposicion de las estructuras **/
+#define JOB_SHM_VERSION 1
+
+/** Cantidad de filas de la tabla. Los procesos que no entran se cuentan en overflow **/
+#define JOB_SHM_SLOTS 512
+
+/** Longitud maxima del comando guardado en cada fila, incluido el fin de cadena **/
+#define JOB_SHM_COMMAND_LEN 64
+
+/** Estructura de datos que define la fila de un proceso. job_id 0 indica una fila libre **/
+typedef struct job_shm_entry
+{
+    int32_t job_id;                     /** ID del trabajo **/
+    int32_t pgid;                       /** Process group ID del trabajo **/
+    int32_t pid;                        /** Process ID. 0 si el trabajo esta encolado **/
+    int32_t status;                     /** Estado del proceso, segun PROCESS_STATUS **/
+    int32_t exit_code;                  /** Codigo de salida (128 + señal si fue terminado por una señal) **/
+    int32_t mode;                       /** Modo de ejecucion del trabajo, segun EXECUTION_MODES **/
+    uint64_t start_time;                /** Lanzamiento del trabajo en ns de CLOCK_MONOTONIC. 0 si no se lanzo **/
+    uint64_t utime_us, stime_us;        /** Tiempo de CPU de usuario y de sistema, conocido al recolectar el proceso **/
+    uint64_t maxrss_kb;                 /** Maximo de memoria residente, conocido al recolectar el proceso **/
+    char command[JOB_SHM_COMMAND_LEN];  /** Comando del proceso, truncado **/
+} job_shm_entry;
+
+/** Estructura de datos que define la tabla publicada **/
+typedef struct job_shm_table
+{
+    uint64_t magic;                         /** JOB_SHM_MAGIC, escrito al final de la inicializacion **/
+    uint32_t version;                       /** JOB_SHM_VERSION **/
+    uint32_t entry_size;                    /** sizeof(job_shm_entry) **/
+    uint32_t n_slots;                       /** JOB_SHM_SLOTS **/
+    int32_t shell_pid;                      /** PID de la shell que publica la tabla **/
+    _Atomic uint64_t seq;                   /** Contador del seqlock. Impar mientras la tabla se modifica **/
+    uint64_t updated;                       /** Ultima modificacion en ns de CLOCK_MONOTONIC **/
+    uint32_t used;                          /** Filas ocupadas **/
+    uint32_t overflow;                      /** Procesos que no se publicaron por falta de filas **/
+    job_shm_entry entries[JOB_SHM_SLOTS];   /** Filas de los procesos **/
+} job_shm_table;
+
+/**
+ * @brief Crea y mapea la tabla si JOB_SHM_ENV_VAR esta definida y no es "0". Un proceso creado con fork que
+ *        vuelve a inicializar el control de trabajos descarta la tabla heredada y publica la propia.
+ *
+ */
+void job_shm_init(void);
+
+/**
+ * @brief Publica el estado de los procesos de un trabajo, asignandoles una fila si todavia no la tienen.
+ *        SIGCHLD se bloquea durante la escritura, para que su manejador no anide otra dentro del seqlock.
+ *
+ * @param j Trabajo a publicar.
+ * @param p Proceso que cambio de estado. NULL para publicar todos los procesos del trabajo.
+ */
+void job_shm_publish(job *j, process *p);
+
+/**
+ * @brief Libera las filas de los procesos de un trabajo que deja el listado.
+ *
+ * @param j Trabajo a remover de la tabla.
+ */
+void job_shm_release(job *j);
+
+/**
+ * @brief Copia una tabla publicada, reintentando mientras la shell la modifica. Permite a un monitor escrito
+ *        en C leer la tabla de otra shell.
+ *
+ * @param table Tabla mapeada con permiso de lectura.
+ * @param copy Donde se guarda la copia.
+ * @return int 0 en caso de exito. -1 si la tabla no tiene un formato conocido.
+ */
+int job_shm_snapshot(const job_shm_table *table, job_shm_table *copy);
+
+#endif //__JOB_SHM_H__
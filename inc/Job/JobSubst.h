@@ -0,0 +1,67 @@
+/**
+ * @file JobSubst.h
+ * @author Bottini, Franco Nicolas.
+ * @brief Define la sustitucion de comandos $(...) y `...`: el comando se ejecuta como un trabajo administrado
+ *        cuya salida se captura por el pipe de captura, con lecturas grandes sobre un buffer que crece, y
+ *        reemplaza al texto original sin los saltos de linea finales y separada en campos.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __JOB_SUBST_H__
+#define __JOB_SUBST_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "JobControl.h"
+#include "JobParallel.h"
+
+/** Funcion que ejecuta el comando de una sustitucion y agrega su salida al buffer. Retorna su codigo de salida **/
+typedef int (*substitution_runner)(char *command, job_buffer *out);
+
+/** Funcion que obtiene el valor de una variable para la expansion de $NAME. Retorna NULL si no esta definida **/
+typedef const char* (*variable_lookup)(const char *name);
+
+/** Funcion que evalua una expresion aritmetica $((...)). Retorna 0 en caso de exito y -1 si es invalida **/
+typedef int (*arithmetic_evaluator)(const char *expr, variable_lookup lookup, long *result);
+
+/** Funciones que resuelven cada tipo de expansion de una linea **/
+typedef struct expansion_hooks
+{
+    substitution_runner run;        /** Ejecuta los comandos de las sustituciones **/
+    variable_lookup lookup;         /** Resuelve las variables. NULL para dejarlas sin expandir **/
+    arithmetic_evaluator arith;     /** Evalua $((...)). NULL para tratarlo como una sustitucion de comandos **/
+} expansion_hooks;
+
+/** Longitud maxima del nombre de una variable expandida **/
+#define SUBST_MAX_NAME 256
+
+/**
+ * @brief Ejecuta un comando como trabajo administrado y captura su salida estandar. Ctrl-C lo termina.
+ *
+ * @param command Linea de comandos a ejecutar. Se modifica durante el analisis.
+ * @param builder Funcion que construye el trabajo a partir de la linea de comandos.
+ * @param out Buffer al cual se agrega la salida.
+ * @param err Buffer al cual se agrega la salida de errores. NULL para descartarla.
+ * @return int Codigo de salida del trabajo. 128 + SIGINT si fue interrumpido.
+ */
+int capture_job_output(char *command, job_builder builder, job_buffer *out, job_buffer *err);
+
+/**
+ * @brief Reemplaza las sustituciones $(...) y `...` de una linea por la salida de su comando, separada
+ *        en campos por espacios, las variables $NAME, ${NAME} y $? por su valor y $((...)) por el resultado
+ *        de la expresion. Las sustituciones pueden anidarse con $(...).
+ *
+ * @param line Linea a expandir.
+ * @param hooks Funciones que resuelven cada tipo de expansion.
+ * @return char* Linea expandida, que debe liberarse. NULL si hay una sustitucion sin cerrar o una expresion invalida.
+ */
+char* expand_substitutions(const char *line, const expansion_hooks *hooks);
+
+#endif //__JOB_SUBST_H__
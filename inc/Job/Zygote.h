@@ -0,0 +1,105 @@
+/**
+ * @file Zygote.h
+ * @author Bottini, Franco Nicolas.
+ * @brief Define un proceso auxiliar (zygote) que crea los procesos de los trabajos en lugar de la shell.
+ *        El zygote se crea al inicio, cuando el espacio de direcciones de la shell todavia es minimo, y recibe
+ *        pedidos (argv, envp, pgid y descriptores via SCM_RIGHTS) por un socket UNIX. Los procesos se crean con
+ *        CLONE_PARENT, por lo que siguen siendo hijos de la shell y el control de trabajos no cambia.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __ZYGOTE_H__
+#define __ZYGOTE_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <sys/types.h>
+
+#include "JobList.h"
+#include "JobEnv.h"
+#include "JobOutput.h"
+#include "../Utilities/Utilities.h"
+
+/** Variable de entorno que habilita el zygote al iniciar la shell **/
+#define ZYGOTE_ENV_VAR "MYSHELL_ZYGOTE"
+
+/** Tamaño maximo de un pedido (argv + envp + directorio de trabajo) **/
+#define ZYGOTE_MAX_REQUEST (128 * 1024)
+
+/** Cantidad de descriptores enviados en cada pedido: stdin, stdout, stderr, estado de exec y directorio de trabajo **/
+#define ZYGOTE_FDS 5
+
+/** Encabezado de un pedido de creacion de proceso **/
+typedef struct zygote_request
+{
+    pid_t pgid;         /** Process group ID del trabajo. 0 para crear un grupo nuevo, -1 para conservar el actual **/
+    int foreground;     /** 1 si el proceso debe tomar la terminal **/
+    int argc;           /** Cantidad de argumentos **/
+    int envc;           /** Cantidad de variables de entorno **/
+    size_t len;         /** Longitud del bloque de cadenas que sigue al encabezado **/
+} zygote_request;
+
+/**
+ * @brief Crea el proceso zygote.
+ *
+ * @return int 0 en caso de exito. -1 en caso de error.
+ */
+int zygote_start(void);
+
+/**
+ * @brief Finaliza el proceso zygote. Los procesos siguientes se crean directamente con fork.
+ *
+ */
+void zygote_stop(void);
+
+/**
+ * @brief Deja de usar el zygote heredado de la shell que hizo fork, sin detenerlo: sigue a cargo de esa shell.
+ *        Los procesos siguientes se crean directamente con fork.
+ *
+ */
+void zygote_forget(void);
+
+/**
+ * @brief Determina si el zygote esta activo.
+ *
+ * @return int 1 si esta activo. 0 en caso contrario.
+ */
+int zygote_enabled(void);
+
+/**
+ * @brief Determina si un proceso finalizado es el zygote y, en ese caso, lo da de baja.
+ *
+ * @param pid PID del proceso finalizado.
+ * @return int 1 si el proceso era el zygote. 0 en caso contrario.
+ */
+int zygote_exited(pid_t pid);
+
+/**
+ * @brief Pide al zygote la creacion de un proceso.
+ *
+ * @param p Proceso a crear.
+ * @param pgid Process group ID del trabajo. 0 para crear un grupo nuevo, -1 para conservar el grupo de la shell.
+ * @param in_fd Descriptor de entrada del proceso.
+ * @param out_fd Descriptor de salida del proceso.
+ * @param err_fd Descriptor de salida de errores del proceso.
+ * @param status_fd Extremo de escritura del pipe de estado de exec.
+ * @param mode Modo de ejecucion del proceso.
+ * @return pid_t PID del proceso creado. -1 en caso de error (errno indica la causa; E2BIG si el pedido es demasiado grande).
+ */
+pid_t zygote_spawn(process *p, pid_t pgid, int in_fd, int out_fd, int err_fd, int status_fd, EXECUTION_MODES mode);
+
+#endif //__ZYGOTE_H__
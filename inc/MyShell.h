@@ -18,10 +18,20 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <poll.h>
 
 #include "Executors.h"
+#include "Script/ScriptInterpreter.h"
+#include "Glob/Glob.h"
+#include "Trace/Trace.h"
 #include "Utilities/Utilities.h"
 
+/** Opcion de linea de comandos que ejecuta un unico comando sin terminal **/
+#define COMMAND_OPTION "-c"
+
+/** Opcion de linea de comandos que fija el maximo de archivos de comandos ejecutados a la vez **/
+#define PARALLEL_OPTION "--parallel"
+
 /** Longitud maxima de las entradas que admtide el programa **/
 #define MAX_LEN_INPUT 256 
 
@@ -48,9 +58,37 @@ typedef enum COMMANDS_FLAGS
     CMM_ECHO = 3,       /** Comando echo **/
     CMM_JOBS = 4,       /** Comando jobs **/
     CMM_KILL = 5,       /** Comando kill **/
-    CMM_FG = 6          /** Comando fg **/
+    CMM_FG = 6,         /** Comando fg **/
+    CMM_STATS = 7,      /** Comando stats **/
+    CMM_BG = 8,         /** Comando bg **/
+    CMM_WAIT = 9,       /** Comando wait **/
+    CMM_PARALLEL = 10,  /** Comando parallel **/
+    CMM_ZYGOTE = 11,    /** Comando zygote **/
+    CMM_SCHED = 12,     /** Comando sched **/
+    CMM_AFTER = 13,     /** Comando after **/
+    CMM_COPROC = 14,    /** Comando coproc **/
+    CMM_WRITE = 15,     /** Comando write **/
+    CMM_READ = 16,      /** Comando read **/
+    CMM_TEST = 17,      /** Comando test **/
+    CMM_BRACKET = 18,   /** Comando [ **/
+    CMM_TRUE = 19,      /** Comando true **/
+    CMM_FALSE = 20,     /** Comando false **/
+    CMM_EXPORT = 21,    /** Comando export **/
+    CMM_UNSET = 22,     /** Comando unset **/
+    CMM_CACHE = 23      /** Comando cache **/
 } COMMANDS_FLAGS;
 
+/** Estructura de datos que define la ejecucion de un archivo de comandos en una sesion propia **/
+typedef struct batch_session
+{
+    const char *path;       /** Archivo de comandos **/
+    pid_t pid;              /** Proceso de la sesion. -1 si todavia no se lanzo **/
+    int out_fd, err_fd;     /** Extremos de lectura de las salidas de la sesion. -1 si se cerraron **/
+    job_buffer out, err;    /** Salidas recibidas mientras la sesion espera su turno para emitirlas **/
+    int status;             /** Codigo de salida de la sesion **/
+    int done;               /** 1 si la sesion finalizo **/
+} batch_session;
+
 /** Array de los comandos admitidos **/
 const char* CMM_VALIDS[] = {
     "quit",
@@ -59,7 +97,24 @@ const char* CMM_VALIDS[] = {
     "echo",
     "jobs",
     "kill",
-    "fg"
+    "fg",
+    "stats",
+    "bg",
+    "wait",
+    "parallel",
+    "zygote",
+    "sched",
+    "after",
+    "coproc",
+    "write",
+    "read",
+    "test",
+    "[",
+    "true",
+    "false",
+    "export",
+    "unset",
+    "cache"
 };
 
 /**
@@ -72,8 +127,31 @@ void print_welcome();
  * @brief Valida que el numero de parametros introducido al ejecutar el programa sea valido.
  * 
  * @param argc Numero de argumentos de entrada.
+ * @param argv Array de argumentos de entrada.
+ */
+void myshell_validate_execution(int argc, char* argv[]);
+
+/**
+ * @brief Ejecuta un unico comando (modo -c) sin configurar la terminal ni imprimir la bienvenida.
+ *        Un comando externo simple (sin pipes, redirecciones ni '&') reemplaza a la shell con exec, sin fork.
+ * 
+ * @param command Comando a ejecutar.
+ * @return int Codigo de salida del comando.
+ */
+int myshell_run_command(char* command);
+
+/**
+ * @brief Ejecuta varios archivos de comandos a la vez (MyShell a.sh b.sh ... [--parallel N]). Cada archivo corre
+ *        en una sesion propia, un proceso hijo de la shell creado con fork y sin exec, con su directorio de
+ *        trabajo, sus variables y su tabla de trabajos. La salida de cada archivo se emite completa y en el orden
+ *        de los argumentos: la del mas antiguo en curso se transmite en el momento y las demas se acumulan.
+ * 
+ * @param argc Numero de argumentos, sin el nombre del programa.
+ * @param argv Archivos de comandos y opcion --parallel N, con N el maximo de sesiones simultaneas (por
+ *             defecto, el numero de CPUs).
+ * @return int Cantidad de archivos que finalizaron con error, con un maximo de PARALLEL_MAX_EXIT.
  */
-void myshell_validate_execution(int argc);
+int myshell_run_batches(int argc, char* argv[]);
 
 /**
  * @brief Ejecuta el loop principal de la shell de manera indefinida.
@@ -97,6 +175,21 @@ void print_prompt(void);
  */
 FILE* command_source(int argc, char* argv[]);
 
+/**
+ * @brief Agrega una linea al texto pendiente de analizar y, cuando cierra todas las estructuras de control
+ *        abiertas (if, while, for, case, funciones), lo analiza una unica vez y ejecuta el arbol resultante.
+ * 
+ * @param input Linea leida.
+ * @return int 1 si faltan lineas para completar el texto. 0 si se ejecuto o se descarto por un error de sintaxis.
+ */
+int input_script(char* input);
+
+/**
+ * @brief Descarta el texto pendiente de input_script al terminar la entrada, informando el error.
+ * 
+ */
+void input_script_end(void);
+
 /**
  * @brief Interpreta y ejecuta un comando dado.
  * 
@@ -104,6 +197,14 @@ FILE* command_source(int argc, char* argv[]);
  */
 void input_decode(char* input);
 
+/**
+ * @brief Obtiene el identificador de un comando.
+ * 
+ * @param command Nombre del comando.
+ * @return COMMANDS_FLAGS Identificador del comando. CMM_EXTERN si no es un comando interno.
+ */
+COMMANDS_FLAGS get_command_flag(const char* command);
+
 /**
  * @brief Ejecuta un comando a partir de su identificador y sus argumentos. 
  * 
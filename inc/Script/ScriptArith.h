@@ -0,0 +1,67 @@
+/**
+ * @file ScriptArith.h
+ * @author Bottini, Franco Nicolas.
+ * @brief Define la expansion aritmetica $((...)) y el comando ((...)): un evaluador de expresiones enteras
+ *        con la precedencia de C, variables y asignaciones, ejecutado en el proceso de la shell. Cada expresion
+ *        se analiza una vez a un arbol que se guarda en una cache, de modo que un bucle no la vuelve a analizar.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __SCRIPT_ARITH_H__
+#define __SCRIPT_ARITH_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+
+#include "../Job/JobSubst.h"
+#include "../Job/JobEnv.h"
+
+/** Numero de entradas de la cache de expresiones analizadas. Debe ser potencia de 2 **/
+#define ARITH_CACHE_SIZE 256
+
+/** Longitud maxima del nombre de una variable en una expresion **/
+#define ARITH_MAX_NAME 256
+
+/** Operaciones de los nodos de una expresion **/
+typedef enum ARITH_OPS
+{
+    ARITH_NUM, ARITH_VAR,
+    ARITH_NEG, ARITH_PLUS, ARITH_NOT, ARITH_BIT_NOT,
+    ARITH_PRE_INC, ARITH_PRE_DEC, ARITH_POST_INC, ARITH_POST_DEC,
+    ARITH_MUL, ARITH_DIV, ARITH_MOD, ARITH_POW, ARITH_ADD, ARITH_SUB, ARITH_SHL, ARITH_SHR,
+    ARITH_LT, ARITH_LE, ARITH_GT, ARITH_GE, ARITH_EQ, ARITH_NE,
+    ARITH_BIT_AND, ARITH_BIT_XOR, ARITH_BIT_OR, ARITH_AND, ARITH_OR,
+    ARITH_TERNARY, ARITH_ASSIGN, ARITH_COMMA
+} ARITH_OPS;
+
+/** Estructura de datos que define un nodo de una expresion **/
+typedef struct arith_node
+{
+    ARITH_OPS op;               /** Operacion del nodo **/
+    ARITH_OPS assign_op;        /** En ARITH_ASSIGN, operacion compuesta (+=, -=, ...). ARITH_ASSIGN para '=' **/
+    long value;                 /** Valor de ARITH_NUM **/
+    char *name;                 /** Variable de ARITH_VAR, de las asignaciones y de ++/-- **/
+    struct arith_node *left;    /** Primer operando **/
+    struct arith_node *right;   /** Segundo operando **/
+    struct arith_node *third;   /** Rama falsa del operador ternario **/
+} arith_node;
+
+/**
+ * @brief Evalua una expresion aritmetica. Las variables sin definir o vacias valen 0, y las asignaciones
+ *        se guardan en la tabla de variables. Los errores se informan por stderr.
+ *
+ * @param expr Expresion a evaluar, con las variables $NAME ya expandidas.
+ * @param lookup Funcion que resuelve las variables de la expresion.
+ * @param result Donde se deja el resultado.
+ * @return int 0 en caso de exito. -1 si la expresion es invalida o divide por cero.
+ */
+int evaluate_arithmetic(const char *expr, variable_lookup lookup, long *result);
+
+#endif //__SCRIPT_ARITH_H__
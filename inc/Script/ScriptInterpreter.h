@@ -0,0 +1,88 @@
+/**
+ * @file ScriptInterpreter.h
+ * @author Bottini, Franco Nicolas.
+ * @brief Define el interprete de las estructuras de control. Recorre el arbol de sintaxis en el proceso de la
+ *        shell: las condiciones, los bucles, break/continue/return, las asignaciones y las llamadas a funciones
+ *        no crean procesos, y cada comando simple se entrega a la shell, que resuelve builtins y trabajos.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __SCRIPT_INTERPRETER_H__
+#define __SCRIPT_INTERPRETER_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <fnmatch.h>
+
+#include "ScriptParser.h"
+#include "ScriptArith.h"
+#include "../Job/JobControl.h"
+#include "../Job/JobSubst.h"
+#include "../Glob/Glob.h"
+
+/** Nombre de la shell, valor de $0 **/
+#define SCRIPT_SHELL_NAME "MyShell"
+
+/** Funcion que ejecuta un comando simple y deja su codigo de salida en last_exit_status **/
+typedef void (*script_runner)(char *line);
+
+/** Estructura de datos que define una funcion de la shell **/
+typedef struct script_function
+{
+    struct script_function *next;   /** Siguiente funcion definida **/
+    char *name;                     /** Nombre de la funcion **/
+    script_node *body;              /** Cuerpo de la funcion, copiado del texto que la define **/
+    int active;                     /** Numero de llamadas en curso **/
+    script_node *stale;             /** Cuerpo reemplazado durante una llamada en curso, a liberar al terminar **/
+} script_function;
+
+/** Estructura de datos que define los parametros posicionales de una llamada **/
+typedef struct script_frame
+{
+    struct script_frame *prev;      /** Llamada que contiene a esta **/
+    char **argv;                    /** Parametros $1..$n **/
+    int argc;                       /** Numero de parametros, valor de $# **/
+    int shift;                      /** Parametros descartados por shift **/
+} script_frame;
+
+/**
+ * @brief Inicializa el interprete.
+ *
+ * @param run Funcion que ejecuta los comandos simples.
+ * @param hooks Funciones de expansion para las palabras del for y del case, los argumentos de las funciones,
+ *              las asignaciones y el comando ((...)). Deben seguir validas mientras se use el interprete.
+ */
+void script_init(script_runner run, const expansion_hooks *hooks);
+
+/**
+ * @brief Ejecuta una lista de sentencias. En modo interactivo Ctrl-C interrumpe la ejecucion.
+ *
+ * @param tree Lista de sentencias analizada con script_parse.
+ * @return int Codigo de salida de la ultima sentencia ejecutada, que tambien queda en last_exit_status.
+ */
+int execute_script(script_node *tree);
+
+/**
+ * @brief Obtiene el valor de una variable para la expansion de $NAME y ${NAME}. Resuelve los parametros
+ *        especiales $?, $#, $@, $*, $0 y $1..$9 y, para el resto, la tabla de variables.
+ *
+ * @param name Nombre de la variable.
+ * @return const char* Valor de la variable, valido hasta la proxima consulta. NULL si no esta definida.
+ */
+const char* script_variable(const char *name);
+
+/**
+ * @brief Indica si hay una funcion definida con el nombre dado.
+ *
+ * @param name Nombre a buscar.
+ * @return int 1 si la funcion existe. 0 en caso contrario.
+ */
+int is_script_function(const char *name);
+
+#endif //__SCRIPT_INTERPRETER_H__
@@ -0,0 +1,112 @@
+/**
+ * @file ScriptParser.h
+ * @author Bottini, Franco Nicolas.
+ * @brief Define el analizador de las estructuras de control de MyShell: if/elif/else, while/until, for ... in,
+ *        case, funciones, grupos { } y listas con && y ||. El texto se analiza una unica vez a un arbol de
+ *        sintaxis; los comandos simples se conservan como texto y se expanden recien al ejecutarse.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __SCRIPT_PARSER_H__
+#define __SCRIPT_PARSER_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "../Utilities/Utilities.h"
+
+/** Tipos de nodos del arbol de sintaxis **/
+typedef enum SCRIPT_NODE_TYPES
+{
+    NODE_COMMAND,   /** Comando simple, ejecutado por la shell **/
+    NODE_AND,       /** cond && body **/
+    NODE_OR,        /** cond || body **/
+    NODE_NOT,       /** ! body **/
+    NODE_GROUP,     /** { body } **/
+    NODE_IF,        /** if cond then body [elif ... | else alt] fi **/
+    NODE_WHILE,     /** while cond do body done **/
+    NODE_UNTIL,     /** until cond do body done **/
+    NODE_FOR,       /** for name [in text] do body done **/
+    NODE_CASE,      /** case text in items esac **/
+    NODE_FUNCTION   /** name() body **/
+} SCRIPT_NODE_TYPES;
+
+/** Posibles resultados del analisis **/
+typedef enum SCRIPT_PARSE_RESULT
+{
+    PARSE_ERROR = -1,       /** Error de sintaxis **/
+    PARSE_INCOMPLETE = 0,   /** Falta texto para cerrar alguna estructura **/
+    PARSE_OK = 1            /** Analisis exitoso **/
+} SCRIPT_PARSE_RESULT;
+
+struct script_node;
+
+/** Estructura de datos que define una alternativa de un case **/
+typedef struct case_item
+{
+    struct case_item *next;     /** Siguiente alternativa **/
+    char **patterns;            /** Patrones de la alternativa, separados por '|' en el texto **/
+    int n_patterns;             /** Numero de patrones **/
+    struct script_node *body;   /** Sentencias a ejecutar si algun patron coincide **/
+} case_item;
+
+/** Estructura de datos que define un nodo del arbol de sintaxis **/
+typedef struct script_node
+{
+    struct script_node *next;   /** Siguiente sentencia de la lista **/
+    SCRIPT_NODE_TYPES type;     /** Tipo del nodo **/
+    char *text;                 /** Linea del comando, palabras del for o palabra del case **/
+    char *name;                 /** Variable del for o nombre de la funcion **/
+    struct script_node *cond;   /** Condicion, o lado izquierdo de && y || **/
+    struct script_node *body;   /** Cuerpo, o lado derecho de && y || **/
+    struct script_node *alt;    /** Rama elif/else del if **/
+    case_item *items;           /** Alternativas del case **/
+} script_node;
+
+/**
+ * @brief Analiza un texto completo a un arbol de sintaxis. Los errores de sintaxis se informan por stderr.
+ *
+ * @param text Texto a analizar, con una o mas lineas.
+ * @param tree Donde se deja la lista de sentencias analizadas. NULL si el resultado no es PARSE_OK.
+ * @return SCRIPT_PARSE_RESULT PARSE_INCOMPLETE si el texto termina dentro de una estructura.
+ */
+SCRIPT_PARSE_RESULT script_parse(const char *text, script_node **tree);
+
+/**
+ * @brief Copia un arbol de sintaxis, por ejemplo el cuerpo de una funcion que sobrevive al texto analizado.
+ *
+ * @param n Lista de sentencias a copiar.
+ * @return script_node* Copia de la lista.
+ */
+script_node* clone_script(const script_node *n);
+
+/**
+ * @brief Libera un arbol de sintaxis.
+ *
+ * @param n Lista de sentencias a liberar.
+ */
+void free_script(script_node *n);
+
+/**
+ * @brief Obtiene el final de la palabra que comienza en s, respetando comillas y parentesis.
+ *
+ * @param s Comienzo de la palabra.
+ * @return const char* Primer caracter despues de la palabra. NULL si una comilla o un parentesis no se cierra.
+ */
+const char* script_word_end(const char *s);
+
+/**
+ * @brief Indica si una palabra es reservada por las estructuras de control.
+ *
+ * @param word Palabra a evaluar.
+ * @return int 1 si es reservada. 0 en caso contrario.
+ */
+int is_script_keyword(const char *word);
+
+#endif //__SCRIPT_PARSER_H__
@@ -0,0 +1,107 @@
+/**
+ * @file Trace.h
+ * @author Bottini, Franco Nicolas.
+ * @brief Define un mecanismo de trazado de bajo costo para medir las fases de ejecucion de MyShell.
+ *        Los intervalos (spans) se almacenan en un buffer circular prealocado y se vuelcan en formato
+ *        Chrome/Perfetto JSON al finalizar el programa cuando la variable de entorno MYSHELL_TRACE esta definida.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+
+#include "../Utilities/Utilities.h"
+
+/** Variable de entorno que habilita el trazado e indica el archivo de salida **/
+#define TRACE_ENV_VAR "MYSHELL_TRACE"
+
+/** Cantidad de intervalos que admite el buffer circular (potencia de dos) **/
+#define TRACE_RING_SIZE 65536
+
+/** Estructura de datos que define un intervalo trazado **/
+typedef struct trace_event
+{
+    const char *name;   /** Nombre de la fase (cadena estatica) **/
+    uint64_t ts;        /** Instante de inicio en nanosegundos **/
+    uint64_t dur;       /** Duracion en nanosegundos **/
+    int64_t arg;        /** Argumento asociado al intervalo (PID, ID de trabajo, etc.) **/
+} trace_event;
+
+extern int trace_enabled; /** Se pone en uno cuando el trazado esta habilitado **/
+
+/**
+ * @brief Inicializa el trazado si la variable de entorno MYSHELL_TRACE esta definida.
+ *        Preasigna el buffer circular y registra el volcado del archivo al finalizar el programa.
+ *
+ */
+void trace_init(void);
+
+/**
+ * @brief Obtiene el instante actual del reloj monotonico.
+ *
+ * @return uint64_t Instante actual en nanosegundos.
+ */
+uint64_t trace_clock(void);
+
+/**
+ * @brief Registra un intervalo en el buffer circular.
+ *
+ * @param name Nombre de la fase (debe ser una cadena estatica).
+ * @param start Instante de inicio del intervalo obtenido con trace_begin.
+ * @param arg Argumento asociado al intervalo. -1 si no tiene.
+ */
+void trace_record(const char *name, uint64_t start, int64_t arg);
+
+/**
+ * @brief Vuelca el contenido del buffer circular al archivo de trazas en formato Chrome JSON.
+ *
+ */
+void trace_flush(void);
+
+/**
+ * @brief Marca el comienzo de un intervalo. Si el trazado esta deshabilitado no consulta el reloj.
+ *
+ * @return uint64_t Instante de inicio del intervalo. 0 si el trazado esta deshabilitado.
+ */
+static inline uint64_t trace_begin(void)
+{
+    return trace_enabled ? trace_clock() : 0;
+}
+
+/**
+ * @brief Marca el final de un intervalo. Si el trazado esta deshabilitado no hace nada.
+ *
+ * @param name Nombre de la fase (debe ser una cadena estatica).
+ * @param start Instante de inicio del intervalo obtenido con trace_begin.
+ */
+static inline void trace_end(const char *name, uint64_t start)
+{
+    if (trace_enabled)
+        trace_record(name, start, -1);
+}
+
+/**
+ * @brief Marca el final de un intervalo asociandole un argumento. Si el trazado esta deshabilitado no hace nada.
+ *
+ * @param name Nombre de la fase (debe ser una cadena estatica).
+ * @param start Instante de inicio del intervalo obtenido con trace_begin.
+ * @param arg Argumento asociado al intervalo.
+ */
+static inline void trace_end_arg(const char *name, uint64_t start, int64_t arg)
+{
+    if (trace_enabled)
+        trace_record(name, start, arg);
+}
+
+#endif //__TRACE_H__
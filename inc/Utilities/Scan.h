@@ -0,0 +1,50 @@
+/**
+ * @file Scan.h
+ * @author Bottini, Franco Nicolas.
+ * @brief Define el escaner de caracteres especiales de la linea de comandos. Busca operadores, comillas y '$'
+ *        comparando bloques de 16 o 32 bytes con SSE2 o AVX2, segun lo que soporte el procesador, de modo que
+ *        los tramos de texto comun de los argumentos se saltean de una vez en lugar de byte a byte.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __SCAN_H__
+#define __SCAN_H__
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SCAN_SIMD
+#include <immintrin.h>
+#endif
+
+/** Variable de entorno que limita el juego de instrucciones del escaner: "scalar", "sse2" o "avx2" **/
+#define SCAN_ENV_VAR "MYSHELL_SCAN"
+
+/** Cantidad maxima de caracteres que la version SSE2 compara uno por uno. Con mas, se usa la de la libc **/
+#define SCAN_SSE2_MAX_SET 4
+
+/** Estructura de datos que define un conjunto de caracteres como dos tablas indexadas por nibble **/
+typedef struct scan_set
+{
+    uint8_t lo[16];     /** Grupos con algun caracter de cada nibble bajo **/
+    uint8_t hi[16];     /** Grupo de cada nibble alto. Un caracter pertenece si lo[bajo] & hi[alto] != 0 **/
+} scan_set;
+
+/**
+ * @brief Busca la primera aparicion de cualquiera de los caracteres dados. La implementacion se elige en la
+ *        primera llamada: AVX2 clasifica cada byte con dos tablas de 16 entradas, con un costo que no depende
+ *        de la cantidad de caracteres, SSE2 compara contra cada caracter y, sin ellas, se usa strcspn.
+ *
+ * @param str Cadena sobre la cual operar.
+ * @param set Caracteres a buscar.
+ * @return char* Puntero al primer caracter encontrado, o al fin de la cadena si no aparece ninguno.
+ */
+char* find_chars(const char* str, const char* set);
+
+#endif //__SCAN_H__
@@ -13,7 +13,11 @@
 #define __UTILITIES_H__
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
+#include <time.h>
+
+#include "Scan.h"
 
 /** Define los codigos para cambiar el color del texto en la terminal **/
 #ifndef TERMINAL_TEXT_COLORS
@@ -41,6 +45,13 @@
     #define ASCII_PERCENT       37      /** '%'  **/
     #define ASCII_GREATER_THAN  62      /** '>'  **/
     #define ASCII_LESS_THAN     60      /** '<'  **/
+    #define ASCII_ONE           49      /** '1'  **/
+    #define ASCII_TWO           50      /** '2'  **/
+    #define ASCII_TAB           9       /** '\t' **/
+    #define ASCII_OPEN_PAREN    40      /** '('  **/
+    #define ASCII_CLOSE_PAREN   41      /** ')'  **/
+    #define ASCII_BACKTICK      96      /** '`'  **/
+    #define ASCII_PLUS          43      /** '+'  **/
 #endif
 
 /**
@@ -62,6 +73,16 @@ char* get_substr_before_chars(char* str, char c1, char c2);
  */
 char* get_word_after_char(char* str, char character);
 
+/**
+ * @brief Quita de la cadena las redirecciones de la salida de errores ('2> archivo', '2>&1' y el '&' de '&> archivo'),
+ *        reemplazandolas por espacios. La redireccion de la salida estandar de '&>' queda en la cadena.
+ * 
+ * @param str Cadena sobre la cual operar.
+ * @param merge Se establece en 1 si la salida de errores debe unirse a la salida estandar.
+ * @return char* Archivo de la salida de errores ("\n" si falta el nombre). NULL si no se redirige a un archivo.
+ */
+char* cut_error_redirection(char* str, int* merge);
+
 /**
  * @brief Elimina los espacios en blanco al comienzo y final de una cadena.
  * 
@@ -70,6 +91,14 @@ char* get_word_after_char(char* str, char character);
  */
 char* trim_white_space(char* str);
 
+/**
+ * @brief Obtiene el parentesis que cierra al parentesis dado, teniendo en cuenta los anidados.
+ * 
+ * @param str Cadena que comienza con el parentesis de apertura.
+ * @return char* Puntero al parentesis de cierre. NULL si no esta cerrado.
+ */
+char* get_matching_paren(char* str);
+
 /**
  * @brief Genera un array bidimensional segmentando una cadena en sus espacios. Se agrega NULL como ultimo elemento del array.
  * 
@@ -79,6 +108,13 @@ char* trim_white_space(char* str);
  */
 char** str_to_array(char* str, int* n);
 
+/**
+ * @brief Obtiene el instante actual del reloj monotonico del sistema.
+ * 
+ * @return uint64_t Instante actual en nanosegundos.
+ */
+uint64_t get_monotonic_ns(void);
+
 /**
  * @brief Libera la memoria alocada por un array bidimensional.
  * 
@@ -0,0 +1,446 @@
+/**
+ * @file MyShellApi.c
+ * @author Bottini, Franco Nicolas.
+ * @brief Implementacion de la API embebible de MyShell.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../../inc/Api/MyShellApi.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <signal.h>
+#include <spawn.h>
+#include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/wait.h>
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+
+#include "../../inc/Job/JobList.h"
+
+/** Estructura de datos que agrupa los trabajos lanzados por un llamador **/
+struct myshell_context
+{
+    int epfd;                   /** Instancia de epoll con los pidfds de los procesos en ejecucion **/
+    myshell_job *first;         /** Primer trabajo en ejecucion **/
+};
+
+/** Estructura de datos que define un trabajo de la API **/
+struct myshell_job
+{
+    struct myshell_job *next;   /** Siguiente trabajo en ejecucion del contexto **/
+    myshell_context *ctx;       /** Contexto en el que se lanzo. NULL si no esta en ejecucion **/
+    job *j;                     /** Procesos del pipeline **/
+    int fds[3];                 /** Entrada, salida y error provistos por el llamador. -1 para heredarlos **/
+    myshell_callback callback;  /** Funcion invocada al finalizar. NULL si no hay **/
+    void *data;                 /** Dato del llamador pasado a la funcion **/
+};
+
+extern char **environ;
+
+/** Señales que los procesos creados restablecen a su accion por defecto **/
+static const int default_signals[] = { SIGINT, SIGQUIT, SIGTSTP, SIGTTIN, SIGTTOU, SIGCHLD, SIGPIPE };
+
+static void api_reap_process(process *p, int blocking)
+{
+    int status;
+    pid_t pid;
+
+    while ((pid = waitpid(p->pid, &status, blocking ? 0 : WNOHANG)) < 0 && errno == EINTR);
+
+    if (pid == 0)
+        return;
+
+    if (pid < 0)
+        p->exit_code = EXIT_FAILURE;
+    else if (WIFSIGNALED(status))
+        p->exit_code = 128 + WTERMSIG(status);
+    else
+        p->exit_code = WEXITSTATUS(status);
+
+    set_process_status(p, pid > 0 && WIFSIGNALED(status) ? STATUS_TERMINATED : STATUS_DONE);
+
+    if (p->pidfd >= 0)
+    {
+        close(p->pidfd);
+        p->pidfd = -1;
+    }
+}
+
+static void api_unlink_job(myshell_job *mj)
+{
+    myshell_job **link = &mj->ctx->first;
+
+    while (*link && *link != mj)
+        link = &(*link)->next;
+
+    if (*link)
+        *link = mj->next;
+
+    mj->next = NULL;
+    mj->ctx = NULL;
+}
+
+static void api_complete_job(myshell_job *mj)
+{
+    api_unlink_job(mj);
+
+    if (mj->callback)
+        mj->callback(mj, get_job_exit_code(mj->j), mj->data);
+}
+
+static void api_poll_job(myshell_job *mj)
+{
+    for (process *p = mj->j->first_process; p; p = p->next)
+        if (!is_process_completed(p))
+            api_reap_process(p, 0);
+}
+
+static int api_spawn_process(myshell_context *ctx, myshell_job *mj, process *p, int in_fd, int out_fd)
+{
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    sigset_t set;
+    int fds[3] = { in_fd, out_fd, mj->fds[2] };
+    int err;
+
+    posix_spawn_file_actions_init(&actions);
+    posix_spawnattr_init(&attr);
+
+    for (int i = 0; i < 3; i++)
+        if (fds[i] >= 0)
+            posix_spawn_file_actions_adddup2(&actions, fds[i], i);
+
+    sigemptyset(&set);
+    posix_spawnattr_setsigmask(&attr, &set);
+
+    for (size_t i = 0; i < sizeof(default_signals) / sizeof(default_signals[0]); i++)
+        sigaddset(&set, default_signals[i]);
+
+    posix_spawnattr_setsigdefault(&attr, &set);
+    posix_spawnattr_setpgroup(&attr, mj->j->pgid);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+    err = posix_spawnp(&p->pid, p->argv[0], &actions, &attr, p->argv, environ);
+
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+
+    if (err)
+    {
+        p->pid = -1;
+        p->exit_code = (err == ENOENT || err == EACCES || err == ENOEXEC) ? MYSHELL_EXIT_NOT_FOUND : EXIT_FAILURE;
+        set_process_status(p, STATUS_TERMINATED);
+        return err == ENOENT || err == EACCES || err == ENOEXEC ? 0 : err;
+    }
+
+    if (!mj->j->pgid)
+        mj->j->pgid = p->pid;
+
+    set_process_status(p, STATUS_RUNNING);
+
+    p->pidfd = syscall(SYS_pidfd_open, p->pid, 0);
+
+    if (p->pidfd >= 0)
+    {
+        struct epoll_event ev = {
+            .events = EPOLLIN,
+            .data.ptr = mj
+        };
+
+        if (epoll_ctl(ctx->epfd, EPOLL_CTL_ADD, p->pidfd, &ev) < 0)
+        {
+            close(p->pidfd);
+            p->pidfd = -1;
+        }
+    }
+
+    return 0;
+}
+
+myshell_context* myshell_context_new(void)
+{
+    myshell_context *ctx = malloc(sizeof(myshell_context));
+
+    if (!ctx)
+        return NULL;
+
+    if ((ctx->epfd = epoll_create1(EPOLL_CLOEXEC)) < 0)
+    {
+        free(ctx);
+        return NULL;
+    }
+
+    ctx->first = NULL;
+
+    return ctx;
+}
+
+void myshell_context_free(myshell_context *ctx)
+{
+    if (!ctx)
+        return;
+
+    while (ctx->first)
+    {
+        myshell_job *mj = ctx->first;
+
+        myshell_job_signal(mj, SIGKILL);
+
+        for (process *p = mj->j->first_process; p; p = p->next)
+            if (!is_process_completed(p))
+                api_reap_process(p, 1);
+
+        api_unlink_job(mj);
+    }
+
+    close(ctx->epfd);
+    free(ctx);
+}
+
+int myshell_context_fd(myshell_context *ctx)
+{
+    return ctx->epfd;
+}
+
+int myshell_context_dispatch(myshell_context *ctx, int timeout_ms)
+{
+    struct epoll_event events[32];
+    int completed = 0;
+    int ready;
+
+    if (!ctx->first)
+        return 0;
+
+    /* Un trabajo ya completado o con procesos sin pidfd no puede esperarse en epoll */
+    for (myshell_job *mj = ctx->first; mj && timeout_ms; mj = mj->next)
+    {
+        api_poll_job(mj);
+
+        for (process *p = mj->j->first_process; p; p = p->next)
+            if (!is_process_completed(p) && p->pidfd < 0)
+                timeout_ms = 0;
+
+        if (is_job_completed(mj->j))
+            timeout_ms = 0;
+    }
+
+    while ((ready = epoll_wait(ctx->epfd, events, 32, timeout_ms)) < 0 && errno == EINTR);
+
+    if (ready < 0)
+        return -1;
+
+    for (int i = 0; i < ready; i++)
+        api_poll_job(events[i].data.ptr);
+
+    myshell_job *mj = ctx->first;
+
+    while (mj)
+    {
+        myshell_job *next = mj->next;
+
+        if (!is_job_completed(mj->j))
+            api_poll_job(mj);
+
+        if (is_job_completed(mj->j))
+        {
+            api_complete_job(mj);
+            completed++;
+        }
+
+        mj = next;
+    }
+
+    return completed;
+}
+
+myshell_job* myshell_job_new(void)
+{
+    myshell_job *mj = calloc(1, sizeof(myshell_job));
+
+    if (!mj)
+        return NULL;
+
+    if (!(mj->j = new_job()))
+    {
+        free(mj);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    mj->fds[0] = mj->fds[1] = mj->fds[2] = -1;
+
+    return mj;
+}
+
+int myshell_job_add_process(myshell_job *mj, char *const argv[])
+{
+    int argc = 0;
+
+    if (!argv || !argv[0] || mj->j->start_time)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    while (argv[argc])
+        argc++;
+
+    char **copy = calloc(argc + 1, sizeof(char*));
+    process *p = NULL;
+    int i = 0;
+
+    while (copy && i < argc && (copy[i] = strdup(argv[i])))
+        i++;
+
+    if (!copy || i < argc || !(p = new_process_argv(copy, argc)))
+    {
+        if (copy)
+            free_array(copy, i);
+
+        errno = ENOMEM;
+        return -1;
+    }
+
+    insert_process(mj->j, p);
+
+    return 0;
+}
+
+void myshell_job_set_fds(myshell_job *mj, int in_fd, int out_fd, int err_fd)
+{
+    mj->fds[0] = in_fd;
+    mj->fds[1] = out_fd;
+    mj->fds[2] = err_fd;
+}
+
+void myshell_job_set_callback(myshell_job *mj, myshell_callback callback, void *data)
+{
+    mj->callback = callback;
+    mj->data = data;
+}
+
+int myshell_job_launch(myshell_context *ctx, myshell_job *mj)
+{
+    int in_fd = mj->fds[0];
+    int err = 0;
+    int pipe_fd[2];
+
+    if (!mj->j->first_process || mj->j->start_time)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    mj->j->start_time = get_monotonic_ns();
+    mj->j->mode = BACKGROUND_EXECUTION;
+    mj->ctx = ctx;
+    mj->next = ctx->first;
+    ctx->first = mj;
+
+    for (process *p = mj->j->first_process; p; p = p->next)
+    {
+        int out_fd = mj->fds[1];
+
+        pipe_fd[0] = -1;
+
+        if (p->next)
+        {
+            if (pipe2(pipe_fd, O_CLOEXEC) < 0)
+            {
+                err = errno;
+                break;
+            }
+
+            out_fd = pipe_fd[1];
+        }
+
+        err = api_spawn_process(ctx, mj, p, in_fd, out_fd);
+
+        if (p->next)
+            close(pipe_fd[1]);
+
+        if (in_fd != mj->fds[0])
+            close(in_fd);
+
+        in_fd = pipe_fd[0];
+
+        if (err)
+            break;
+    }
+
+    if (in_fd != mj->fds[0] && in_fd >= 0)
+        close(in_fd);
+
+    if (!err)
+        return 0;
+
+    /* Los procesos ya creados se terminan y el trabajo no se considera lanzado */
+    myshell_job_signal(mj, SIGKILL);
+
+    for (process *p = mj->j->first_process; p; p = p->next)
+    {
+        if (p->pid > 0 && !is_process_completed(p))
+            api_reap_process(p, 1);
+
+        set_process_status(p, STATUS_NEW);
+        p->pid = -1;
+        p->exit_code = 0;
+    }
+
+    api_unlink_job(mj);
+    mj->j->pgid = 0;
+    mj->j->start_time = 0;
+
+    errno = err;
+    return -1;
+}
+
+int myshell_job_wait(myshell_job *mj)
+{
+    for (process *p = mj->j->first_process; p; p = p->next)
+        if (!is_process_completed(p) && p->pid > 0)
+            api_reap_process(p, 1);
+
+    int code = get_job_exit_code(mj->j);
+
+    if (mj->ctx)
+        api_complete_job(mj);
+
+    return code;
+}
+
+int myshell_job_status(myshell_job *mj)
+{
+    if (!mj->j->start_time || !is_job_completed(mj->j))
+        return -1;
+
+    return get_job_exit_code(mj->j);
+}
+
+int myshell_job_signal(myshell_job *mj, int sig)
+{
+    if (mj->j->pgid <= 0 || !mj->ctx || is_job_completed(mj->j))
+    {
+        errno = ESRCH;
+        return -1;
+    }
+
+    return kill(-mj->j->pgid, sig);
+}
+
+void myshell_job_free(myshell_job *mj)
+{
+    if (!mj || mj->ctx)
+        return;
+
+    free_job(mj->j);
+    free(mj);
+}
@@ -11,17 +11,25 @@
 
 #include "../inc/Executors.h"
 
+int stdin_reserved = 0;
+
 void execute_cd(char* args)
 {
     if(*args == ASCII_MIDDLE_DASH)
-        args = getenv("OLDPWD");
+        args = (char*)env_get("OLDPWD");
     
     if (chdir(args) != 0)
         fprintf(stderr, KRED"\n%s\n\n"KDEF, strerror(errno));  
     else
     {
-        setenv("OLDPWD", getenv("PWD"), 1);
-        setenv("PWD", getcwd(NULL, 1024), 1);
+        char *cwd = getcwd(NULL, 0);
+        const char *pwd = env_get("PWD");
+
+        if (pwd)
+            env_export("OLDPWD", pwd);
+
+        env_export("PWD", cwd);
+        free(cwd);
         fprintf(stdout, "\n");
     }
 }
@@ -73,7 +81,7 @@ void execute_echo(char* args)
         
         while (sub_word != NULL)
         {
-            char* envvar = getenv(sub_word);
+            const char* envvar = env_get(sub_word);
 
             if(envvar)
             {
@@ -101,10 +109,49 @@ void execute_echo(char* args)
 
 void execute_jobs(char* args)
 {
-    if (!(strlen(args) > 0))
-        print_job_all_status();
-    else
-        fprintf(stderr, KRED"\nThe command does not allow parameters !\n\n"KDEF);
+    jobs_query q = { PROC_FILTER_ALL, 0, 0, 0 };
+    char *rest = NULL;
+    char *word = strtok_r(args, " ", &rest);
+    char *end = "";
+
+    for (; word && !*end; word = strtok_r(NULL, " ", &rest))
+    {
+        if (!strcmp(word, "--json"))
+            q.json = 1;
+        else if (!strcmp(word, "--since"))
+        {
+            word = strtok_r(NULL, " ", &rest);
+            q.since = word ? strtoull(word, &end, 10) : 0;
+            end = word && isdigit((unsigned char)*word) ? end : "?";
+        }
+        else if (*word == ASCII_MIDDLE_DASH && word[1] && word[1] != ASCII_MIDDLE_DASH)
+        {
+            /* -r y -s se excluyen entre si; -p se combina con cualquiera, tambien agrupado (-rp) */
+            for (end = word + 1; *end; end++)
+            {
+                PROCESS_FILTERS filter = *end == 'r' ? PROC_FILTER_RUNNING : PROC_FILTER_STOPPED;
+
+                if (*end == 'p')
+                    q.pids_only = 1;
+                else if ((*end != 'r' && *end != 's') || (q.filter != PROC_FILTER_ALL && q.filter != filter))
+                    break;
+                else
+                    q.filter = filter;
+            }
+        }
+        else
+            end = "?";
+    }
+
+    if (*end)
+    {
+        fprintf(stderr, KRED"\nUsage: jobs [--json] [-r | -s] [-p] [--since NS] !\n\n"KDEF);
+        last_exit_status = 2;
+        return;
+    }
+
+    print_jobs(&q);
+    last_exit_status = EXIT_SUCCESS;
 }
 
 void execute_kill(char* args)
@@ -123,6 +170,204 @@ void execute_fg(char* args)
         fprintf(stderr, KRED"\nReanude individual process is not supported !\n\n"KDEF);
 }
 
+void execute_bg(char* args)
+{
+    if(*args == ASCII_PERCENT)
+        reanude_job_bg(atoi(++args));
+    else
+        fprintf(stderr, KRED"\nReanude individual process is not supported !\n\n"KDEF);
+}
+
+void execute_wait(char* args)
+{
+    int any = 0;
+    int n = 0;
+    int *ids = NULL;
+    char *end_arg;
+    char *arg = strtok_r(args, " ", &end_arg);
+
+    while (arg)
+    {
+        if (!strcmp(arg, "-n"))
+            any = 1;
+        else if (*arg == ASCII_PERCENT)
+        {
+            ids = realloc(ids, sizeof(int) * (n + 1));
+            ids[n++] = atoi(arg + 1);
+        }
+        else
+        {
+            fprintf(stderr, KRED"\nUsage: wait [-n] [%%N ...] !\n\n"KDEF);
+            free(ids);
+            return;
+        }
+
+        arg = strtok_r(NULL, " ", &end_arg);
+    }
+
+    wait_jobs(ids, n, any);
+
+    free(ids);
+}
+
+static void read_parallel_args(FILE *fp, char ***items, int *n)
+{
+    char *line = NULL;
+    size_t cap = 0;
+    ssize_t len;
+
+    while ((len = getline(&line, &cap, fp)) >= 0)
+    {
+        while (len > 0 && (line[len - 1] == ASCII_LINE_BREAK || line[len - 1] == ASCII_SPACE))
+            line[--len] = ASCII_END_OF_STRING;
+
+        if (len == 0)
+            continue;
+
+        *items = realloc(*items, sizeof(char*) * (*n + 1));
+        (*items)[(*n)++] = strdup(line);
+    }
+
+    free(line);
+}
+
+/* Leer la entrada estandar cuando la shell toma de ella su script consumiria el resto del script como argumentos */
+static int read_parallel_stdin(char ***items, int *n)
+{
+    if (stdin_reserved && !isatty(STDIN_FILENO))
+    {
+        fprintf(stderr, KRED"\nparallel: standard input holds the script, use ::: or :::: file !\n\n"KDEF);
+        return -1;
+    }
+
+    read_parallel_args(stdin, items, n);
+    clearerr(stdin);
+
+    return 0;
+}
+
+void execute_parallel(char* args)
+{
+    parallel_options opt = {
+        .max_jobs = sysconf(_SC_NPROCESSORS_ONLN),
+        .tag = 0,
+        .keep_order = 0
+    };
+    char *template = calloc(strlen(args) + 1, sizeof(char));
+    char **items = NULL;
+    int n = 0;
+    int source = 0;
+    char *end_arg;
+    char *arg = strtok_r(args, " ", &end_arg);
+
+    while (arg)
+    {
+        if (!strcmp(arg, ":::"))
+            source = 1;
+        else if (!strcmp(arg, "::::"))
+            source = 2;
+        else if (source == 1)
+        {
+            items = realloc(items, sizeof(char*) * (n + 1));
+            items[n++] = strdup(arg);
+        }
+        else if (source == 2 && !strcmp(arg, "-"))
+        {
+            if (read_parallel_stdin(&items, &n) < 0)
+            {
+                free_array(items, n);
+                free(template);
+                return;
+            }
+        }
+        else if (source == 2)
+        {
+            FILE *fp = fopen(arg, "r");
+
+            if (!fp)
+            {
+                fprintf(stderr, KRED"\n%s: %s !\n\n"KDEF, arg, strerror(errno));
+                free_array(items, n);
+                free(template);
+                return;
+            }
+
+            read_parallel_args(fp, &items, &n);
+            fclose(fp);
+        }
+        else if (!*template && (!strcmp(arg, "-j") || !strcmp(arg, "--jobs")))
+        {
+            arg = strtok_r(NULL, " ", &end_arg);
+            opt.max_jobs = arg ? atoi(arg) : 0;
+        }
+        else if (!*template && !strncmp(arg, "-j", 2))
+            opt.max_jobs = atoi(arg + 2);
+        else if (!*template && !strcmp(arg, "--tag"))
+            opt.tag = 1;
+        else if (!*template && (!strcmp(arg, "--keep-order") || !strcmp(arg, "-k")))
+            opt.keep_order = 1;
+        else
+        {
+            if (*template)
+                strcat(template, " ");
+
+            strcat(template, arg);
+        }
+
+        arg = strtok_r(NULL, " ", &end_arg);
+    }
+
+    if (!*template || opt.max_jobs < 1)
+    {
+        fprintf(stderr, KRED"\nUsage: parallel [-j N] [--tag] [--keep-order] cmd {} [::: args... | :::: files...] !\n\n"KDEF);
+        free_array(items, n);
+        free(template);
+        return;
+    }
+
+    if (!source && read_parallel_stdin(&items, &n) < 0)
+    {
+        free(template);
+        return;
+    }
+
+    fprintf(stdout, "\n");
+
+    run_parallel(template, items, n, &opt, build_job);
+
+    fprintf(stdout, "\n");
+
+    free_array(items, n);
+    free(template);
+}
+
+void execute_stats(char* args)
+{
+    if (!(strlen(args) > 0))
+        metrics_print_text(stdout);
+    else if (!strcmp(args, "--json"))
+        metrics_print_json(stdout);
+    else if (!strcmp(args, "--reset"))
+        metrics_reset();
+    else
+        fprintf(stderr, KRED"\nUsage: stats [--json | --reset] !\n\n"KDEF);
+}
+
+void execute_zygote(char* args)
+{
+    if (!(strlen(args) > 0))
+        fprintf(stdout, "\nzygote: %s\n\n", zygote_enabled() ? "on" : "off");
+    else if (!strcmp(args, "on"))
+    {
+        if (zygote_start() < 0)
+            fprintf(stderr, KRED"\nzygote: %s !\n\n"KDEF, strerror(errno));
+    }
+    else if (!strcmp(args, "off"))
+        zygote_stop();
+    else
+        fprintf(stderr, KRED"\nUsage: zygote [on | off] !\n\n"KDEF);
+}
+
 void execute_clr(char* args)
 {
     if (!(strlen(args) > 0))
@@ -135,6 +380,7 @@ void execute_quit(char* args)
 {
     if (!(strlen(args) > 0))
     {
+        coproc_free_all();
         kill_all_jobs();  
         exit(EXIT_SUCCESS);
     }
@@ -142,11 +388,10 @@ void execute_quit(char* args)
     fprintf(stderr, KRED"\nThe command does not allow parameters !\n\n"KDEF);
 }
 
-void execute_extern(char* args)
+static void launch_extern(char* args, int priority, int* after, int n_after)
 {
+    uint64_t t_parse = trace_begin();
     job *j;
-    char *end_cmm;
-    char *cmm;
     EXECUTION_MODES mode = get_execution_mode(args);
 
     if(mode == BADMODE_EXECUTION)
@@ -162,11 +407,354 @@ void execute_extern(char* args)
         args = trim_white_space(args);
     }
 
-    j = new_job();
+    j = build_job(args);
+
+    trace_end("execute_extern", t_parse);
+
+    j->priority = priority;
+    j->after = after;
+    j->n_after = n_after;
+
+    if(j->first_process)
+        launch_job(j, mode);
+    else
+        free_job(j);
+}
+
+void execute_extern(char* args)
+{
+    launch_extern(args, 0, NULL, 0);
+}
+
+void execute_after(char* args)
+{
+    int n = 0, named = 0;
+    int *ids = NULL;
+    char *command = args;
+
+    while ((command = trim_white_space(command)) && *command == ASCII_PERCENT)
+    {
+        char *end;
+        int id = strtol(command + 1, &end, 10), exit_code = 0;
+        job *j = get_job_by_id(id);
+
+        /* Un trabajo ya finalizado se resuelve con el codigo que guardo la lista de finalizados */
+        if ((*end && *end != ASCII_SPACE) || (j ? j->managed : !get_finished_job(id, &exit_code)))
+        {
+            fprintf(stderr, KRED"\nJob %.*s not found!\n\n"KDEF, (int)strcspn(command + 1, " "), command + 1);
+            free(ids);
+            return;
+        }
+
+        if (exit_code)
+        {
+            fprintf(stderr, KRED"\nafter: job %d failed, command not launched!\n\n"KDEF, id);
+            last_exit_status = EXIT_FAILURE;
+            free(ids);
+            return;
+        }
+
+        if (j)
+        {
+            ids = realloc(ids, sizeof(int) * (n + 1));
+            ids[n++] = j->id;
+        }
+
+        named++;
+        command = end;
+    }
+
+    if (!named || !command)
+        fprintf(stderr, KRED"\nUsage: after %%N [%%N ...] command & !\n\n"KDEF);
+    else if (get_execution_mode(command) != BACKGROUND_EXECUTION)
+        fprintf(stderr, KRED"\nafter: the command must run in background (&) !\n\n"KDEF);
+    else
+    {
+        launch_extern(command, 0, ids, n);
+        return;
+    }
+
+    free(ids);
+}
+
+int substitute_command(char* command, job_buffer* out)
+{
+    char *end_str;
+    char *word;
+
+    if (strncmp(command, "echo", 4) || (command[4] && command[4] != ASCII_SPACE) || strpbrk(command, "<>|&"))
+    {
+        /* Solo se captura la salida estandar: los errores del comando siguen llegando a la terminal */
+        job_buffer err = {0};
+        int status = capture_job_output(command, build_job, out, &err);
+
+        fwrite(err.data, 1, err.len, stderr);
+        free(err.data);
+
+        return status;
+    }
+
+    /* El echo interno se resuelve sin crear procesos, con la misma expansion de variables */
+    word = strtok_r(command + 4, " ", &end_str);
+
+    while (word != NULL)
+    {
+        char *end_word;
+        char *sub_word = strtok_r(word, "$", &end_word);
+
+        if(*word != ASCII_MONEY_SIGN)
+        {
+            append_job_buffer(out, sub_word, strlen(sub_word));
+            sub_word = strtok_r(NULL, "$", &end_word);
+        }
+
+        while (sub_word != NULL)
+        {
+            const char* envvar = env_get(sub_word);
+
+            if(envvar)
+                append_job_buffer(out, envvar, strlen(envvar));
+
+            sub_word = strtok_r(NULL, "$", &end_word);
+        }
+
+        append_job_buffer(out, " ", 1);
+
+        word = strtok_r(NULL, " ", &end_str);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+void execute_sched(char* args)
+{
+    char *end_arg;
+    char *arg = strtok_r(args, " ", &end_arg);
+
+    if (!arg)
+    {
+        fprintf(stdout, "\nsched: max %d%s, %s, %d running, %d queued\n\n",
+                scheduler.max_running, scheduler.max_running > 0 ? "" : " (unlimited)",
+                scheduler.policy == QUEUE_PRIORITY ? "priority" : "fifo",
+                count_running_jobs(), count_queued_jobs());
+        return;
+    }
+
+    if (!strcmp(arg, "-p"))
+    {
+        char *priority = strtok_r(NULL, " ", &end_arg);
+        char *command = end_arg ? trim_white_space(end_arg) : NULL;
+
+        if (!priority || !command)
+            fprintf(stderr, KRED"\nUsage: sched -p N command !\n\n"KDEF);
+        else if (get_execution_mode(command) != BACKGROUND_EXECUTION)
+            fprintf(stderr, KRED"\nsched: only background jobs (&) are queued !\n\n"KDEF);
+        else
+            launch_extern(command, atoi(priority), NULL, 0);
+
+        return;
+    }
+
+    while (arg)
+    {
+        if (!strcmp(arg, "-n"))
+        {
+            char *max = strtok_r(NULL, " ", &end_arg);
+
+            if (!max)
+            {
+                fprintf(stderr, KRED"\nUsage: sched [-n N] [fifo | priority] !\n\n"KDEF);
+                return;
+            }
+
+            scheduler.max_running = atoi(max) > 0 ? atoi(max) : 0;
+        }
+        else if (!strcmp(arg, "fifo"))
+            scheduler.policy = QUEUE_FIFO;
+        else if (!strcmp(arg, "priority"))
+            scheduler.policy = QUEUE_PRIORITY;
+        else
+        {
+            fprintf(stderr, KRED"\nUsage: sched [-n N] [fifo | priority] !\n\n"KDEF);
+            return;
+        }
+
+        arg = strtok_r(NULL, " ", &end_arg);
+    }
+
+    schedule_jobs();
+}
+
+/* Busca el siguiente operador '|+' fuera de parentesis */
+static char* find_fanout(char* args)
+{
+    for (args = find_chars(args, "(|"); *args; args = find_chars(args + 1, "(|"))
+    {
+        char *end;
+
+        if (*args == ASCII_OPEN_PAREN && (end = get_matching_paren(args)))
+            args = end;
+        else if (*args == ASCII_PLECA && args[1] == ASCII_PLUS)
+            return args;
+    }
+
+    return NULL;
+}
+
+static char* cut_fanout(char* args)
+{
+    job_buffer result = {0};
+    char *sep = find_fanout(args);
+    char *last = sep;
+    int consumers = 0;
+
+    /* productor |+ c1 |+ c2 |+ resto  =>  productor | [fanout] >(c1) >(c2) | resto */
+    append_job_buffer(&result, args, sep - args);
+
+    while ((sep = find_fanout(last + 2)))
+    {
+        if (!consumers++)
+            append_job_buffer(&result, " | "FANOUT_COMMAND, strlen(" | "FANOUT_COMMAND));
+
+        append_job_buffer(&result, " >(", 3);
+        append_job_buffer(&result, last + 2, sep - last - 2);
+        append_job_buffer(&result, ")", 1);
+        last = sep;
+    }
+
+    if (!trim_white_space(last + 2))
+    {
+        fprintf(stderr, KRED"\nBad used of '|+' in command !\n\n"KDEF);
+        free(result.data);
+        return NULL;
+    }
+
+    append_job_buffer(&result, " | ", 3);
+    append_job_buffer(&result, last + 2, strlen(last + 2) + 1);
+
+    return result.data;
+}
+
+static char* cut_process_substitutions(char* args, job* j)
+{
+    job_buffer result = {0};
+    char path[32];
+    char *start;
+
+    while ((start = strpbrk(args, "<>")))
+    {
+        append_job_buffer(&result, args, start - args + 1);
+        args = start + 1;
+
+        if (*args != ASCII_OPEN_PAREN)
+            continue;
+
+        char *end = get_matching_paren(args);
+        int fds[2];
+
+        if (!end)
+        {
+            fprintf(stderr, KRED"\nUnterminated process substitution !\n\n"KDEF);
+            free(result.data);
+            return NULL;
+        }
+
+        *end = ASCII_END_OF_STRING;
+
+        job *s = build_job(args + 1);
+
+        if (!s->first_process || pipe2(fds, O_CLOEXEC) < 0)
+        {
+            if (s->first_process)
+                fprintf(stderr, KRED"\nProcess substitution: %s !\n\n"KDEF, strerror(errno));
+            else
+                fprintf(stderr, KRED"\nEmpty process substitution !\n\n"KDEF);
+
+            free_job(s);
+            free(result.data);
+            return NULL;
+        }
+
+        if (*start == ASCII_LESS_THAN)
+        {
+            s->stdout_fd = fds[1];
+            s->subst_fd = fds[0];
+        }
+        else
+        {
+            s->stdin_fd = fds[0];
+            s->subst_fd = fds[1];
+        }
+
+        s->next = j->substs;
+        j->substs = s;
+
+        /* El operador se reemplaza por el path del extremo que hereda el trabajo */
+        result.len--;
+        snprintf(path, sizeof(path), "/dev/fd/%d", s->subst_fd);
+        append_job_buffer(&result, path, strlen(path));
+
+        args = end + 1;
+    }
+
+    append_job_buffer(&result, args, strlen(args) + 1);
+
+    return result.data;
+}
+
+/* Separa las asignaciones 'NAME=valor' previas al comando, que forman el entorno propio del proceso */
+static void cut_assignments(process *p)
+{
+    int n = 0;
+
+    while (n < p->argc - 1 && env_assignment(p->argv[n]))
+        n++;
+
+    if (!n)
+        return;
+
+    p->env = malloc(sizeof(char*) * (n + 1));
+    memcpy(p->env, p->argv, sizeof(char*) * n);
+    p->env[n] = NULL;
+    p->envc = n;
+
+    memmove(p->argv, p->argv + n, sizeof(char*) * (p->argc - n + 1));
+    p->argc -= n;
+}
+
+job* build_job(char* args)
+{
+    job *j = new_job();
+    char *expanded = NULL;
+    char *fanout = NULL;
+    char *end_cmm;
+    char *cmm;
+
+    if (find_fanout(args))
+    {
+        if (!(fanout = cut_fanout(args)))
+            return j;
+
+        args = fanout;
+    }
+
+    if (strstr(args, "<(") || strstr(args, ">("))
+    {
+        if (!(expanded = cut_process_substitutions(args, j)))
+        {
+            free(fanout);
+            return j;
+        }
+
+        args = expanded;
+    }
+
+    cmm = strtok_r(args, "|", &end_cmm);
 
-    cmm = strtok_r(args, "|", &end_cmm);   
     while (cmm)
     {   
+        int merge_error;
+        char *errfile = cut_error_redirection(cmm, &merge_error);
         char *infile = get_word_after_char(cmm, ASCII_LESS_THAN);
         char *outfile = get_word_after_char(cmm, ASCII_GREATER_THAN);
 
@@ -174,6 +762,11 @@ void execute_extern(char* args)
 
         process *p = new_process(operation, infile, outfile);
 
+        cut_assignments(p);
+
+        p->error_path = errfile;
+        p->merge_error = merge_error;
+
         insert_process(j, p);
         
         cmm = strtok_r(NULL, "|", &end_cmm);
@@ -181,27 +774,478 @@ void execute_extern(char* args)
         free(operation);
     }
 
-    if(j->first_process)
-        launch_job(j, mode);
+    free(expanded);
+    free(fanout);
+
+    return j;
 }
 
 EXECUTION_MODES get_execution_mode(char* args)
 {
-    if(args[strlen(args) - 1] == ASCII_AMPERSAND)
+    size_t len = strlen(args);
+
+    if(args[len - 1] == ASCII_AMPERSAND)
         return BACKGROUND_EXECUTION;
 
-    int match = 0;
-    for (size_t i = 0; i < strlen(args); i++)
+    /* Un '|' luego de un '&', separado solo por espacios, es un uso incorrecto */
+    for (char *amp = find_chars(args, "&"); *amp; amp = find_chars(amp + 1, "&"))
     {
-        if(match && args[i] == ASCII_PLECA)
-            return BADMODE_EXECUTION;
+        char *next = amp + 1;
 
-        if(match && args[i] != ASCII_SPACE)
-            match = 0;
+        while (*next == ASCII_SPACE)
+            next++;
 
-        if (args[i] == ASCII_AMPERSAND)
-            match = 1;
+        if (*next == ASCII_PLECA)
+            return BADMODE_EXECUTION;
     }
 
     return FOREGROUND_EXECUTION;
-}
\ No newline at end of file
+}
+
+static char* coproc_name_option(char **args)
+{
+    char *name = NULL;
+
+    *args = trim_white_space(*args);
+
+    if (*args && !strncmp(*args, "-u ", 3))
+    {
+        char *end_arg;
+
+        name = strtok_r(*args + 3, " ", &end_arg);
+        *args = end_arg ? trim_white_space(end_arg) : NULL;
+    }
+
+    return name;
+}
+
+void execute_coproc(char* args)
+{
+    char *name;
+
+    if (!args || !(args = trim_white_space(args)))
+    {
+        print_coprocs();
+        return;
+    }
+
+    if (!strcmp(args, "-c") || !strncmp(args, "-c ", 3))
+    {
+        coproc *c = coproc_find(args[2] ? trim_white_space(args + 3) : NULL);
+
+        if (!c)
+            fprintf(stderr, KRED"\nCoproc not found !\n\n"KDEF);
+        else
+            coproc_close_input(c);
+
+        return;
+    }
+
+    name = coproc_name_option(&args);
+
+    if (!args || !*args)
+    {
+        fprintf(stderr, KRED"\nUsage: coproc [-u NAME] command !\n\n"KDEF);
+        return;
+    }
+
+    if (get_execution_mode(args) == BACKGROUND_EXECUTION)
+        args[strlen(args) - 1] = ASCII_SPACE;
+
+    if (get_execution_mode(args) == BADMODE_EXECUTION)
+    {
+        fprintf(stderr, KRED"\nBad used of '&' and '|' in command !\n\n"KDEF);
+        return;
+    }
+
+    coproc_start(name, trim_white_space(args), build_job);
+}
+
+void execute_write(char* args)
+{
+    char *name = coproc_name_option(&args);
+    coproc *c = coproc_find(name);
+
+    if (!c)
+    {
+        fprintf(stderr, KRED"\nCoproc %s not found !\n\n"KDEF, name ? name : COPROC_DEFAULT_NAME);
+        return;
+    }
+
+    /* Sin texto se envia una linea vacia */
+    if (!args)
+        args = "";
+
+    size_t len = strlen(args);
+    char *line = malloc(len + 1);
+
+    memcpy(line, args, len);
+    line[len] = ASCII_LINE_BREAK;
+
+    if (coproc_write(c, line, len + 1) < 0)
+    {
+        fprintf(stderr, KRED"\nwrite: %s !\n\n"KDEF, strerror(errno));
+        last_exit_status = EXIT_FAILURE;
+    }
+    else
+        last_exit_status = EXIT_SUCCESS;
+
+    free(line);
+}
+
+void execute_read(char* args)
+{
+    char *name = coproc_name_option(&args);
+    int timeout_ms = -1;
+    job_buffer line = {0};
+
+    if (args && !strncmp(args, "-t ", 3))
+        timeout_ms = strtod(args + 3, NULL) * 1000;
+    else if (args && *args)
+    {
+        fprintf(stderr, KRED"\nUsage: read [-u NAME] [-t seconds] !\n\n"KDEF);
+        return;
+    }
+
+    coproc *c = coproc_find(name);
+
+    if (!c)
+    {
+        fprintf(stderr, KRED"\nCoproc %s not found !\n\n"KDEF, name ? name : COPROC_DEFAULT_NAME);
+        return;
+    }
+
+    int result = coproc_read_line(c, &line, timeout_ms);
+
+    if (result > 0)
+        fprintf(stdout, "%.*s\n", (int)line.len, line.data);
+    else if (result == 0)
+        coproc_free(c);
+
+    last_exit_status = result > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    free(line.data);
+}
+
+/* Remueve un par de comillas que encierre todo el operando */
+static char* test_operand(char* s)
+{
+    size_t len = strlen(s);
+
+    if (len >= 2 && (*s == '"' || *s == '\'') && s[len - 1] == *s)
+    {
+        s[len - 1] = ASCII_END_OF_STRING;
+        return s + 1;
+    }
+
+    return s;
+}
+
+static int test_integer(const char* s, long* value)
+{
+    char* end;
+
+    *value = strtol(s, &end, 10);
+
+    if (end == s || *end)
+    {
+        fprintf(stderr, KRED"\ntest: %s: integer expression expected !\n\n"KDEF, s);
+        return 0;
+    }
+
+    return 1;
+}
+
+static int test_unary(const char* op, const char* arg)
+{
+    struct stat st;
+
+    if (!strcmp(op, "-n"))
+        return !*arg;
+
+    if (!strcmp(op, "-z"))
+        return *arg != ASCII_END_OF_STRING;
+
+    if (!strcmp(op, "-r"))
+        return access(arg, R_OK) != 0;
+
+    if (!strcmp(op, "-w"))
+        return access(arg, W_OK) != 0;
+
+    if (!strcmp(op, "-x"))
+        return access(arg, X_OK) != 0;
+
+    if (strlen(op) != 2 || *op != ASCII_MIDDLE_DASH || !strchr("efdsL", op[1]))
+    {
+        fprintf(stderr, KRED"\ntest: %s: unary operator expected !\n\n"KDEF, op);
+        return 2;
+    }
+
+    if ((op[1] == 'L' ? lstat(arg, &st) : stat(arg, &st)) < 0)
+        return 1;
+
+    switch (op[1])
+    {
+        case 'f': return !S_ISREG(st.st_mode);
+        case 'd': return !S_ISDIR(st.st_mode);
+        case 's': return st.st_size == 0;
+        case 'L': return !S_ISLNK(st.st_mode);
+        default:  return 0;
+    }
+}
+
+static int test_binary(const char* left, const char* op, const char* right)
+{
+    static const char* INTEGER_OPS[] = { "-eq", "-ne", "-lt", "-le", "-gt", "-ge" };
+    long a, b;
+
+    if (!strcmp(op, "=") || !strcmp(op, "=="))
+        return strcmp(left, right) != 0;
+
+    if (!strcmp(op, "!="))
+        return !strcmp(left, right);
+
+    for (int i = 0; i < 6; i++)
+    {
+        if (strcmp(op, INTEGER_OPS[i]))
+            continue;
+
+        if (!test_integer(left, &a) || !test_integer(right, &b))
+            return 2;
+
+        switch (i)
+        {
+            case 0: return !(a == b);
+            case 1: return !(a != b);
+            case 2: return !(a < b);
+            case 3: return !(a <= b);
+            case 4: return !(a > b);
+            default: return !(a >= b);
+        }
+    }
+
+    fprintf(stderr, KRED"\ntest: %s: binary operator expected !\n\n"KDEF, op);
+    return 2;
+}
+
+static int test_expression(int argc, char** argv)
+{
+    /* -o tiene menor precedencia que -a, y ambos menor que ! */
+    static const char* CONNECTORS[] = { "-o", "-a" };
+
+    for (int k = 0; k < 2; k++)
+    {
+        for (int i = 1; i < argc - 1; i++)
+        {
+            if (strcmp(argv[i], CONNECTORS[k]))
+                continue;
+
+            int left = test_expression(i, argv);
+            int right = test_expression(argc - i - 1, argv + i + 1);
+
+            if (left == 2 || right == 2)
+                return 2;
+
+            return k == 0 ? left && right : left || right;
+        }
+    }
+
+    if (argc > 0 && !strcmp(argv[0], "!"))
+    {
+        int result = test_expression(argc - 1, argv + 1);
+
+        return result == 2 ? 2 : !result;
+    }
+
+    switch (argc)
+    {
+        case 0:
+            return 1;
+
+        case 1:
+            return !*argv[0];
+
+        case 2:
+            return test_unary(argv[0], argv[1]);
+
+        case 3:
+            return test_binary(argv[0], argv[1], argv[2]);
+    }
+
+    fprintf(stderr, KRED"\ntest: too many arguments !\n\n"KDEF);
+    return 2;
+}
+
+static void run_test(char* args, int bracket)
+{
+    char* args_cpy = strdup(args ? args : "");
+    int argc;
+    char** argv = str_to_array(args_cpy, &argc);
+    int n = argc;
+
+    if (bracket && (argc == 0 || strcmp(argv[--n], "]")))
+    {
+        fprintf(stderr, KRED"\n[: missing ']' !\n\n"KDEF);
+        last_exit_status = 2;
+    }
+    else
+    {
+        char** operands = malloc(sizeof(char*) * (n + 1));
+
+        for (int i = 0; i < n; i++)
+            operands[i] = test_operand(argv[i]);
+
+        last_exit_status = test_expression(n, operands);
+
+        free(operands);
+    }
+
+    free_array(argv, argc);
+    free(args_cpy);
+}
+
+void execute_test(char* args)
+{
+    run_test(args, 0);
+}
+
+void execute_bracket(char* args)
+{
+    run_test(args, 1);
+}
+
+void execute_true(char* args)
+{
+    last_exit_status = EXIT_SUCCESS;
+}
+
+void execute_false(char* args)
+{
+    last_exit_status = EXIT_FAILURE;
+}
+
+/* Corta la siguiente palabra de la lista, respetando y removiendo las comillas */
+static char* next_word(char **args)
+{
+    char *s = *args;
+    char *word, *out;
+    char quote = 0;
+
+    while (*s == ASCII_SPACE)
+        s++;
+
+    if (!*s)
+        return NULL;
+
+    for (word = out = s; *s && (quote || *s != ASCII_SPACE); s++)
+    {
+        if (!quote && (*s == '"' || *s == '\''))
+            quote = *s;
+        else if (*s == quote)
+            quote = 0;
+        else
+            *out++ = *s;
+    }
+
+    *args = *s ? s + 1 : s;
+    *out = ASCII_END_OF_STRING;
+
+    return word;
+}
+
+void execute_export(char* args)
+{
+    char *word;
+
+    last_exit_status = EXIT_SUCCESS;
+
+    if (!args || !trim_white_space(args))
+    {
+        env_print(stdout);
+        return;
+    }
+
+    while ((word = next_word(&args)))
+    {
+        char *equal = strchr(word, '=');
+
+        if (equal)
+            *equal = ASCII_END_OF_STRING;
+
+        if (env_export(word, equal ? equal + 1 : NULL) < 0)
+        {
+            fprintf(stderr, KRED"\nexport: '%s' is not a valid identifier !\n\n"KDEF, word);
+            last_exit_status = EXIT_FAILURE;
+        }
+    }
+}
+
+void execute_cache(char* args)
+{
+    cache_options opt = { NULL, 0, NULL, 0, 0 };
+    char *command = args;
+    int status;
+
+    while ((command = trim_white_space(command)) && *command == ASCII_MIDDLE_DASH)
+    {
+        char *rest = NULL;
+        char *word = strtok_r(command, " ", &rest);
+
+        if (!strcmp(word, "--"))
+        {
+            command = rest;
+            break;
+        }
+        else if (!strcmp(word, "-m"))
+            opt.use_mtime = 1;
+        else if (!strcmp(word, "-d") && (word = strtok_r(NULL, " ", &rest)))
+        {
+            opt.deps = realloc(opt.deps, sizeof(char*) * (opt.n_deps + 1));
+            opt.deps[opt.n_deps++] = word;
+        }
+        else if (!strcmp(word, "-e") && (word = strtok_r(NULL, " ", &rest)))
+        {
+            opt.vars = realloc(opt.vars, sizeof(char*) * (opt.n_vars + 1));
+            opt.vars[opt.n_vars++] = word;
+        }
+        else
+        {
+            command = NULL;
+            break;
+        }
+
+        command = rest;
+    }
+
+    if (!command || !(command = trim_white_space(command)))
+    {
+        fprintf(stderr, KRED"\nUsage: cache [-d file]... [-e NAME]... [-m] [--] command !\n\n"KDEF);
+        last_exit_status = 2;
+    }
+    else if ((status = run_cached(command, &opt, build_job)) < 0)
+        launch_extern(command, 0, NULL, 0);
+    else
+        last_exit_status = status;
+
+    free(opt.deps);
+    free(opt.vars);
+}
+
+void execute_unset(char* args)
+{
+    char *word;
+
+    last_exit_status = EXIT_SUCCESS;
+
+    while ((word = next_word(&args)))
+    {
+        if (!strcmp(word, "-v"))
+            continue;
+
+        if (env_unset(word) < 0)
+        {
+            fprintf(stderr, KRED"\nunset: '%s' is not a valid identifier !\n\n"KDEF, word);
+            last_exit_status = EXIT_FAILURE;
+        }
+    }
+}
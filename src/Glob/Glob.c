@@ -0,0 +1,501 @@
+/**
+ * @file Glob.c
+ * @author Bottini, Franco Nicolas.
+ * @brief Implementacion de la expansion de nombres de archivo.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../../inc/Glob/Glob.h"
+
+/* Por debajo de este tamaño el ordenamiento usa insercion */
+#define GLOB_INSERTION_SORT 16
+
+/** Buffer de caracteres que crece segun se necesite **/
+typedef struct glob_buffer
+{
+    char *data;
+    size_t len;
+    size_t cap;
+} glob_buffer;
+
+/** Estado de la expansion de un patron **/
+typedef struct glob_walk
+{
+    glob_cache *cache;      /** Cache de directorios de la linea **/
+    char **components;      /** Componentes del patron separados por '/' **/
+    int n_components;       /** Numero de componentes **/
+    int dir_only;           /** 1 si el patron termina en '/' **/
+    glob_buffer path;       /** Ruta del directorio que se esta recorriendo **/
+    glob_buffer names;      /** Rutas encontradas, terminadas en '\0' y contiguas **/
+    size_t *offsets;        /** Posicion de cada ruta en names **/
+    size_t count;           /** Numero de rutas encontradas **/
+    size_t offsets_cap;     /** Capacidad de offsets **/
+} glob_walk;
+
+static void glob_append(glob_buffer *b, const char *data, size_t len)
+{
+    if (b->len + len + 1 > b->cap)
+    {
+        size_t cap = b->cap ? b->cap : 256;
+
+        while (cap < b->len + len + 1)
+            cap *= 2;
+
+        b->data = realloc(b->data, cap);
+        b->cap = cap;
+    }
+
+    memcpy(b->data + b->len, data, len);
+    b->len += len;
+    b->data[b->len] = ASCII_END_OF_STRING;
+}
+
+static void* grow_array(void *array, size_t *cap, size_t count, size_t size)
+{
+    if (count < *cap)
+        return array;
+
+    *cap = *cap ? *cap * 2 : 64;
+
+    return realloc(array, *cap * size);
+}
+
+int has_glob_chars(const char *word)
+{
+    for (const char *s = word; *s; s++)
+    {
+        if (*s == '*' || *s == '?')
+            return 1;
+
+        if (*s == '[' && s[1] && strchr(s + 2, ']'))
+            return 1;
+    }
+
+    return 0;
+}
+
+static glob_dir* read_dir(const char *path)
+{
+    static char *dents = NULL;
+    glob_dir *d = calloc(1, sizeof(glob_dir));
+    size_t names_len = 0, names_cap = 0, cap = 0;
+    long n;
+    int fd;
+
+    d->path = strdup(path);
+
+    if ((fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) < 0)
+    {
+        d->error = 1;
+        return d;
+    }
+
+    if (!dents)
+        dents = malloc(GLOB_DENTS_BUFFER);
+
+    while ((n = syscall(SYS_getdents64, fd, dents, GLOB_DENTS_BUFFER)) > 0)
+    {
+        for (long off = 0; off < n; )
+        {
+            struct dirent64 *entry = (struct dirent64*)(dents + off);
+            const char *name = entry->d_name;
+            size_t len = strlen(name);
+
+            off += entry->d_reclen;
+
+            if (name[0] == '.' && (!name[1] || (name[1] == '.' && !name[2])))
+                continue;
+
+            if (d->count == cap)
+            {
+                cap = cap ? cap * 2 : 64;
+                d->offsets = realloc(d->offsets, cap * sizeof(size_t));
+                d->types = realloc(d->types, cap);
+            }
+
+            if (names_len + len + 1 > names_cap)
+            {
+                names_cap = names_cap ? names_cap * 2 : 4096;
+
+                while (names_len + len + 1 > names_cap)
+                    names_cap *= 2;
+
+                d->names = realloc(d->names, names_cap);
+            }
+
+            memcpy(d->names + names_len, name, len + 1);
+            d->offsets[d->count] = names_len;
+            d->types[d->count++] = entry->d_type;
+            names_len += len + 1;
+        }
+    }
+
+    if (n < 0)
+        d->error = 1;
+
+    close(fd);
+
+    return d;
+}
+
+static void free_dir(glob_dir *d)
+{
+    free(d->path);
+    free(d->names);
+    free(d->offsets);
+    free(d->types);
+    free(d);
+}
+
+static uint32_t hash_path(const char *path)
+{
+    uint32_t hash = 2166136261u;
+
+    for (; *path; path++)
+        hash = (hash ^ (unsigned char)*path) * 16777619u;
+
+    return hash;
+}
+
+static glob_dir** cache_slot(glob_cache *c, const char *path)
+{
+    size_t i = hash_path(path) & (c->cap - 1);
+
+    while (c->slots[i] && strcmp(c->slots[i]->path, path))
+        i = (i + 1) & (c->cap - 1);
+
+    return &c->slots[i];
+}
+
+/* Obtiene el listado de un directorio, leyendolo solo la primera vez en la linea */
+static glob_dir* cache_get(glob_cache *c, const char *path)
+{
+    glob_dir **slot;
+
+    if (!c->slots)
+    {
+        c->cap = GLOB_CACHE_INITIAL;
+        c->slots = calloc(c->cap, sizeof(glob_dir*));
+    }
+
+    if (*(slot = cache_slot(c, path)))
+        return *slot;
+
+    if ((c->used + 1) * 2 > c->cap)
+    {
+        glob_cache grown = { .cap = c->cap * 2, .used = c->used };
+
+        grown.slots = calloc(grown.cap, sizeof(glob_dir*));
+
+        for (size_t i = 0; i < c->cap; i++)
+            if (c->slots[i])
+                *cache_slot(&grown, c->slots[i]->path) = c->slots[i];
+
+        free(c->slots);
+        *c = grown;
+        slot = cache_slot(c, path);
+    }
+
+    c->used++;
+
+    return *slot = read_dir(path);
+}
+
+static void free_cache(glob_cache *c)
+{
+    for (size_t i = 0; i < c->cap; i++)
+        if (c->slots[i])
+            free_dir(c->slots[i]);
+
+    free(c->slots);
+}
+
+static int path_is_dir(const char *path, int follow)
+{
+    struct stat st;
+
+    return (follow ? stat(path, &st) : lstat(path, &st)) == 0 && S_ISDIR(st.st_mode);
+}
+
+static void add_result(glob_walk *w)
+{
+    if (w->dir_only && !path_is_dir(w->path.data, 1))
+        return;
+
+    w->offsets = grow_array(w->offsets, &w->offsets_cap, w->count, sizeof(size_t));
+    w->offsets[w->count++] = w->names.len;
+
+    glob_append(&w->names, w->path.data, w->path.len);
+
+    if (w->dir_only)
+        glob_append(&w->names, "/", 1);
+
+    w->names.len++;
+}
+
+/* Agrega un componente a la ruta actual. Retorna la longitud anterior, para restaurarla */
+static size_t push_path(glob_walk *w, const char *name)
+{
+    size_t len = w->path.len;
+
+    if (len && w->path.data[len - 1] != '/')
+        glob_append(&w->path, "/", 1);
+
+    glob_append(&w->path, name, strlen(name));
+
+    return len;
+}
+
+static void pop_path(glob_walk *w, size_t len)
+{
+    w->path.len = len;
+    w->path.data[len] = ASCII_END_OF_STRING;
+}
+
+/* Indica si la entrada i del directorio es un directorio, ya agregada a la ruta actual */
+static int entry_is_dir(glob_walk *w, glob_dir *d, size_t i, int follow)
+{
+    if (d->types[i] == DT_DIR)
+        return 1;
+
+    if (d->types[i] == DT_UNKNOWN || (follow && d->types[i] == DT_LNK))
+        return path_is_dir(w->path.data, follow);
+
+    return 0;
+}
+
+static glob_dir* current_dir(glob_walk *w)
+{
+    return cache_get(w->cache, w->path.len ? w->path.data : ".");
+}
+
+static void walk(glob_walk *w, int index);
+
+/* '**' coincide con cero o mas directorios, sin seguir enlaces simbolicos ni entrar en los ocultos */
+static void walk_recursive(glob_walk *w, int index)
+{
+    int last = index == w->n_components - 1;
+    glob_dir *d;
+
+    if (!last)
+        walk(w, index + 1);
+
+    if ((d = current_dir(w))->error)
+        return;
+
+    for (size_t i = 0; i < d->count; i++)
+    {
+        const char *name = d->names + d->offsets[i];
+
+        if (*name == '.')
+            continue;
+
+        size_t len = push_path(w, name);
+        int is_dir = entry_is_dir(w, d, i, 0);
+
+        if (last)
+            add_result(w);
+
+        if (is_dir)
+            walk_recursive(w, index);
+
+        pop_path(w, len);
+    }
+}
+
+static void walk(glob_walk *w, int index)
+{
+    if (index == w->n_components)
+    {
+        add_result(w);
+        return;
+    }
+
+    const char *component = w->components[index];
+    int last = index == w->n_components - 1;
+
+    if (!strcmp(component, "**"))
+    {
+        walk_recursive(w, index);
+        return;
+    }
+
+    if (!has_glob_chars(component))
+    {
+        size_t len = push_path(w, component);
+        struct stat st;
+
+        if (!last || lstat(w->path.data, &st) == 0)
+            walk(w, index + 1);
+
+        pop_path(w, len);
+        return;
+    }
+
+    glob_dir *d = current_dir(w);
+
+    for (size_t i = 0; !d->error && i < d->count; i++)
+    {
+        const char *name = d->names + d->offsets[i];
+
+        if (fnmatch(component, name, FNM_PERIOD))
+            continue;
+
+        size_t len = push_path(w, name);
+
+        if (last)
+            add_result(w);
+        else if (entry_is_dir(w, d, i, 1))
+            walk(w, index + 1);
+
+        pop_path(w, len);
+    }
+}
+
+static void swap_names(char **a, char **b)
+{
+    char *t = *a;
+
+    *a = *b;
+    *b = t;
+}
+
+/* Quicksort de cadenas multiclave (Bentley-Sedgewick): compara cada caracter una sola vez por nivel */
+static void sort_names(char **a, size_t n, size_t depth)
+{
+    while (n > GLOB_INSERTION_SORT)
+    {
+        int pivot = (unsigned char)a[n / 2][depth];
+        size_t lt = 0, i = 0, gt = n;
+
+        while (i < gt)
+        {
+            int c = (unsigned char)a[i][depth];
+
+            if (c < pivot)
+                swap_names(&a[lt++], &a[i++]);
+            else if (c > pivot)
+                swap_names(&a[i], &a[--gt]);
+            else
+                i++;
+        }
+
+        sort_names(a, lt, depth);
+        sort_names(a + gt, n - gt, depth);
+
+        if (!pivot)
+            return;
+
+        a += lt;
+        n = gt - lt;
+        depth++;
+    }
+
+    for (size_t i = 1; i < n; i++)
+        for (size_t j = i; j > 0 && strcmp(a[j - 1] + depth, a[j] + depth) > 0; j--)
+            swap_names(&a[j - 1], &a[j]);
+}
+
+/* Expande un patron y agrega los resultados al buffer. Retorna el numero de coincidencias */
+static size_t glob_word(glob_cache *cache, const char *word, glob_buffer *out)
+{
+    glob_walk w = { .cache = cache };
+    char *pattern = strdup(word);
+    size_t len = strlen(pattern);
+    char *end_str;
+
+    if (len > 1 && pattern[len - 1] == '/')
+    {
+        w.dir_only = 1;
+        pattern[len - 1] = ASCII_END_OF_STRING;
+    }
+
+    if (*pattern == '/')
+        glob_append(&w.path, "/", 1);
+    else
+        glob_append(&w.path, "", 0);
+
+    for (char *c = strtok_r(pattern, "/", &end_str); c; c = strtok_r(NULL, "/", &end_str))
+    {
+        w.components = realloc(w.components, sizeof(char*) * (w.n_components + 1));
+        w.components[w.n_components++] = c;
+    }
+
+    if (w.n_components)
+        walk(&w, 0);
+
+    if (w.count)
+    {
+        char **sorted = malloc(sizeof(char*) * w.count);
+
+        for (size_t i = 0; i < w.count; i++)
+            sorted[i] = w.names.data + w.offsets[i];
+
+        sort_names(sorted, w.count, 0);
+
+        for (size_t i = 0; i < w.count; i++)
+        {
+            if (i)
+                glob_append(out, " ", 1);
+
+            glob_append(out, sorted[i], strlen(sorted[i]));
+        }
+
+        free(sorted);
+    }
+
+    free(w.path.data);
+    free(w.names.data);
+    free(w.offsets);
+    free(w.components);
+    free(pattern);
+
+    return w.count;
+}
+
+char* expand_globs(const char *line)
+{
+    uint64_t t_glob = trace_begin();
+    glob_cache cache = {0};
+    glob_buffer out = {0};
+    int redirect_next = 0;
+
+    glob_append(&out, "", 0);
+
+    while (*line)
+    {
+        size_t gap = strspn(line, " \t");
+
+        glob_append(&out, line, gap);
+        line += gap;
+
+        if (!*line)
+            break;
+
+        size_t len = strcspn(line, " \t");
+        char *word = strndup(line, len);
+
+        /* Los destinos de redirecciones y las palabras entre comillas no se expanden */
+        int literal = redirect_next || *word == '<' || *word == '>' || *word == '"' || *word == '\''
+                      || (isdigit((unsigned char)*word) && word[1] == '>');
+
+        redirect_next = word[len - 1] == '<' || word[len - 1] == '>';
+
+        if (literal || !has_glob_chars(word) || !glob_word(&cache, word, &out))
+            glob_append(&out, word, len);
+
+        free(word);
+        line += len;
+    }
+
+    if (cache.slots)
+        free_cache(&cache);
+
+    trace_end("glob", t_glob);
+
+    return out.data;
+}
@@ -0,0 +1,442 @@
+/**
+ * @file JobCache.c
+ * @author Bottini, Franco Nicolas.
+ * @brief Implementacion de la memoizacion de comandos.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../../inc/Job/JobCache.h"
+
+#define DIGEST_P1 0x9E3779B97F4A7C15ULL
+#define DIGEST_P2 0xC2B2AE3D27D4EB4FULL
+
+static uint64_t rotl(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static uint64_t fmix(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ULL;
+    x ^= x >> 33;
+
+    return x;
+}
+
+/* Agrega un campo al resumen, de a 8 bytes por paso. La longitud se mezcla al final para que los
+   campos consecutivos no se confundan ("ab" + "c" != "a" + "bc") */
+static void digest_update(cache_digest *d, const void *data, size_t len)
+{
+    const unsigned char *p = data;
+    uint64_t a = d->h[0], b = d->h[1], w;
+    size_t n = len;
+
+    while (n >= 8)
+    {
+        memcpy(&w, p, 8);
+        a = rotl(a ^ (w * DIGEST_P1), 31) * DIGEST_P2;
+        b = rotl(b + (w * DIGEST_P2), 27) * DIGEST_P1 + a;
+        p += 8;
+        n -= 8;
+    }
+
+    w = 0;
+    memcpy(&w, p, n);
+    a = rotl(a ^ ((w ^ len) * DIGEST_P1), 31) * DIGEST_P2;
+    b = rotl(b + (w + len) * DIGEST_P2, 27) * DIGEST_P1 + a;
+
+    d->h[0] = a;
+    d->h[1] = b;
+}
+
+static void digest_string(cache_digest *d, const char *s)
+{
+    digest_update(d, s, strlen(s));
+}
+
+static void digest_hex(cache_digest d, char hex[33])
+{
+    uint64_t h0 = fmix(d.h[0] ^ rotl(d.h[1], 17));
+    uint64_t h1 = fmix(d.h[1] ^ h0);
+
+    snprintf(hex, 33, "%016llx%016llx", (unsigned long long)h0, (unsigned long long)h1);
+}
+
+static void digest_data(const char *data, size_t len, char hex[33])
+{
+    cache_digest d = { { DIGEST_P1, DIGEST_P2 } };
+
+    digest_update(&d, data, len);
+    digest_hex(d, hex);
+}
+
+/* Agrega un archivo al resumen. Retorna -1 si no es un archivo regular, cuyo contenido no es reproducible */
+static int digest_file(cache_digest *d, const char *path, int use_mtime)
+{
+    struct stat st;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+    digest_string(d, path);
+
+    if (fd < 0 || fstat(fd, &st) < 0)
+    {
+        digest_string(d, "\001missing");
+
+        if (fd >= 0)
+            close(fd);
+
+        return 0;
+    }
+
+    if (!S_ISREG(st.st_mode))
+    {
+        close(fd);
+        return -1;
+    }
+
+    if (use_mtime)
+    {
+        uint64_t meta[4] = {
+            st.st_dev, st.st_ino, st.st_size,
+            (uint64_t)st.st_mtim.tv_sec * 1000000000ULL + st.st_mtim.tv_nsec
+        };
+
+        digest_update(d, meta, sizeof(meta));
+    }
+    else if (st.st_size > 0)
+    {
+        void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (data == MAP_FAILED)
+        {
+            close(fd);
+            return -1;
+        }
+
+        madvise(data, st.st_size, MADV_SEQUENTIAL);
+        digest_update(d, data, st.st_size);
+        munmap(data, st.st_size);
+    }
+    else
+        digest_update(d, "", 0);
+
+    close(fd);
+
+    return 0;
+}
+
+/* Retorna el final de la palabra que sigue a una redireccion */
+static char* redirection_target(char *s, char **start)
+{
+    while (*s == ASCII_SPACE)
+        s++;
+
+    *start = s;
+
+    while (*s && *s != ASCII_SPACE && *s != ASCII_LESS_THAN && *s != ASCII_GREATER_THAN && *s != ASCII_PLECA)
+        s++;
+
+    return s;
+}
+
+/* Registra las entradas '<' y corta '> archivo' y '2> archivo' del comando, que se reproducen desde la cache.
+   Retorna -1 sin modificar el comando si no puede memoizarse */
+static int cut_redirections(char *command, cache_redirections *r)
+{
+    size_t len = strlen(command);
+
+    if (len && command[len - 1] == ASCII_AMPERSAND)
+        return -1;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        if ((command[i] == ASCII_LESS_THAN || command[i] == ASCII_GREATER_THAN) && command[i + 1] == ASCII_OPEN_PAREN)
+            return -1;
+
+        if (command[i] == ASCII_GREATER_THAN && i > 0 && command[i - 1] == ASCII_AMPERSAND)
+            return -1;
+    }
+
+    for (size_t i = 0; i < len; i++)
+    {
+        char *start, *end;
+
+        if (command[i] == ASCII_LESS_THAN)
+        {
+            end = redirection_target(command + i + 1, &start);
+            r->inputs = realloc(r->inputs, sizeof(char*) * (r->n_inputs + 1));
+            r->inputs[r->n_inputs++] = strndup(start, end - start);
+            i = end - command - 1;
+        }
+        else if (command[i] == ASCII_GREATER_THAN && command[i + 1] != ASCII_AMPERSAND)
+        {
+            int is_error = i > 0 && command[i - 1] == ASCII_TWO && (i == 1 || command[i - 2] == ASCII_SPACE);
+            char **target = is_error ? &r->error : &r->output;
+            size_t op = is_error ? i - 1 : i;
+
+            while (command[i + 1] == ASCII_GREATER_THAN)
+                i++;
+
+            end = redirection_target(command + i + 1, &start);
+            free(*target);
+            *target = strndup(start, end - start);
+            memset(command + op, ASCII_SPACE, end - command - op);
+            i = end - command - 1;
+        }
+    }
+
+    return 0;
+}
+
+static int cache_key(const char *command, cache_options *opt, cache_redirections *r, char hex[33])
+{
+    cache_digest d = { { DIGEST_P1, DIGEST_P2 } };
+    const char *vars[] = CACHE_KEY_VARS;
+    size_t n_fixed = sizeof(vars) / sizeof(vars[0]);
+    char *cwd = getcwd(NULL, 0);
+
+    digest_string(&d, CACHE_KEY_VERSION);
+    digest_string(&d, command);
+    digest_string(&d, cwd ? cwd : "");
+    free(cwd);
+
+    for (size_t i = 0; i < n_fixed + opt->n_vars; i++)
+    {
+        const char *name = i < n_fixed ? vars[i] : opt->vars[i - n_fixed];
+        const char *value = env_get(name);
+
+        digest_string(&d, name);
+        digest_string(&d, value ? value : "\001unset");
+    }
+
+    for (int i = 0; i < r->n_inputs; i++)
+        if (digest_file(&d, r->inputs[i], opt->use_mtime) < 0)
+            return -1;
+
+    for (int i = 0; i < opt->n_deps; i++)
+        if (digest_file(&d, opt->deps[i], opt->use_mtime) < 0)
+            return -1;
+
+    digest_hex(d, hex);
+
+    return 0;
+}
+
+static int make_dir(const char *path)
+{
+    return mkdir(path, S_IRWXU) == 0 || errno == EEXIST ? 0 : -1;
+}
+
+/* Retorna el directorio del almacen, creando sus subdirectorios keys y objects si no existen */
+static const char* cache_dir(void)
+{
+    static char dir[PATH_MAX - 64];
+    char sub[PATH_MAX];
+    const char *base;
+
+    if ((base = env_get(CACHE_ENV_VAR)) && *base)
+        snprintf(dir, sizeof(dir), "%s", base);
+    else if ((base = env_get("XDG_CACHE_HOME")) && *base)
+        snprintf(dir, sizeof(dir), "%s/myshell", base);
+    else if ((base = env_get("HOME")) && *base)
+    {
+        snprintf(dir, sizeof(dir), "%s/.cache", base);
+        make_dir(dir);
+        snprintf(dir, sizeof(dir), "%s/.cache/myshell", base);
+    }
+    else
+        return NULL;
+
+    if (make_dir(dir) < 0)
+        return NULL;
+
+    snprintf(sub, sizeof(sub), "%s/keys", dir);
+
+    if (make_dir(sub) < 0)
+        return NULL;
+
+    snprintf(sub, sizeof(sub), "%s/objects", dir);
+
+    return make_dir(sub) < 0 ? NULL : dir;
+}
+
+static int read_file(const char *path, job_buffer *b)
+{
+    char buffer[JOB_OUTPUT_CHUNK];
+    ssize_t n;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0)
+        return -1;
+
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0)
+        append_job_buffer(b, buffer, n);
+
+    close(fd);
+
+    return n < 0 ? -1 : 0;
+}
+
+static int write_all(int fd, const char *data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = write(fd, data, len);
+
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        if (n < 0)
+            return -1;
+
+        data += n;
+        len -= n;
+    }
+
+    return 0;
+}
+
+/* Escribe un archivo del almacen en un temporal y lo renombra, para que un lector nunca vea uno a medias */
+static int write_atomic(const char *path, const char *data, size_t len)
+{
+    char tmp[PATH_MAX];
+    int fd;
+
+    snprintf(tmp, sizeof(tmp), "%s.XXXXXX", path);
+
+    if ((fd = mkstemp(tmp)) < 0)
+        return -1;
+
+    if (write_all(fd, data, len) < 0 || close(fd) < 0 || rename(tmp, path) < 0)
+    {
+        unlink(tmp);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Guarda un contenido en objects/<resumen>, una sola vez aunque lo produzcan varios comandos */
+static int store_object(const char *dir, job_buffer *b, char hex[33])
+{
+    char path[PATH_MAX];
+
+    digest_data(b->data ? b->data : "", b->len, hex);
+    snprintf(path, sizeof(path), "%s/objects/%s", dir, hex);
+
+    if (access(path, F_OK) == 0)
+        return 0;
+
+    return write_atomic(path, b->data ? b->data : "", b->len);
+}
+
+static int load_entry(const char *dir, const char *key, job_buffer *out, job_buffer *err, int *status)
+{
+    char path[PATH_MAX];
+    char out_hex[33], err_hex[33];
+    job_buffer record = { NULL, 0, 0 };
+    int ok;
+
+    snprintf(path, sizeof(path), "%s/keys/%s", dir, key);
+
+    if (read_file(path, &record) < 0)
+        return -1;
+
+    append_job_buffer(&record, "", 1);
+    ok = sscanf(record.data, "%d %32s %32s", status, out_hex, err_hex) == 3;
+    free(record.data);
+
+    if (!ok)
+        return -1;
+
+    snprintf(path, sizeof(path), "%s/objects/%s", dir, out_hex);
+
+    if (read_file(path, out) < 0)
+        return -1;
+
+    snprintf(path, sizeof(path), "%s/objects/%s", dir, err_hex);
+
+    return read_file(path, err);
+}
+
+static void store_entry(const char *dir, const char *key, job_buffer *out, job_buffer *err, int status)
+{
+    char path[PATH_MAX];
+    char record[80];
+    char out_hex[33], err_hex[33];
+
+    if (store_object(dir, out, out_hex) < 0 || store_object(dir, err, err_hex) < 0)
+        return;
+
+    snprintf(path, sizeof(path), "%s/keys/%s", dir, key);
+    snprintf(record, sizeof(record), "%d %s %s\n", status, out_hex, err_hex);
+    write_atomic(path, record, strlen(record));
+}
+
+/* Emite una salida en su archivo de destino o, si no se redirige, en el flujo de la shell */
+static void emit_output(job_buffer *b, const char *path, FILE *fp)
+{
+    if (!path)
+    {
+        fwrite(b->data ? b->data : "", 1, b->len, fp);
+        fflush(fp);
+        return;
+    }
+
+    int fd = open(path, O_CREAT | O_WRONLY | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+    if (fd < 0 || write_all(fd, b->data ? b->data : "", b->len) < 0)
+        fprintf(stderr, KRED"\ncache: %s: %s !\n\n"KDEF, path, strerror(errno));
+
+    if (fd >= 0)
+        close(fd);
+}
+
+int run_cached(char *command, cache_options *opt, job_builder builder)
+{
+    uint64_t t_cache = trace_begin();
+    cache_redirections r = { NULL, 0, NULL, NULL };
+    job_buffer out = { NULL, 0, 0 }, err = { NULL, 0, 0 };
+    char *original = strdup(command);
+    const char *dir = cache_dir();
+    char key[33];
+    int status = -1;
+    int hit = 0;
+
+    if (!dir || cut_redirections(command, &r) < 0 || cache_key(command, opt, &r, key) < 0)
+        strcpy(command, original);
+    else
+    {
+        hit = load_entry(dir, key, &out, &err, &status) == 0;
+
+        if (!hit)
+        {
+            out.len = err.len = 0;
+            status = capture_job_output(command, builder, &out, &err);
+
+            if (status != 128 + SIGINT)
+                store_entry(dir, key, &out, &err, status);
+        }
+
+        emit_output(&out, r.output, stdout);
+        emit_output(&err, r.error, stderr);
+    }
+
+    free_array(r.inputs, r.n_inputs);
+    free(r.output);
+    free(r.error);
+    free(out.data);
+    free(err.data);
+    free(original);
+
+    trace_end_arg("cache", t_cache, hit);
+
+    return status;
+}
@@ -19,11 +19,53 @@ const char* PROCESS_STATUS_STRING[] = {
     "new",
     "terminated",
     "quit",  
-    "ready"
+    "ready",
+    "queued"
 };
 
 int flag_work_tube_printed = 0;
 
+int last_exit_status = 0;
+
+int job_control_interactive = 0;
+
+job_scheduler scheduler = { 0, QUEUE_FIFO };
+
+static volatile sig_atomic_t wait_interrupted = 0;
+
+static int exec_status_fd = -1;
+
+static int sigchld_block_depth = 0;
+
+static volatile sig_atomic_t jobs_changed = 0;
+
+static int queued_jobs = 0;
+
+/* Espera en curso de wait_jobs, a la cual se agregan los trabajos que se lanzan mientras dura. NULL si no hay */
+static job_waiter *active_wait = NULL;
+
+static int wait_result, wait_finished, wait_remaining;
+
+static finished_job finished_jobs[FINISHED_JOBS_KEPT];
+
+static int next_finished_job = 0;
+
+static void start_zygote_from_env(void)
+{
+    char *zygote = getenv(ZYGOTE_ENV_VAR);
+
+    if (zygote && *zygote && strcmp(zygote, "0") && zygote_start() < 0)
+        fprintf(stderr, KRED"\nzygote: %s !\n\n"KDEF, strerror(errno));
+}
+
+static void scheduler_from_env(void)
+{
+    char *max_jobs = getenv(SCHEDULER_ENV_VAR);
+
+    if (max_jobs && *max_jobs)
+        scheduler.max_running = atoi(max_jobs) > 0 ? atoi(max_jobs) : 0;
+}
+
 void job_control_init()
 {
     pid_t shell_pgid;
@@ -44,6 +86,8 @@ void job_control_init()
     signal(SIGTTIN, SIG_IGN);
     signal(SIGTTOU, SIG_IGN);
 
+    raise_fd_limit();
+
     shell_pgid = getpid ();
     if (setpgid(shell_pgid, shell_pgid) < 0)
     {
@@ -52,63 +96,358 @@ void job_control_init()
     }
 
     tcsetpgrp(STDIN_FILENO, shell_pgid);
+
+    job_control_interactive = 1;
+
+    scheduler_from_env();
+    start_zygote_from_env();
+    job_shm_init();
+}
+
+void job_control_init_headless(void)
+{
+    struct sigaction sigchld_action = {
+        .sa_handler = childend_handler,
+        .sa_flags = 0
+    };
+    sigemptyset(&sigchld_action.sa_mask);
+    sigaction(SIGCHLD, &sigchld_action, NULL);
+
+    raise_fd_limit();
+    scheduler_from_env();
+    start_zygote_from_env();
+    job_shm_init();
+}
+
+void job_control_detach(void)
+{
+    first_job = NULL;
+    sigchld_block_depth = 0;
+    jobs_changed = 0;
+    queued_jobs = 0;
+    active_wait = NULL;
+    memset(finished_jobs, 0, sizeof(finished_jobs));
+
+    forget_error_channel();
+    zygote_forget();
 }
 
 void childend_handler()
 {
     int status;
+    int saved_errno = errno;
+    struct rusage usage;
     pid_t pid;
     process *p;
 
-    while ((pid = waitpid(WAIT_ANY, &status, WNOHANG | WUNTRACED | WCONTINUED)) > 0) 
+    metrics.signals_received++;
+    sigchld_block_depth++;
+
+    while ((pid = wait4(WAIT_ANY, &status, WNOHANG | WUNTRACED | WCONTINUED, &usage)) > 0) 
     {
         p = get_process_by_pid(pid);
 
         if(!p)
         {
+            if (zygote_exited(pid))
+                continue;
+
             fprintf (stderr, KRED"\nNo child process %d !\n"KDEF, pid);
             break;
         }
 
+        p->usage = usage;
         update_process_status(p, status);
     }
 
     if(pid < 0 && errno != ECHILD)
         fprintf(stderr, KRED"\nwaitpid: %s !\n\n"KDEF, strerror(errno));
-    
-    if(!is_any_job_in_foreground())
+
+    /* Los trabajos completados se remueven y la cola se atiende fuera del manejador, en process_job_changes */
+    jobs_changed = 1;
+
+    sigchld_block_depth--;
+    errno = saved_errno;
+}
+
+void process_job_changes(void)
+{
+    if (!jobs_changed)
+        return;
+
+    block_sigchld();
+    jobs_changed = 0;
+
+    if (!is_any_job_in_foreground())
         clean_done_job(SOURCE_HANDLER);
+
+    unblock_sigchld();
 }
 
-void clean_done_job(SOURCE_CLEAN source)
+void block_sigchld(void)
+{
+    sigset_t set;
+
+    if (sigchld_block_depth++ > 0)
+        return;
+
+    sigemptyset(&set);
+    sigaddset(&set, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &set, NULL);
+}
+
+void unblock_sigchld(void)
+{
+    sigset_t set;
+
+    if (sigchld_block_depth == 0 || --sigchld_block_depth > 0)
+        return;
+
+    sigemptyset(&set);
+    sigaddset(&set, SIGCHLD);
+    sigprocmask(SIG_UNBLOCK, &set, NULL);
+}
+
+static void dispatch_queue(void);
+static int resolve_dependents(job *done);
+static void unlink_dependent(job *j);
+
+/* El codigo de salida de un trabajo en segundo plano removido se conserva para wait y after, que pueden nombrarlo
+   despues. Los trabajos en primer plano tambien toman IDs, pero no se nombran con %N */
+static void forget_finished_job(int id)
+{
+    for (int i = 0; i < FINISHED_JOBS_KEPT; i++)
+        if (finished_jobs[i].id == id)
+            finished_jobs[i].id = 0;
+}
+
+/* Los IDs se reutilizan: el codigo anterior del mismo ID se descarta para que wait y after no lo encuentren */
+static void remember_finished_job(job *j)
+{
+    forget_finished_job(j->id);
+    finished_jobs[next_finished_job] = (finished_job){ j->id, get_job_exit_code(j) };
+    next_finished_job = (next_finished_job + 1) % FINISHED_JOBS_KEPT;
+}
+
+int get_finished_job(int id, int *exit_code)
+{
+    for (int i = 0; i < FINISHED_JOBS_KEPT; i++)
+    {
+        if (id > 0 && finished_jobs[i].id == id)
+        {
+            *exit_code = finished_jobs[i].exit_code;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/* Informa y remueve un trabajo completado que no es administrado por un builtin. Retorna la cantidad de
+   dependientes que se cancelaron porque el trabajo fallo */
+static int remove_done_job(job *j, SOURCE_CLEAN source)
+{
+    int cancelled;
+
+    if (j->managed || !is_job_completed(j))
+        return 0;
+
+    if(j->mode == BACKGROUND_EXECUTION || source == SOURCE_KILL || source == SOURCE_REANUDE_FG)
+    {
+        if(source == SOURCE_HANDLER)
+            fprintf(stdout, "\n\n");
+        else
+            fprintf(stdout, "\n");
+
+        print_job_status(j);
+
+        if(source == SOURCE_HANDLER || source == SOURCE_KILL || source == SOURCE_REANUDE_FG || source == SOURCE_WAIT)
+            fprintf(stdout, "\n");
+    }
+    
+    print_job_pipe(j);  
+
+    if (j->start_time)
+        metrics_job_reaped(get_monotonic_ns() - j->start_time);
+
+    cancelled = resolve_dependents(j);
+    unlink_dependent(j);
+
+    if (j->mode == BACKGROUND_EXECUTION)
+        remember_finished_job(j);
+    remove_job(j);
+
+    return cancelled;
+}
+
+static int remove_done_jobs(SOURCE_CLEAN source)
 {
     job* j = first_job;
     job* aux;
+    int cancelled = 0;
 
     while (j)
     {
         aux = j;
         j = j->next;
 
-        if (is_job_completed(aux))
+        cancelled += remove_done_job(aux, source);
+    }
+
+    return cancelled;
+}
+
+void clean_done_job(SOURCE_CLEAN source)
+{
+    uint64_t t_clean = trace_begin();
+
+    /* Los trabajos cancelados por una dependencia fallida quedan completos y se remueven en la siguiente pasada */
+    while (remove_done_jobs(source) > 0);
+    dispatch_queue();
+
+    trace_end("clean_done_job", t_clean);
+}
+
+int count_running_jobs(void)
+{
+    int n = 0;
+
+    for (job *j = first_job; j; j = j->next)
+        if (!j->managed && j->mode == BACKGROUND_EXECUTION && !is_job_queued(j) && !is_job_completed(j) && !is_job_stoped(j))
+            n++;
+
+    return n;
+}
+
+int count_queued_jobs(void)
+{
+    return queued_jobs;
+}
+
+static job* next_queued_job(void)
+{
+    job *next = NULL;
+
+    for (job *j = first_job; j; j = j->next)
+        if (is_job_queued(j) && !j->n_after && (!next || (scheduler.policy == QUEUE_PRIORITY && j->priority > next->priority)))
+            next = j;
+
+    return next;
+}
+
+static void queue_job(job *j)
+{
+    for (process *p = j->first_process; p; p = p->next)
+        set_process_status(p, STATUS_QUEUED);
+
+    queued_jobs++;
+
+    fprintf(stdout, "\n");
+    print_job_status(j);
+    fprintf(stdout, "\n\n");
+
+    job_shm_publish(j, NULL);
+}
+
+static void wait_track(job *j);
+
+static void cancel_queued_job(job *j, int exit_code)
+{
+    for (process *p = j->first_process; p; p = p->next)
+    {
+        p->exit_code = exit_code;
+        set_process_status(p, STATUS_TERMINATED);
+    }
+
+    queued_jobs--;
+    job_shm_publish(j, NULL);
+    wait_track(j);
+}
+
+/* Registra j como dependiente de los trabajos que nombra con after. Los que ya no estan en la lista no lo retienen */
+static void link_dependent(job *j)
+{
+    for (int i = 0; i < j->n_after; i++)
+    {
+        job *prev = get_job_by_id(j->after[i]);
+
+        if (!prev)
         {
-            if(aux->mode == BACKGROUND_EXECUTION || source == SOURCE_KILL || source == SOURCE_REANUDE_FG)
-            {
-                if(source == SOURCE_HANDLER)
-                    fprintf(stdout, "\n\n");
-                else
-                    fprintf(stdout, "\n");
+            j->after[i--] = j->after[--j->n_after];
+            continue;
+        }
 
-                print_job_status(aux);
+        prev->dependents = realloc(prev->dependents, sizeof(job*) * (prev->n_dependents + 1));
+        prev->dependents[prev->n_dependents++] = j;
+    }
+}
 
-                if(source == SOURCE_HANDLER || source == SOURCE_KILL || source == SOURCE_REANUDE_FG)
-                    fprintf(stdout, "\n");
-            }
-            
-            print_job_pipe(aux);  
-            remove_job(aux);
+/* Quita a j de los dependientes de los trabajos que todavia esperaba, si se remueve antes que ellos */
+static void unlink_dependent(job *j)
+{
+    for (int i = 0; i < j->n_after; i++)
+    {
+        job *prev = get_job_by_id(j->after[i]);
+
+        for (int k = 0; prev && k < prev->n_dependents; k++)
+            if (prev->dependents[k] == j)
+                prev->dependents[k--] = prev->dependents[--prev->n_dependents];
+    }
+
+    j->n_after = 0;
+}
+
+/* Resuelve una unica vez los dependientes de un trabajo finalizado, con un costo proporcional a su cantidad. Si el
+   trabajo fallo, cada dependiente encolado se cancela y, en cadena, los que dependen de el. Retorna los cancelados */
+static int resolve_dependents(job *done)
+{
+    int failed = get_job_exit_code(done) != 0;
+    int cancelled = 0;
+
+    for (int k = 0; k < done->n_dependents; k++)
+    {
+        job *j = done->dependents[k];
+
+        for (int i = 0; i < j->n_after; i++)
+            if (j->after[i] == done->id)
+                j->after[i--] = j->after[--j->n_after];
+
+        j->after_failed |= failed;
+
+        if (j->after_failed && is_job_queued(j))
+        {
+            cancel_queued_job(j, EXIT_FAILURE);
+            cancelled += 1 + resolve_dependents(j);
         }
     }
+
+    free(done->dependents);
+    done->dependents = NULL;
+    done->n_dependents = 0;
+
+    return cancelled;
+}
+
+static void start_job(job *j);
+
+static void dispatch_queue(void)
+{
+    job *j;
+
+    if (!queued_jobs)
+        return;
+
+    block_sigchld();
+
+    while ((j = next_queued_job()) && (scheduler.max_running <= 0 || count_running_jobs() < scheduler.max_running))
+        start_job(j);
+
+    unblock_sigchld();
+}
+
+void schedule_jobs(void)
+{
+    dispatch_queue();
 }
 
 void update_process_status(process *p, PROCESS_STATUS status)
@@ -117,6 +456,7 @@ void update_process_status(process *p, PROCESS_STATUS status)
 
     if (WIFSTOPPED(status))
     {
+        p->exit_code = 128 + WSTOPSIG(status);
         set_process_status(p, STATUS_SUSPENDED);
 
         if(is_job_stoped(j))
@@ -139,6 +479,8 @@ void update_process_status(process *p, PROCESS_STATUS status)
     }
     else if (WIFSIGNALED(status))
     {
+        p->exit_code = 128 + WTERMSIG(status);
+
         if (WTERMSIG(status) == SIGINT)
         {
             set_process_status(p, STATUS_TERMINATED);
@@ -156,23 +498,30 @@ void update_process_status(process *p, PROCESS_STATUS status)
                 fprintf(stdout, "\n");
             }
         }
-        else if (WTERMSIG(status) == SIGKILL)
+        else
             set_process_status(p, STATUS_TERMINATED);
     }
     else if (WIFEXITED(status))
+    {
+        p->exit_code = WEXITSTATUS(status);
         set_process_status(p, STATUS_DONE);
+    }
+
+    job_shm_publish(j, p);
 }
 
 void wait_for_job(job *j, int catch_stoped)
 {
+    uint64_t t_wait = trace_begin();
     int end_while = 0;
     int status;
+    struct rusage usage;
     pid_t pid;
     process *p;
 
     do
     {
-        if((pid = waitpid(-j->pgid, &status, WUNTRACED)) < 1)
+        if((pid = wait4(job_control_interactive ? -j->pgid : WAIT_ANY, &status, WUNTRACED, &usage)) < 1)
         {
             if(errno == EINTR)
                 continue;
@@ -188,8 +537,18 @@ void wait_for_job(job *j, int catch_stoped)
             break;
         }
     
+        p->usage = usage;
         update_process_status(p, status);
 
+        /* Sin terminal se recolecta cualquier hijo: un trabajo en segundo plano que finaliza deja lugar en la cola */
+        job *owner = get_job_by_pid(pid);
+
+        if (owner != j && owner && !owner->managed && is_job_completed(owner))
+        {
+            jobs_changed = 1;
+            dispatch_queue();
+        }
+
         if(catch_stoped)
             end_while = is_job_stoped(j);
         else
@@ -198,140 +557,456 @@ void wait_for_job(job *j, int catch_stoped)
 
     if(pid < 0 && errno != ECHILD)
         fprintf(stderr, KRED"\nwaitpid: %s !\n\n"KDEF, strerror(errno));
+
+    trace_end_arg("wait_for_job", t_wait, j->id);
 }
 
-void launch_job(job *j, EXECUTION_MODES mode) 
+static int count_job_process(job *j)
 {
-    int proc_io_pipe[2];
-    int infile, outfile;
+    int n = 0;
 
-    insert_job(j, mode);
+    for (process *p = j->first_process; p; p = p->next)
+        n++;
 
-    if (pipe(j->io_fd) < 0 || pipe(j->err_fd) < 0)
+    return n;
+}
+
+static void close_job_fds(int (*pipes)[2], int n, int out_pipe[2])
+{
+    for (int i = 0; i < n; i++)
     {
-        perror(KRED"\npipe\n"KDEF);
-        exit(EXIT_FAILURE);
+        close(pipes[i][0]);
+        close(pipes[i][1]);
     }
 
-    if(!j->first_process->input_path)
+    if (out_pipe[0] >= 0)
     {
-        if(mode == BACKGROUND_EXECUTION)
-            infile = j->io_fd[0];
-        else
-            infile = STDIN_FILENO;
+        close(out_pipe[0]);
+        close(out_pipe[1]);
+        out_pipe[0] = out_pipe[1] = -1;
     }
-    else
-        infile = open(j->first_process->input_path, O_RDONLY);
+}
 
-    for (process *p = j->first_process; p; p = p->next)
+static int alloc_job_fds(job *j, int (*pipes)[2], int n, int out_pipe[2])
+{
+    int err;
+
+    if (job_error_channel() < 0)
+        return -1;
+
+    if (j->mode == BACKGROUND_EXECUTION && job_null_input() < 0)
+        return -1;
+
+    for (int i = 0; i < n; i++)
     {
-        if(infile < 0)
+        if (pipe2(pipes[i], O_CLOEXEC) < 0)
         {
-            fprintf(stderr, KRED"\nNo such file or directory: %s !\n"KDEF, p->input_path);
-            set_process_status(p, STATUS_TERMINATED);
-            continue;
+            err = errno;
+            close_job_fds(pipes, i, out_pipe);
+            errno = err;
+            return -1;
         }
+    }
 
-        if(p->output_path && *p->output_path == ASCII_LINE_BREAK)
+    if (j->mode == BACKGROUND_EXECUTION && !get_last_process(j)->output_path && j->stdout_fd < 0 && j->subst_fd < 0)
+    {
+        if (reserve_capture_fd() < 0)
         {
-            fprintf(stderr, KRED"\nParse error near '\\n' !\n"KDEF);
-            set_process_status(p, STATUS_TERMINATED);
-            continue;   
+            close_job_fds(pipes, n, out_pipe);
+            errno = EMFILE;
+            return -1;
         }
 
-        if(!p->output_path)
+        if (pipe2(out_pipe, O_CLOEXEC) < 0)
         {
-            if (p->next)
-            {
-                if (pipe(proc_io_pipe) < 0)
-                {
-                    perror(KRED"\npipe\n"KDEF);
-                    exit (EXIT_FAILURE);
-                }
-
-                outfile = proc_io_pipe[1];
-            }
-            else
-            {
-                if(mode == BACKGROUND_EXECUTION)
-                    outfile = j->io_fd[1];
-                else
-                    outfile = STDOUT_FILENO;
-            }
+            err = errno;
+            release_capture_fd();
+            out_pipe[0] = out_pipe[1] = -1;
+            close_job_fds(pipes, n, out_pipe);
+            errno = err;
+            return -1;
         }
-        else
-            outfile = open(p->output_path, O_CREAT|O_WRONLY, S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH);
-        
-        set_process_status(p, STATUS_RUNNING);
 
-        pid_t pid = fork ();
-        if (pid == 0)
-        {
-            if (p->next)
-                launch_process(p, j->pgid, infile, outfile, j->err_fd[1], PIPELINE_EXECUTION);
-            else
-                launch_process(p, j->pgid, infile, outfile, j->err_fd[1], j->mode);
-        }    
-        else if (pid < 0)
-        {
-            perror(KRED"\nfork\n"KDEF);
-            exit (EXIT_FAILURE);
-        }
-        else
+        fcntl(out_pipe[0], F_SETFL, O_NONBLOCK);
+    }
+
+    return 0;
+}
+
+static int relieve_fd_pressure(job *j)
+{
+    int status;
+    struct rusage usage;
+    pid_t pid;
+    job *done = NULL;
+    job *other;
+
+    for (other = first_job; other; other = other->next)
+        if (other != j && !is_job_stoped(other) && !is_job_completed(other))
+            break;
+
+    if (!other)
+        return 0;
+
+    fprintf(stderr, KYEL"\nOut of file descriptors, waiting for a job to finish...\n"KDEF);
+
+    while (!done)
+    {
+        if ((pid = wait4(WAIT_ANY, &status, 0, &usage)) < 0)
         {
-            p->pid = pid;
-            
-            if (!j->pgid)
-                j->pgid = pid;
-            
-            setpgid (pid, j->pgid);
+            if (errno == EINTR)
+                continue;
+
+            return 0;
         }
 
-        if (infile != STDIN_FILENO && infile != j->io_fd[0])
-            close(infile);
+        process *p = get_process_by_pid(pid);
 
-        if (outfile != STDOUT_FILENO && outfile != j->io_fd[1])
-            close(outfile);
-        
-        infile = proc_io_pipe[0];
+        if (!p)
+            continue;
 
-        if(p->next)
-            if(p->next->input_path)
-                infile = open(p->next->input_path, O_RDONLY);
-    }
+        p->usage = usage;
+        update_process_status(p, status);
 
-    if (j->mode == FOREGROUND_EXECUTION)
-    {
-        tcsetpgrp(STDIN_FILENO, j->pgid);
-        wait_for_job(j, 1);
-        tcsetpgrp(STDIN_FILENO, getpid());
+        job *owner = get_job_by_pid(pid);
 
-        clean_done_job(SOURCE_FOREGROUND_EXECUTION);
+        if (owner && owner != j && is_job_completed(owner))
+            done = owner;
     }
-    else if (j->mode == BACKGROUND_EXECUTION)
-        print_job_process(j);
+
+    clean_done_job(SOURCE_WAIT);
+
+    return 1;
 }
 
-void launch_process(process *p, pid_t pgid, int in_fd, int out_fd, int err_fd, EXECUTION_MODES mode) 
+void launch_job(job *j, EXECUTION_MODES mode) 
 {
-    pid_t childpid = getpid ();
+    block_sigchld();
+    link_dependent(j);
 
-    if (pgid == 0)
-        pgid = childpid;
-    
-    setpgid(childpid, pgid);
+    int queued = (mode == BACKGROUND_EXECUTION && !j->managed && scheduler.max_running > 0
+                  && (count_running_jobs() >= scheduler.max_running || next_queued_job())) || j->n_after > 0;
+
+    insert_job(j, mode);
+
+    if (mode == BACKGROUND_EXECUTION)
+        forget_finished_job(j->id);
 
-    if (mode == FOREGROUND_EXECUTION)
+    if (queued)
     {
-        fprintf(stdout, KYEL"\n");
-        tcsetpgrp(STDIN_FILENO, pgid);
+        queue_job(j);
+        metrics.jobs_queued++;
+        dispatch_queue();
     }
+    else
+        start_job(j);
 
-    signal(SIGINT, SIG_DFL);
+    unblock_sigchld();
+}
+
+/* Solo el proceso que nombra una sustitucion como /dev/fd/N hereda su extremo del pipe */
+static void share_subst_fds(job *j, process *p, int share)
+{
+    char path[32];
+
+    for (job *s = j->substs; s; s = s->next)
+    {
+        snprintf(path, sizeof(path), "/dev/fd/%d", s->subst_fd);
+
+        for (int k = 1; k < p->argc; k++)
+            if (!strcmp(p->argv[k], path))
+                fcntl(s->subst_fd, F_SETFD, share ? 0 : FD_CLOEXEC);
+    }
+}
+
+static void start_job(job *j)
+{
+    EXECUTION_MODES mode = j->mode;
+    uint64_t t_launch = trace_begin();
+    int infile, outfile, errfile;
+    int i = 0;
+    int n_pipes;
+    int (*pipes)[2];
+    int out_pipe[2] = { -1, -1 };
+    int own_group = job_control_interactive || mode == BACKGROUND_EXECUTION;
+
+    block_sigchld();
+    j->start_time = get_monotonic_ns();
+
+    /* Una sustitucion de procesos es parte de su trabajo: sus procesos se cuentan, pero no es otro trabajo */
+    if (j->subst_fd < 0)
+        metrics_job_launched();
+
+    if (is_job_queued(j))
+        queued_jobs--;
+
+    /* Lo que los builtins dejaron en los buffers de stdio sale antes que el trabajo, y los hijos no lo heredan */
+    fflush(stdout);
+    fflush(stderr);
+
+    n_pipes = count_job_process(j) - 1;
+    pipes = malloc(sizeof(*pipes) * (n_pipes > 0 ? n_pipes : 1));
+
+    while (alloc_job_fds(j, pipes, n_pipes, out_pipe) < 0)
+    {
+        if (is_fd_exhausted(errno) && relieve_fd_pressure(j))
+            continue;
+
+        fprintf(stderr, KRED"\nCouldn't launch job: %s !\n\n"KDEF, strerror(errno));
+
+        for (process *p = j->first_process; p; p = p->next)
+        {
+            p->exit_code = EXIT_FAILURE;
+            set_process_status(p, STATUS_TERMINATED);
+        }
+
+        free(pipes);
+
+        if (mode == BACKGROUND_EXECUTION)
+            wait_track(j);
+
+        clean_done_job(SOURCE_WAIT);
+        unblock_sigchld();
+        return;
+    }
+
+    j->out_fd = out_pipe[0];
+
+    /* Las sustituciones se lanzan primero, en el mismo grupo de procesos, y el trabajo hereda su extremo del pipe */
+    for (job *s = j->substs; s; s = s->next)
+    {
+        s->mode = mode;
+        s->pgid = j->pgid;
+        start_job(s);
+        j->pgid = s->pgid;
+
+        if (s->stdin_fd >= 0)
+            close(s->stdin_fd);
+
+        if (s->stdout_fd >= 0)
+            close(s->stdout_fd);
+
+        s->stdin_fd = s->stdout_fd = -1;
+    }
+
+    for (process *p = j->first_process; p; p = p->next, i++)
+    {
+        if (p->input_path)
+            infile = open(p->input_path, O_RDONLY | O_CLOEXEC);
+        else if (i > 0)
+            infile = pipes[i - 1][0];
+        else if (j->stdin_fd >= 0)
+            infile = j->stdin_fd;
+        else if (mode == BACKGROUND_EXECUTION)
+            infile = job_null_input();
+        else
+            infile = STDIN_FILENO;
+
+        if (p->output_path)
+        {
+            if (*p->output_path == ASCII_LINE_BREAK)
+                outfile = -1;
+            else
+                outfile = open(p->output_path, O_CREAT|O_WRONLY|O_CLOEXEC, S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH);
+        }
+        else if (p->next)
+            outfile = pipes[i][1];
+        else if (j->stdout_fd >= 0)
+            outfile = j->stdout_fd;
+        else if (mode == BACKGROUND_EXECUTION && out_pipe[1] >= 0)
+            outfile = out_pipe[1];
+        else
+            outfile = STDOUT_FILENO;
+
+        if (p->merge_error)
+            errfile = outfile;
+        else if (p->error_path)
+        {
+            if (*p->error_path == ASCII_LINE_BREAK)
+                errfile = -1;
+            else
+                errfile = open(p->error_path, O_CREAT|O_WRONLY|O_CLOEXEC, S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH);
+        }
+        else if (j->mode == FOREGROUND_EXECUTION && !j->managed)
+            errfile = STDERR_FILENO;
+        else
+            errfile = job_error_channel();
+
+        if(infile < 0)
+        {
+            fprintf(stderr, KRED"\n%s: %s !\n"KDEF, p->input_path, strerror(errno));
+            p->exit_code = EXIT_FAILURE;
+            set_process_status(p, STATUS_TERMINATED);
+        }
+        else if(outfile < 0)
+        {
+            if (*p->output_path == ASCII_LINE_BREAK)
+                fprintf(stderr, KRED"\nParse error near '\\n' !\n"KDEF);
+            else
+                fprintf(stderr, KRED"\n%s: %s !\n"KDEF, p->output_path, strerror(errno));
+
+            p->exit_code = EXIT_FAILURE;
+            set_process_status(p, STATUS_TERMINATED);
+        }
+        else if(errfile < 0)
+        {
+            if (*p->error_path == ASCII_LINE_BREAK)
+                fprintf(stderr, KRED"\nParse error near '\\n' !\n"KDEF);
+            else
+                fprintf(stderr, KRED"\n%s: %s !\n"KDEF, p->error_path, strerror(errno));
+
+            p->exit_code = EXIT_FAILURE;
+            set_process_status(p, STATUS_TERMINATED);
+        }
+        else
+        {
+            set_process_status(p, STATUS_RUNNING);
+
+            int exec_status[2] = { -1, -1 };
+
+            if (pipe2(exec_status, O_CLOEXEC) == 0)
+                exec_status_fd = exec_status[1];
+
+            EXECUTION_MODES p_mode = p->next ? PIPELINE_EXECUTION : j->mode;
+
+            share_subst_fds(j, p, 1);
+            histogram *latency = &metrics.spawn_latency;
+            uint64_t t_fork = trace_begin();
+            uint64_t t_spawn = get_monotonic_ns();
+            pid_t pid = -1;
+
+            if (zygote_enabled() && exec_status[1] >= 0 && !j->substs && !p->runner)
+            {
+                pid = zygote_spawn(p, own_group ? j->pgid : -1, infile, outfile, errfile, exec_status[1], p_mode);
+
+                if (pid > 0)
+                    latency = &metrics.zygote_latency;
+                else if (errno != E2BIG)
+                {
+                    fprintf(stderr, KRED"\nzygote: %s, spawning directly !\n"KDEF, strerror(errno));
+                    zygote_stop();
+                }
+            }
+
+            if (pid < 0)
+                pid = fork ();
+
+            if (pid == 0)
+                launch_process(p, own_group ? j->pgid : -1, infile, outfile, errfile, p_mode);
+            else if (pid < 0)
+            {
+                perror(KRED"\nfork\n"KDEF);
+                exit (EXIT_FAILURE);
+            }
+            else
+            {
+                p->pid = pid;
+                metrics.processes_forked++;
+                trace_end_arg("fork", t_fork, pid);
+                
+                if (!j->pgid)
+                    j->pgid = pid;
+                
+                if (own_group)
+                    setpgid (pid, j->pgid);
+
+                wait_exec_status(exec_status, t_spawn, latency);
+                trace_end_arg("exec", t_fork, pid);
+            }
+
+            share_subst_fds(j, p, 0);
+        }
+
+        if (infile >= 0 && (p->input_path || i > 0))
+            close(infile);
+
+        if (outfile >= 0 && outfile != STDOUT_FILENO && outfile != out_pipe[1] && outfile != j->stdout_fd)
+            close(outfile);
+
+        if (errfile >= 0 && p->error_path && !p->merge_error)
+            close(errfile);
+
+        if (p->input_path && i > 0)
+            close(pipes[i - 1][0]);
+
+        if (p->output_path && p->next)
+            close(pipes[i][1]);
+    }
+
+    if (out_pipe[1] >= 0)
+        close(out_pipe[1]);
+
+    for (job *s = j->substs; s; s = s->next)
+    {
+        close(s->subst_fd);
+        s->subst_fd = -1;
+    }
+
+    free(pipes);
+
+    trace_end_arg("launch_job", t_launch, j->id);
+
+    job_shm_publish(j, NULL);
+
+    /* Una sustitucion se espera y se remueve junto al trabajo que la contiene */
+    if (j->subst_fd >= 0)
+    {
+        unblock_sigchld();
+        return;
+    }
+
+    if (j->mode == BACKGROUND_EXECUTION)
+        wait_track(j);
+
+    if (j->mode == FOREGROUND_EXECUTION && j->pgid)
+    {
+        if (job_control_interactive)
+            tcsetpgrp(STDIN_FILENO, j->pgid);
+
+        wait_for_job(j, 1);
+
+        if (job_control_interactive)
+            tcsetpgrp(STDIN_FILENO, getpid());
+
+        last_exit_status = get_job_exit_code(j);
+        clean_done_job(SOURCE_FOREGROUND_EXECUTION);
+    }
+    else if (j->mode == BACKGROUND_EXECUTION && j->pgid)
+    {
+        if (!j->managed)
+            print_job_process(j);
+    }
+    else
+        clean_done_job(SOURCE_FOREGROUND_EXECUTION);
+
+    unblock_sigchld();
+}
+
+void launch_process(process *p, pid_t pgid, int in_fd, int out_fd, int err_fd, EXECUTION_MODES mode) 
+{
+    pid_t childpid = getpid ();
+
+    if (pgid == 0)
+        pgid = childpid;
+    
+    if (pgid > 0)
+        setpgid(childpid, pgid);
+
+    if (mode == FOREGROUND_EXECUTION && pgid > 0)
+    {
+        fprintf(stdout, KYEL"\n");
+        tcsetpgrp(STDIN_FILENO, pgid);
+    }
+
+    signal(SIGINT, SIG_DFL);
     signal(SIGQUIT, SIG_DFL);
     signal(SIGTSTP, SIG_DFL);
     signal(SIGTTIN, SIG_DFL);
     signal(SIGTTOU, SIG_DFL);
+
+    sigset_t set;
+    sigemptyset(&set);
+    sigprocmask(SIG_SETMASK, &set, NULL);
     
     if (in_fd != STDIN_FILENO)
     {
@@ -345,47 +1020,626 @@ void launch_process(process *p, pid_t pgid, int in_fd, int out_fd, int err_fd, E
         close(out_fd);
     }
 
-    if (err_fd != STDERR_FILENO)
+    if (err_fd == out_fd)
+        dup2(STDOUT_FILENO, STDERR_FILENO);
+    else if (err_fd != STDERR_FILENO)
     {
         dup2(err_fd, STDERR_FILENO);
         close(err_fd);
     }
 
+    /* El proceso de reparto no ejecuta ningun programa: se informa a la shell como si exec hubiera tenido exito */
+    if (is_fanout_process(p))
+    {
+        if (exec_status_fd >= 0)
+            close(exec_status_fd);
+
+        run_fanout(p);
+    }
+
+    /* El proceso interno ejecuta la linea en esta copia de la shell, sin exec, y finaliza con su codigo */
+    if (p->runner)
+    {
+        if (exec_status_fd >= 0)
+            close(exec_status_fd);
+
+        signal(SIGTERM, SIG_DFL);
+        signal(SIGPIPE, SIG_DFL);
+
+        job_control_detach();
+        exit(p->runner(p->argv[1]));
+    }
+
+    restore_fd_limit();
+
+    /* execvp busca el programa con el PATH de environ, que pasa a ser el del comando */
+    environ = p->env ? env_block_with(p->env) : env_block();
+
     if (execvp(p->argv[0], p->argv) < 0) 
     {
+        int err = errno;
+
+        if (exec_status_fd >= 0)
+            write(exec_status_fd, &err, sizeof(err));
+
         fprintf(stderr, "Command not found!\n");
-        exit(EXIT_FAILURE);
+        _exit(EXIT_FAILURE);
     }
     
     exit(EXIT_SUCCESS);
 }
 
+void wait_exec_status(int exec_status[2], uint64_t t_spawn, histogram *latency)
+{
+    int err;
+    ssize_t n;
+
+    exec_status_fd = -1;
+
+    if (exec_status[0] < 0)
+        return;
+
+    close(exec_status[1]);
+
+    while ((n = read(exec_status[0], &err, sizeof(err))) < 0 && errno == EINTR);
+
+    if (n == sizeof(err))
+        metrics.exec_failures++;
+    else
+        histogram_record(latency, get_monotonic_ns() - t_spawn);
+
+    close(exec_status[0]);
+}
+
 void reanude_job_fg(int id_job)
 {
     job* j = get_job_by_id(id_job);
 
     if (!j)
         fprintf(stderr, KRED"\nJob not found!\n\n"KDEF);
+    else if (is_job_queued(j))
+    {
+        block_sigchld();
+
+        j->mode = FOREGROUND_EXECUTION;
+        start_job(j);
+
+        unblock_sigchld();
+    }
     else
     {
-        if (kill(-j->pgid, SIGCONT) < 0)
+        if (j->pgid <= 0 || kill(-j->pgid, SIGCONT) < 0)
             fprintf(stderr, KRED"\nJob not found!\n\n"KDEF);
         else
         {
-            tcsetpgrp(STDIN_FILENO, j->pgid);
+            block_sigchld();
+
+            if (job_control_interactive)
+                tcsetpgrp(STDIN_FILENO, j->pgid);
+
             wait_for_job(j, 1);
-            tcsetpgrp(STDIN_FILENO, getpid());
 
+            if (job_control_interactive)
+                tcsetpgrp(STDIN_FILENO, getpid());
+
+            last_exit_status = get_job_exit_code(j);
             clean_done_job(SOURCE_REANUDE_FG);
+
+            unblock_sigchld();
+        }
+    }
+}
+
+void reanude_job_bg(int id_job)
+{
+    job* j = get_job_by_id(id_job);
+
+    if (!j)
+        fprintf(stderr, KRED"\nJob not found!\n\n"KDEF);
+    else if (is_job_queued(j))
+    {
+        block_sigchld();
+        start_job(j);
+        unblock_sigchld();
+    }
+    else if (!is_job_stoped(j))
+        fprintf(stderr, KRED"\nJob is already running!\n\n"KDEF);
+    else
+    {
+        block_sigchld();
+
+        j->mode = BACKGROUND_EXECUTION;
+
+        if (kill(-j->pgid, SIGCONT) < 0)
+            fprintf(stderr, KRED"\nJob not found!\n\n"KDEF);
+        else
+            print_job_process(j);
+
+        unblock_sigchld();
+    }
+}
+
+static void wait_interrupt_handler()
+{
+    wait_interrupted = 1;
+}
+
+static wait_source* new_wait_source(job_waiter *w, job *j, process *p, int fd)
+{
+    wait_source *src = malloc(sizeof(wait_source));
+    struct epoll_event ev = {
+        .events = EPOLLIN,
+        .data.ptr = src
+    };
+
+    src->fd = fd;
+    src->j = j;
+    src->p = p;
+
+    if (epoll_ctl(w->epfd, EPOLL_CTL_ADD, fd, &ev) < 0)
+    {
+        free(src);
+        return NULL;
+    }
+
+    if (j)
+    {
+        src->next = j->sources;
+        j->sources = src;
+    }
+    else
+    {
+        src->next = NULL;
+        w->channel = src;
+    }
+
+    return src;
+}
+
+static void free_wait_sources(job *j)
+{
+    wait_source *src = j->sources;
+
+    while (src)
+    {
+        wait_source *aux = src;
+        src = src->next;
+
+        if (aux->p && aux->p->pidfd >= 0)
+        {
+            close(aux->p->pidfd);
+            aux->p->pidfd = -1;
+        }
+
+        free(aux);
+    }
+
+    j->sources = NULL;
+}
+
+/* Lee una porcion de la salida capturada de j. Retorna lo que retorno read, 0 si la salida ya estaba cerrada */
+static ssize_t read_job_chunk(job *j)
+{
+    static char buffer[JOB_OUTPUT_CHUNK];
+    ssize_t n;
+
+    if (j->out_fd < 0)
+        return 0;
+
+    if ((n = read(j->out_fd, buffer, sizeof(buffer))) > 0)
+        append_job_buffer(&j->out, buffer, n);
+    else if (n == 0)
+    {
+        close(j->out_fd);
+        release_capture_fd();
+        j->out_fd = -1;
+    }
+
+    return n;
+}
+
+static void read_job_output(job *j)
+{
+    while (read_job_chunk(j) > 0);
+}
+
+int job_waiter_init(job_waiter *w)
+{
+    struct sigaction interrupt_action = {
+        .sa_handler = wait_interrupt_handler,
+        .sa_flags = 0
+    };
+
+    block_sigchld();
+
+    w->pending = 0;
+    w->channel = NULL;
+
+    if ((w->epfd = epoll_create1(EPOLL_CLOEXEC)) < 0)
+    {
+        unblock_sigchld();
+        return -1;
+    }
+
+    if (job_error_reader() >= 0)
+        new_wait_source(w, NULL, NULL, job_error_reader());
+
+    wait_interrupted = 0;
+    sigemptyset(&interrupt_action.sa_mask);
+    sigaction(SIGINT, &interrupt_action, &w->old_action);
+
+    return 0;
+}
+
+/* Registra los procesos de j y de sus sustituciones como fuentes del trabajo owner */
+static int add_wait_processes(job_waiter *w, job *owner, job *j)
+{
+    int pending = 0;
+
+    for (process *p = j->first_process; p; p = p->next)
+    {
+        if (is_process_completed(p) || p->pid <= 0)
+            continue;
+
+        int pidfd = syscall(SYS_pidfd_open, p->pid, 0);
+
+        if (pidfd < 0)
+        {
+            int status;
+            int options = errno == ESRCH ? WNOHANG : 0;
+            pid_t pid;
+
+            while ((pid = wait4(p->pid, &status, options, &p->usage)) < 0 && errno == EINTR);
+
+            if (pid == p->pid)
+                update_process_status(p, status);
+            else if (pid < 0 && errno == ECHILD)
+                set_process_status(p, STATUS_DONE);
+
+            continue;
+        }
+
+        if (!new_wait_source(w, owner, p, pidfd))
+        {
+            close(pidfd);
+            continue;
+        }
+
+        p->pidfd = pidfd;
+        pending++;
+    }
+
+    for (job *s = j->substs; s; s = s->next)
+        pending += add_wait_processes(w, owner, s);
+
+    return pending;
+}
+
+int job_waiter_add(job_waiter *w, job *j)
+{
+    int pending;
+
+    j->waited = 1;
+    pending = add_wait_processes(w, j, j);
+
+    if (j->out_fd >= 0 && pending)
+        new_wait_source(w, j, NULL, j->out_fd);
+
+    if (is_job_completed(j))
+    {
+        free_wait_sources(j);
+        read_job_output(j);
+        j->waited = 0;
+        return 1;
+    }
+
+    if (!pending)
+    {
+        free_wait_sources(j);
+        j->waited = 0;
+        return -1;
+    }
+
+    w->pending++;
+
+    return 0;
+}
+
+static job* job_waiter_wait(job_waiter *w, int timeout)
+{
+    struct epoll_event ev;
+
+    while ((w->pending > 0 || !timeout) && !wait_interrupted)
+    {
+        int ready = epoll_wait(w->epfd, &ev, 1, timeout);
+
+        if (ready == 0)
+            return NULL;
+
+        if (ready < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            fprintf(stderr, KRED"\nepoll: %s !\n\n"KDEF, strerror(errno));
+            return NULL;
+        }
+
+        wait_source *src = ev.data.ptr;
+        job *j = src->j;
+
+        if (!j)
+        {
+            drain_job_output();
+            continue;
+        }
+
+        /* Se lee una porcion por evento, para que un trabajo que escribe sin pausa no acapare la espera. Sin
+           bloquear, se vuelve al llamador para que entregue la salida antes de seguir leyendo */
+        if (!src->p)
+        {
+            read_job_chunk(j);
+
+            if (j->out_fd < 0)
+                src->fd = -1;
+
+            if (!timeout)
+                return NULL;
+
+            continue;
+        }
+
+        int status;
+        process *p = src->p;
+
+        if (wait4(p->pid, &status, WNOHANG, &p->usage) == p->pid)
+            update_process_status(p, status);
+
+        if (!is_process_completed(p))
+            continue;
+
+        epoll_ctl(w->epfd, EPOLL_CTL_DEL, p->pidfd, NULL);
+        close(p->pidfd);
+        p->pidfd = -1;
+
+        if (is_job_completed(j))
+        {
+            if (j->out_fd >= 0)
+                epoll_ctl(w->epfd, EPOLL_CTL_DEL, j->out_fd, NULL);
+
+            free_wait_sources(j);
+            read_job_output(j);
+            drain_job_output();
+
+            j->waited = 0;
+            w->pending--;
+
+            return j;
+        }
+    }
+
+    return NULL;
+}
+
+job* job_waiter_next(job_waiter *w)
+{
+    return job_waiter_wait(w, -1);
+}
+
+job* job_waiter_poll(job_waiter *w)
+{
+    return job_waiter_wait(w, 0);
+}
+
+void job_waiter_throttle(job_waiter *w, job *j, int paused)
+{
+    for (wait_source *src = j->sources; src; src = src->next)
+    {
+        if (src->p || src->fd < 0)
+            continue;
+
+        struct epoll_event ev = {
+            .events = paused ? 0 : EPOLLIN,
+            .data.ptr = src
+        };
+
+        epoll_ctl(w->epfd, EPOLL_CTL_MOD, src->fd, &ev);
+    }
+}
+
+int job_waiter_interrupted(job_waiter *w)
+{
+    return wait_interrupted;
+}
+
+void job_waiter_close(job_waiter *w)
+{
+    sigaction(SIGINT, &w->old_action, NULL);
+
+    for (job *j = first_job; j; j = j->next)
+    {
+        if (!j->waited)
+            continue;
+
+        if (j->out_fd >= 0)
+            epoll_ctl(w->epfd, EPOLL_CTL_DEL, j->out_fd, NULL);
+
+        free_wait_sources(j);
+        j->waited = 0;
+    }
+
+    free(w->channel);
+    close(w->epfd);
+
+    unblock_sigchld();
+}
+
+void abort_managed_job(job *j)
+{
+    int status;
+
+    if (j->pgid > 0)
+        kill(-j->pgid, SIGKILL);
+
+    for (process *p = j->first_process; p; p = p->next)
+        if (p->pid > 0 && !is_process_completed(p))
+            while (waitpid(p->pid, &status, 0) < 0 && errno == EINTR);
+
+    if (j->out_fd >= 0)
+    {
+        close(j->out_fd);
+        release_capture_fd();
+        j->out_fd = -1;
+    }
+
+    metrics_job_reaped(get_monotonic_ns() - j->start_time);
+    remove_job(j);
+}
+
+static void wait_account(job *j, int finished)
+{
+    if (finished)
+    {
+        wait_result = get_job_exit_code(j);
+        wait_finished++;
+    }
+
+    wait_remaining--;
+    j->wait_target = 0;
+}
+
+/* Agrega a la espera en curso un trabajo en segundo plano. Si ya finalizo o no puede esperarse y era esperado, se cuenta */
+static void wait_track(job *j)
+{
+    if (!active_wait || j->managed || j->waited)
+        return;
+
+    int added = job_waiter_add(active_wait, j);
+
+    if (j->wait_target && added != 0)
+        wait_account(j, added > 0);
+}
+
+int wait_jobs(int *ids, int n, int any)
+{
+    uint64_t t_wait = trace_begin();
+    job_waiter w;
+
+    if (job_waiter_init(&w) < 0)
+    {
+        fprintf(stderr, KRED"\nepoll: %s !\n\n"KDEF, strerror(errno));
+        return 1;
+    }
+
+    wait_result = wait_finished = wait_remaining = 0;
+
+    for (job *j = first_job; j; j = j->next)
+        j->waited = j->wait_target = 0;
+
+    if (!ids)
+    {
+        for (job *j = first_job; j; j = j->next)
+            if (!j->managed && (!is_job_stoped(j) || is_job_completed(j)))
+                j->wait_target = 1;
+    }
+    else
+    {
+        for (int i = 0; i < n; i++)
+        {
+            job *j = get_job_by_id(ids[i]);
+            int exit_code;
+
+            if (!j && get_finished_job(ids[i], &exit_code))
+            {
+                wait_result = exit_code;
+                wait_finished++;
+            }
+            else if (!j)
+            {
+                fprintf(stderr, KRED"\nJob %d not found!\n\n"KDEF, ids[i]);
+                wait_result = 127;
+            }
+            else
+                j->wait_target = 1;
+        }
+    }
+
+    /* Los trabajos que no son esperados igual se registran si hay encolados, porque al finalizar les dejan lugar.
+       Desde aca, cada trabajo que se lanza o se cancela al atender la cola se agrega a la espera (wait_track) */
+    int queued = queued_jobs > 0;
+
+    active_wait = &w;
+
+    for (job *j = first_job; j; j = j->next)
+    {
+        if (j->wait_target && is_job_completed(j))
+        {
+            wait_result = get_job_exit_code(j);
+            wait_finished++;
+            j->wait_target = 0;
+            continue;
         }
+
+        if (j->wait_target)
+            wait_remaining++;
+
+        if (j->managed || is_job_queued(j) || is_job_completed(j) || (!j->wait_target && !queued))
+            continue;
+
+        if (!j->wait_target && (j->mode != BACKGROUND_EXECUTION || is_job_stoped(j)))
+            continue;
+
+        wait_track(j);
+    }
+
+    dispatch_queue();
+
+    while (wait_remaining > 0 && !(any && wait_finished))
+    {
+        job *j = job_waiter_next(&w);
+
+        if (!j)
+            break;
+
+        if (j->wait_target)
+            wait_account(j, 1);
+
+        /* El trabajo se remueve apenas finaliza y su lugar en la cola queda libre para los encolados */
+        remove_done_job(j, SOURCE_WAIT);
+        dispatch_queue();
     }
+
+    active_wait = NULL;
+
+    if (job_waiter_interrupted(&w))
+        wait_result = 128 + SIGINT;
+
+    last_exit_status = wait_result;
+    clean_done_job(SOURCE_WAIT);
+
+    job_waiter_close(&w);
+
+    trace_end("wait_jobs", t_wait);
+
+    return wait_result;
 }
 
 void kill_all_jobs()
 {
-    job *j = first_job;
+    job *j;
     job *aux;
 
+    block_sigchld();
+
+    for (j = first_job; j; j = j->next)
+        if (is_job_queued(j))
+            cancel_queued_job(j, 128 + SIGKILL);
+
+    clean_done_job(SOURCE_KILL);
+    unblock_sigchld();
+
+    j = first_job;
+
     while (j)
     {
         aux = j;
@@ -400,43 +1654,197 @@ void kill_job(int id_job)
 
     if (!j)
         fprintf(stderr, KRED"\nJob not found!\n\n"KDEF);
+    else if (is_job_queued(j))
+    {
+        block_sigchld();
+        cancel_queued_job(j, 128 + SIGKILL);
+        clean_done_job(SOURCE_KILL);
+        unblock_sigchld();
+    }
     else
     {
-        if (kill(-j->pgid, SIGKILL) < 0)
+        if (j->pgid <= 0 || kill(-j->pgid, SIGKILL) < 0)
             fprintf(stderr, KRED"\nJob not found!\n\n"KDEF);
         else
         {
+            block_sigchld();
             wait_for_job(j, 0);
             clean_done_job(SOURCE_KILL);
+            unblock_sigchld();
         }
     }
 }
 
 void print_job_all_status(void)
 {
-    fprintf(stdout, "\n");
+    jobs_query q = { PROC_FILTER_ALL, 0, 0, 0 };
+
+    print_jobs(&q);
+}
 
-    for (job* j = first_job; j; j = j->next)
+int match_process_filter(process *p, PROCESS_FILTERS filter)
+{
+    switch (filter)
     {
-        print_job_status(j);
-        fprintf(stdout, "\n");
+        case PROC_FILTER_DONE:
+            return is_process_completed(p);
+
+        case PROC_FILTER_REMAINING:
+            return !is_process_completed(p);
+
+        case PROC_FILTER_RUNNING:
+            return is_process_running(p);
+
+        case PROC_FILTER_STOPPED:
+            return p->status == STATUS_SUSPENDED;
+
+        default:
+            return 1;
     }
+}
 
-    fprintf(stdout, "\n");
+static int match_query(process *p, const jobs_query *q)
+{
+    return match_process_filter(p, q->filter) && p->changed >= q->since;
 }
 
-void print_job_status(job *j) 
+static void append_job_status(job_buffer *out, job *j)
 {
-    fprintf(stdout, KBLU"[%d]"KDEF, j->id);
+    append_job_format(out, KBLU"[%d]"KDEF, j->id);
 
     for (process* p = j->first_process; p; p = p->next) {
-        fprintf(stdout, KBLU" %d %s %s"KDEF, p->pid, PROCESS_STATUS_STRING[p->status], p->argv[0]);
+        append_job_format(out, KBLU" %d %s %s"KDEF, p->pid, PROCESS_STATUS_STRING[p->status], p->argv[0]);
 
         if (p->next)
-            fprintf(stdout, KBLU" |\n   "KDEF); 
+            append_job_format(out, KBLU" |\n   "KDEF);
+    }
+
+    if (is_job_queued(j) && j->n_after)
+    {
+        append_job_format(out, KBLU" (after"KDEF);
+
+        for (int i = 0; i < j->n_after; i++)
+            append_job_format(out, KBLU" %%%d"KDEF, j->after[i]);
+
+        append_job_format(out, KBLU")"KDEF);
     }
 }
 
+static void append_json_string(job_buffer *out, const char *s)
+{
+    append_job_buffer(out, "\"", 1);
+
+    for (; *s; s++)
+    {
+        if (*s == '"' || *s == '\\')
+            append_job_format(out, "\\%c", *s);
+        else if ((unsigned char)*s < 0x20)
+            append_job_format(out, "\\u%04x", (unsigned char)*s);
+        else
+            append_job_buffer(out, s, 1);
+    }
+
+    append_job_buffer(out, "\"", 1);
+}
+
+static void append_json_job(job_buffer *out, job *j)
+{
+    static const char* modes[] = { "background", "foreground", "pipeline", "badmode" };
+
+    append_job_format(out, "{\"id\":%d,\"pgid\":%d,\"mode\":\"%s\",\"start_time\":%llu,\"after\":[",
+                      j->id, j->pgid, modes[j->mode], (unsigned long long)j->start_time);
+
+    for (int i = 0; i < j->n_after; i++)
+        append_job_format(out, i ? ",%d" : "%d", j->after[i]);
+
+    append_job_format(out, "],\"processes\":[");
+
+    for (process *p = j->first_process; p; p = p->next)
+    {
+        append_job_format(out, "{\"pid\":%d,\"status\":\"%s\",\"exit_code\":%d,\"changed\":%llu,"
+                          "\"utime_us\":%llu,\"stime_us\":%llu,\"maxrss_kb\":%ld,\"argv\":[",
+                          p->pid, PROCESS_STATUS_STRING[p->status], p->exit_code, (unsigned long long)p->changed,
+                          (unsigned long long)p->usage.ru_utime.tv_sec * 1000000ULL + p->usage.ru_utime.tv_usec,
+                          (unsigned long long)p->usage.ru_stime.tv_sec * 1000000ULL + p->usage.ru_stime.tv_usec,
+                          p->usage.ru_maxrss);
+
+        for (int i = 0; i < p->argc; i++)
+        {
+            if (i)
+                append_job_buffer(out, ",", 1);
+
+            append_json_string(out, p->argv[i]);
+        }
+
+        append_job_format(out, p->next ? "]}," : "]}");
+    }
+
+    append_job_format(out, "]}");
+}
+
+void print_jobs(const jobs_query *q)
+{
+    job_buffer out = { NULL, 0, 0 };
+    int listed = 0;
+
+    block_sigchld();
+
+    if (q->json)
+        append_job_format(&out, "{\"now\":%llu,\"%s\":[", (unsigned long long)get_monotonic_ns(), q->pids_only ? "pids" : "jobs");
+    else if (!q->pids_only)
+        append_job_format(&out, "\n");
+
+    for (job *j = first_job; j; j = j->next)
+    {
+        process *p;
+
+        for (p = j->first_process; p && !match_query(p, q); p = p->next);
+
+        if (!p)
+            continue;
+
+        /* Un proceso que todavia no se creo no tiene PID: un -1 en 'kill $(jobs -p)' alcanzaria a todos */
+        if (q->pids_only)
+        {
+            for (; p; p = p->next)
+                if (p->pid > 0 && match_query(p, q))
+                    append_job_format(&out, q->json ? (listed++ ? ",%d" : "%d") : "%d\n", p->pid);
+        }
+        else if (q->json)
+        {
+            if (listed++)
+                append_job_buffer(&out, ",", 1);
+
+            append_json_job(&out, j);
+        }
+        else
+        {
+            append_job_status(&out, j);
+            append_job_format(&out, "\n");
+        }
+    }
+
+    unblock_sigchld();
+
+    if (q->json)
+        append_job_format(&out, "]}\n");
+    else if (!q->pids_only)
+        append_job_format(&out, "\n");
+
+    fflush(stdout);
+    write_job_buffer(STDOUT_FILENO, &out);
+    free(out.data);
+}
+
+void print_job_status(job *j) 
+{
+    job_buffer out = { NULL, 0, 0 };
+
+    append_job_status(&out, j);
+    fprintf(stdout, "%.*s", (int)out.len, out.data);
+    free(out.data);
+}
+
 void print_job_process(job *j) 
 {
     fprintf(stdout, KBLU"\n[%d]"KDEF, j->id);
@@ -454,32 +1862,39 @@ void print_job_process(job *j)
 
 void print_job_pipe(job *j)
 {
-    close(j->io_fd[1]);
-    close(j->err_fd[1]);
+    int w = 0;
 
-    fcntl(j->io_fd[0], F_SETFL, fcntl(j->io_fd[0], F_GETFL) | O_NONBLOCK);
-    fcntl(j->err_fd[0], F_SETFL, fcntl(j->err_fd[0], F_GETFL) | O_NONBLOCK);
+    drain_job_output();
 
-    fprintf(stdout, "\n");
+    if (j->out_fd >= 0)
+    {
+        read_job_output(j);
 
-    char c; int w = 0;
-    while (read(j->err_fd[0], &c, sizeof(c)) > 0)
+        if (j->out_fd >= 0)
+        {
+            close(j->out_fd);
+            release_capture_fd();
+            j->out_fd = -1;
+        }
+    }
+
+    if (job_control_interactive)
+        fprintf(stdout, "\n");
+
+    if (j->err.len)
     {
-        fprintf(stdout, KRED"%c"KDEF, c);
+        fprintf(stdout, KRED"%.*s"KDEF, (int)j->err.len, j->err.data);
         w = 1;
     }
-           
-    while (read(j->io_fd[0], &c, sizeof(c)) > 0)
+
+    if (j->out.len)
     {
-        fprintf(stdout, KYEL"%c"KDEF, c);
+        fprintf(stdout, KYEL"%.*s"KDEF, (int)j->out.len, j->out.data);
         w = 1;
     }
 
-    close(j->io_fd[0]);
-    close(j->err_fd[0]);
-
     flag_work_tube_printed = 1;
 
-    if(w)
+    if(w && job_control_interactive)
         fprintf(stdout, "\n");
-}
\ No newline at end of file
+}
@@ -0,0 +1,285 @@
+/**
+ * @file JobCoproc.c
+ * @author Bottini, Franco Nicolas.
+ * @brief Implementacion de los coprocesos.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../../inc/Job/JobCoproc.h"
+
+static coproc *coprocs = NULL;
+static volatile sig_atomic_t read_interrupted = 0;
+
+static void read_interrupt_handler()
+{
+    read_interrupted = 1;
+}
+
+coproc* coproc_find(const char *name)
+{
+    if (!name)
+        name = COPROC_DEFAULT_NAME;
+
+    for (coproc *c = coprocs; c; c = c->next)
+        if (!strcmp(c->name, name))
+            return c;
+
+    return NULL;
+}
+
+coproc* coproc_start(const char *name, char *command, job_builder builder)
+{
+    int in_pipe[2], out_pipe[2];
+
+    if (!name)
+        name = COPROC_DEFAULT_NAME;
+
+    if (coproc_find(name))
+    {
+        fprintf(stderr, KRED"\ncoproc %s already exists !\n\n"KDEF, name);
+        return NULL;
+    }
+
+    job *j = builder(command);
+
+    if (!j->first_process)
+    {
+        free_job(j);
+        return NULL;
+    }
+
+    if (pipe2(in_pipe, O_CLOEXEC) < 0)
+    {
+        fprintf(stderr, KRED"\ncoproc: %s !\n\n"KDEF, strerror(errno));
+        free_job(j);
+        return NULL;
+    }
+
+    if (pipe2(out_pipe, O_CLOEXEC) < 0)
+    {
+        fprintf(stderr, KRED"\ncoproc: %s !\n\n"KDEF, strerror(errno));
+        close(in_pipe[0]);
+        close(in_pipe[1]);
+        free_job(j);
+        return NULL;
+    }
+
+    j->stdin_fd = in_pipe[0];
+    j->stdout_fd = out_pipe[1];
+
+    /* Mientras es administrado, el trabajo no se remueve del listado aunque falle, y se puede consultar */
+    block_sigchld();
+
+    j->managed = 1;
+    launch_job(j, BACKGROUND_EXECUTION);
+    j->managed = 0;
+
+    close(in_pipe[0]);
+    close(out_pipe[1]);
+
+    if (!j->pgid || is_job_completed(j))
+    {
+        clean_done_job(SOURCE_WAIT);
+        unblock_sigchld();
+
+        close(in_pipe[1]);
+        close(out_pipe[0]);
+
+        return NULL;
+    }
+
+    coproc *c = calloc(1, sizeof(coproc));
+
+    c->name = strdup(name);
+    c->id = j->id;
+    c->pgid = j->pgid;
+    c->write_fd = in_pipe[1];
+    c->read_fd = out_pipe[0];
+    c->next = coprocs;
+    coprocs = c;
+
+    print_job_process(j);
+    fprintf(stdout, KBLU"coproc %s: write fd %d, read fd %d"KDEF"\n\n", c->name, c->write_fd, c->read_fd);
+
+    unblock_sigchld();
+
+    return c;
+}
+
+int coproc_write(coproc *c, const char *data, size_t len)
+{
+    struct sigaction ignore = { .sa_handler = SIG_IGN }, old;
+    int result = 0;
+
+    if (c->write_fd < 0)
+    {
+        errno = EPIPE;
+        return -1;
+    }
+
+    sigemptyset(&ignore.sa_mask);
+    sigaction(SIGPIPE, &ignore, &old);
+
+    while (len > 0)
+    {
+        ssize_t n = write(c->write_fd, data, len);
+
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            result = -1;
+            break;
+        }
+
+        data += n;
+        len -= n;
+    }
+
+    sigaction(SIGPIPE, &old, NULL);
+
+    return result;
+}
+
+static int take_line(coproc *c, job_buffer *line)
+{
+    char *end = memchr(c->pending.data, ASCII_LINE_BREAK, c->pending.len);
+
+    if (!end)
+        return 0;
+
+    size_t len = end - c->pending.data;
+
+    line->len = 0;
+    append_job_buffer(line, c->pending.data, len);
+
+    c->pending.len -= len + 1;
+    memmove(c->pending.data, end + 1, c->pending.len);
+
+    return 1;
+}
+
+int coproc_read_line(coproc *c, job_buffer *line, int timeout_ms)
+{
+    static char buffer[JOB_OUTPUT_CHUNK];
+    struct sigaction interrupt_action = { .sa_handler = read_interrupt_handler }, old;
+    uint64_t deadline = timeout_ms < 0 ? 0 : get_monotonic_ns() + (uint64_t)timeout_ms * 1000000;
+    int result = -1;
+
+    if (c->pending.len && take_line(c, line))
+        return 1;
+
+    read_interrupted = 0;
+    sigemptyset(&interrupt_action.sa_mask);
+    sigaction(SIGINT, &interrupt_action, &old);
+
+    while (!read_interrupted)
+    {
+        struct pollfd pfd = { .fd = c->read_fd, .events = POLLIN };
+        int wait = -1;
+
+        if (deadline)
+        {
+            uint64_t now = get_monotonic_ns();
+
+            if (now >= deadline)
+                break;
+
+            wait = (deadline - now + 999999) / 1000000;
+        }
+
+        int ready = poll(&pfd, 1, wait);
+
+        if (ready < 0 && errno == EINTR)
+            continue;
+
+        if (ready <= 0)
+            break;
+
+        ssize_t n = read(c->read_fd, buffer, sizeof(buffer));
+
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        if (n < 0)
+            break;
+
+        if (n == 0)
+        {
+            result = 0;
+
+            if (c->pending.len)
+            {
+                line->len = 0;
+                append_job_buffer(line, c->pending.data, c->pending.len);
+                c->pending.len = 0;
+                result = 1;
+            }
+
+            break;
+        }
+
+        append_job_buffer(&c->pending, buffer, n);
+
+        if (take_line(c, line))
+        {
+            result = 1;
+            break;
+        }
+    }
+
+    sigaction(SIGINT, &old, NULL);
+
+    return result;
+}
+
+void coproc_close_input(coproc *c)
+{
+    if (c->write_fd >= 0)
+        close(c->write_fd);
+
+    c->write_fd = -1;
+}
+
+void coproc_free(coproc *c)
+{
+    coproc **link = &coprocs;
+
+    while (*link && *link != c)
+        link = &(*link)->next;
+
+    if (*link)
+        *link = c->next;
+
+    coproc_close_input(c);
+    close(c->read_fd);
+    free(c->pending.data);
+    free(c->name);
+    free(c);
+}
+
+void coproc_free_all(void)
+{
+    while (coprocs)
+        coproc_free(coprocs);
+}
+
+void print_coprocs(void)
+{
+    fprintf(stdout, "\n");
+
+    for (coproc *c = coprocs; c; c = c->next)
+    {
+        job *j = get_job_by_id(c->id);
+
+        fprintf(stdout, KBLU"%s [%d] %s, write fd %d, read fd %d"KDEF"\n",
+                c->name, c->id, j && j->pgid == c->pgid && !is_job_completed(j) ? "running" : "exited", c->write_fd, c->read_fd);
+    }
+
+    fprintf(stdout, "\n");
+}
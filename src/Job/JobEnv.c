@@ -0,0 +1,339 @@
+/**
+ * @file JobEnv.c
+ * @author Bottini, Franco Nicolas.
+ * @brief Implementacion de la tabla de variables y del bloque de entorno de los procesos hijos.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../../inc/Job/JobEnv.h"
+
+extern char **environ;
+
+static env_var **table = NULL;
+static size_t table_cap = 0;
+static size_t table_used = 0;
+static size_t n_exported = 0;
+static char **block = NULL;
+static int block_dirty = 1;
+
+static uint64_t hash_name(const char *name, size_t len)
+{
+    uint64_t h = 1469598103934665603ULL;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        h ^= (unsigned char)name[i];
+        h *= 1099511628211ULL;
+    }
+
+    return h;
+}
+
+static int valid_name(const char *name)
+{
+    const char *s = name;
+
+    if (!(isalpha((unsigned char)*s) || *s == '_'))
+        return 0;
+
+    while (isalnum((unsigned char)*s) || *s == '_')
+        s++;
+
+    return *s == '\0';
+}
+
+size_t env_assignment(const char *word)
+{
+    size_t len = 0;
+
+    if (!word || !(isalpha((unsigned char)*word) || *word == '_'))
+        return 0;
+
+    while (isalnum((unsigned char)word[len]) || word[len] == '_')
+        len++;
+
+    return word[len] == '=' ? len : 0;
+}
+
+static void load_environ(void);
+
+/* Retorna el enlace que apunta a la variable, o al final de su lista si no existe */
+static env_var** find_link(const char *name, size_t len)
+{
+    if (!table)
+        load_environ();
+
+    env_var **link = &table[hash_name(name, len) & (table_cap - 1)];
+
+    while (*link && ((*link)->name_len != len || memcmp((*link)->entry, name, len)))
+        link = &(*link)->next;
+
+    return link;
+}
+
+static void grow_table(void)
+{
+    size_t cap = table_cap * 2;
+    env_var **slots = calloc(cap, sizeof(env_var*));
+
+    for (size_t i = 0; i < table_cap; i++)
+    {
+        env_var *v = table[i];
+
+        while (v)
+        {
+            env_var *next = v->next;
+            size_t slot = hash_name(v->entry, v->name_len) & (cap - 1);
+
+            v->next = slots[slot];
+            slots[slot] = v;
+            v = next;
+        }
+    }
+
+    free(table);
+    table = slots;
+    table_cap = cap;
+}
+
+static void set_exported(env_var *v, int exported)
+{
+    if (v->exported == exported)
+        return;
+
+    v->exported = exported;
+    n_exported += exported ? 1 : -1;
+    block_dirty = 1;
+}
+
+/* Asigna el valor de una variable, creandola como local si no existe */
+static env_var* store(const char *name, size_t len, const char *value)
+{
+    env_var **link = find_link(name, len);
+    env_var *v = *link;
+    size_t value_len = strlen(value);
+    char *entry = malloc(len + value_len + 2);
+
+    memcpy(entry, name, len);
+    entry[len] = '=';
+    memcpy(entry + len + 1, value, value_len + 1);
+
+    if (v)
+    {
+        if (v->exported)
+            block_dirty = 1;
+
+        free(v->entry);
+        v->entry = entry;
+
+        return v;
+    }
+
+    v = calloc(1, sizeof(env_var));
+    v->entry = entry;
+    v->name_len = len;
+    *link = v;
+
+    if (++table_used > table_cap)
+        grow_table();
+
+    return v;
+}
+
+static void load_environ(void)
+{
+    table_cap = ENV_TABLE_INITIAL;
+    table = calloc(table_cap, sizeof(env_var*));
+
+    for (char **s = environ; s && *s; s++)
+    {
+        char *equal = strchr(*s, '=');
+
+        if (equal && equal != *s)
+            set_exported(store(*s, equal - *s, equal + 1), 1);
+    }
+}
+
+const char* env_get(const char *name)
+{
+    env_var *v = *find_link(name, strlen(name));
+
+    return v ? v->entry + v->name_len + 1 : NULL;
+}
+
+int env_set(const char *name, const char *value)
+{
+    if (!valid_name(name))
+        return -1;
+
+    store(name, strlen(name), value);
+
+    return 0;
+}
+
+int env_export(const char *name, const char *value)
+{
+    env_var *v;
+
+    if (!valid_name(name))
+        return -1;
+
+    if (value || !(v = *find_link(name, strlen(name))))
+        v = store(name, strlen(name), value ? value : "");
+
+    set_exported(v, 1);
+
+    return 0;
+}
+
+int env_unset(const char *name)
+{
+    if (!valid_name(name))
+        return -1;
+
+    env_var **link = find_link(name, strlen(name));
+    env_var *v = *link;
+
+    if (v)
+    {
+        set_exported(v, 0);
+        *link = v->next;
+        table_used--;
+        free(v->entry);
+        free(v);
+    }
+
+    return 0;
+}
+
+int env_push(const char *assignment, env_saved *saved)
+{
+    size_t len = env_assignment(assignment);
+    env_var *v;
+
+    if (!len)
+        return -1;
+
+    v = *find_link(assignment, len);
+
+    saved->name = strndup(assignment, len);
+    saved->entry = v ? strdup(v->entry) : NULL;
+    saved->exported = v ? v->exported : 0;
+
+    set_exported(store(assignment, len, assignment + len + 1), 1);
+
+    return 0;
+}
+
+void env_pop(env_saved *saved)
+{
+    if (saved->entry)
+    {
+        size_t len = strlen(saved->name);
+
+        set_exported(store(saved->name, len, saved->entry + len + 1), saved->exported);
+    }
+    else
+        env_unset(saved->name);
+
+    free(saved->name);
+    free(saved->entry);
+}
+
+char** env_block(void)
+{
+    size_t n = 0;
+
+    if (!table)
+        load_environ();
+
+    if (!block_dirty)
+        return block;
+
+    block = realloc(block, sizeof(char*) * (n_exported + 1));
+
+    for (size_t i = 0; i < table_cap; i++)
+        for (env_var *v = table[i]; v; v = v->next)
+            if (v->exported)
+            {
+                v->index = n;
+                block[n++] = v->entry;
+            }
+
+    block[n] = NULL;
+    block_dirty = 0;
+
+    return block;
+}
+
+char** env_block_with(char **assignments)
+{
+    char **base = env_block();
+    size_t n = 0;
+    size_t total = n_exported;
+
+    while (assignments[n])
+        n++;
+
+    char **envp = malloc(sizeof(char*) * (total + n + 1));
+
+    memcpy(envp, base, sizeof(char*) * total);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t len = strcspn(assignments[i], "=");
+        env_var *v = *find_link(assignments[i], len);
+        size_t j;
+
+        if (v && v->exported)
+        {
+            envp[v->index] = assignments[i];
+            continue;
+        }
+
+        /* Una variable no exportada se agrega al final, una sola vez aunque se asigne de nuevo */
+        for (j = n_exported; j < total && (strncmp(envp[j], assignments[i], len + 1)); j++);
+
+        envp[j] = assignments[i];
+
+        if (j == total)
+            total++;
+    }
+
+    envp[total] = NULL;
+
+    return envp;
+}
+
+static int compare_entries(const void *a, const void *b)
+{
+    const char *x = *(char* const*)a;
+    const char *y = *(char* const*)b;
+
+    while (*x == *y && *x != '=')
+        x++, y++;
+
+    return (*x == '=' ? 0 : (unsigned char)*x) - (*y == '=' ? 0 : (unsigned char)*y);
+}
+
+void env_print(FILE *out)
+{
+    char **envp = env_block();
+    char **sorted = malloc(sizeof(char*) * (n_exported + 1));
+
+    memcpy(sorted, envp, sizeof(char*) * n_exported);
+    qsort(sorted, n_exported, sizeof(char*), compare_entries);
+
+    for (size_t i = 0; i < n_exported; i++)
+    {
+        const char *equal = strchr(sorted[i], '=');
+
+        fprintf(out, "export %.*s=\"%s\"\n", (int)(equal - sorted[i]), sorted[i], equal + 1);
+    }
+
+    free(sorted);
+}
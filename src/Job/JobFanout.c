@@ -0,0 +1,177 @@
+/**
+ * @file JobFanout.c
+ * @author Bottini, Franco Nicolas.
+ * @brief Implementacion del proceso de reparto del operador '|+'.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../../inc/Job/JobFanout.h"
+
+int is_fanout_process(process *p)
+{
+    return p->argc > 0 && !strcmp(p->argv[0], FANOUT_COMMAND);
+}
+
+/* Mueve len bytes de in a out. Si out ya no tiene lectores, los descarta en null. Retorna 0 si out sigue vivo */
+static int splice_all(int in, int out, int null, size_t len)
+{
+    int dead = 0;
+
+    while (len > 0)
+    {
+        ssize_t n = splice(in, NULL, dead ? null : out, NULL, len, SPLICE_F_MOVE);
+
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        if (n < 0 && errno == EPIPE && !dead)
+        {
+            dead = 1;
+            continue;
+        }
+
+        if (n <= 0)
+            _exit(EXIT_FAILURE);
+
+        len -= n;
+    }
+
+    return dead;
+}
+
+static int compare_fds(const void *a, const void *b)
+{
+    return *(const int*)a - *(const int*)b;
+}
+
+/* El proceso no ejecuta ningun programa, por lo que cierra a mano los descriptores heredados de la shell.
+   De otro modo mantendria abiertos extremos de lectura de sus salidas y nunca recibiria EPIPE */
+static void close_inherited_fds(int *keep, int n)
+{
+    unsigned int from = STDERR_FILENO + 1;
+    int *sorted = malloc(sizeof(int) * (n ? n : 1));
+
+    memcpy(sorted, keep, sizeof(int) * n);
+    qsort(sorted, n, sizeof(int), compare_fds);
+
+    for (int k = 0; k < n; k++)
+    {
+        if (sorted[k] < (int)from)
+            continue;
+
+        if (sorted[k] > (int)from)
+            close_range(from, sorted[k] - 1, 0);
+
+        from = sorted[k] + 1;
+    }
+
+    close_range(from, ~0U, 0);
+    free(sorted);
+}
+
+void run_fanout(process *p)
+{
+    int n_out = p->argc;
+    int *out = malloc(sizeof(int) * n_out);
+    int (*stage)[2] = malloc(sizeof(*stage) * n_out);
+    int pipe_size = fcntl(STDIN_FILENO, F_GETPIPE_SZ);
+    int alive = n_out;
+    int null;
+
+    signal(SIGPIPE, SIG_IGN);
+
+    for (int k = 0; k < n_out - 1; k++)
+    {
+        char *fd = strrchr(p->argv[k + 1], '/');
+
+        out[k] = fd ? atoi(fd + 1) : -1;
+    }
+
+    close_inherited_fds(out, n_out - 1);
+    null = open("/dev/null", O_WRONLY);
+
+    /* La ultima salida es la salida estandar, que recibe los datos originales con splice */
+    for (int k = 0; k < n_out - 1; k++)
+    {
+        /* Cada copia pasa por un pipe propio vacio y de igual capacidad que la entrada, asi tee nunca
+           copia parcialmente y un consumidor lento no altera lo que reciben los demas */
+        if (out[k] < 0 || pipe(stage[k]) < 0 || null < 0 || pipe_size < 0)
+        {
+            fprintf(stderr, KRED"\n"FANOUT_COMMAND": %s !\n"KDEF, strerror(errno ? errno : EBADF));
+            _exit(EXIT_FAILURE);
+        }
+
+        fcntl(stage[k][1], F_SETPIPE_SZ, pipe_size);
+    }
+
+    out[n_out - 1] = STDOUT_FILENO;
+
+    while (alive > 0)
+    {
+        ssize_t len = 0;
+
+        for (int k = 0; k < n_out - 1; k++)
+        {
+            if (out[k] < 0)
+                continue;
+
+            ssize_t n;
+
+            while ((n = tee(STDIN_FILENO, stage[k][1], len ? (size_t)len : INT_MAX, 0)) < 0 && errno == EINTR);
+
+            if (n < 0)
+            {
+                fprintf(stderr, KRED"\n"FANOUT_COMMAND": tee: %s !\n"KDEF, strerror(errno));
+                _exit(EXIT_FAILURE);
+            }
+
+            if (n == 0)
+                break;
+
+            if (len && n != len)
+            {
+                fprintf(stderr, KRED"\n"FANOUT_COMMAND": partial tee !\n"KDEF);
+                _exit(EXIT_FAILURE);
+            }
+
+            len = n;
+        }
+
+        if (!len)
+        {
+            while ((len = splice(STDIN_FILENO, NULL, out[n_out - 1] < 0 ? null : out[n_out - 1], NULL,
+                                 INT_MAX, SPLICE_F_MOVE)) < 0 && errno == EINTR);
+
+            if (len < 0 && errno == EPIPE && out[n_out - 1] >= 0)
+            {
+                out[n_out - 1] = -1;
+                alive--;
+                continue;
+            }
+
+            if (len <= 0)
+                break;
+        }
+        else if (splice_all(STDIN_FILENO, out[n_out - 1] < 0 ? null : out[n_out - 1], null, len) && out[n_out - 1] >= 0)
+        {
+            out[n_out - 1] = -1;
+            alive--;
+        }
+
+        for (int k = 0; k < n_out - 1; k++)
+        {
+            if (out[k] >= 0 && splice_all(stage[k][0], out[k], null, len))
+            {
+                close(out[k]);
+                out[k] = -1;
+                alive--;
+            }
+        }
+    }
+
+    _exit(EXIT_SUCCESS);
+}
@@ -10,6 +10,7 @@
  */
 
 #include "../../inc/Job/JobList.h"
+#include "../../inc/Job/JobShm.h"
 
 job *first_job = NULL;
 
@@ -17,10 +18,31 @@ job* new_job()
 {
     job* j = malloc(sizeof(job));
 
+    if (!j)
+        return NULL;
+
     j->id = 0;
     j->next = NULL;
     j->pgid = 0;
     j->first_process = NULL;
+    j->out_fd = -1;
+    j->out = (job_buffer){ NULL, 0, 0 };
+    j->err = (job_buffer){ NULL, 0, 0 };
+    j->start_time = 0;
+    j->waited = 0;
+    j->managed = 0;
+    j->sources = NULL;
+    j->priority = 0;
+    j->wait_target = 0;
+    j->after = NULL;
+    j->n_after = 0;
+    j->after_failed = 0;
+    j->dependents = NULL;
+    j->n_dependents = 0;
+    j->stdin_fd = -1;
+    j->stdout_fd = -1;
+    j->substs = NULL;
+    j->subst_fd = -1;
 
     return j;
 }
@@ -31,10 +53,48 @@ process* new_process(char *command, char* infile, char* outfile)
 
     p->next = NULL;
     p->argv = str_to_array(command, &p->argc);
+    p->envc = 0;
+    p->env = NULL;
     p->input_path = infile;
     p->output_path = outfile;
+    p->error_path = NULL;
+    p->merge_error = 0;
+    p->status = STATUS_NEW;
+    p->changed = 0;
+    p->pid = -1;
+    p->exit_code = 0;
+    p->pidfd = -1;
+    p->shm_slot = -1;
+    p->runner = NULL;
+    memset(&p->usage, 0, sizeof(p->usage));
+
+    return p;
+}
+
+process* new_process_argv(char **argv, int argc)
+{
+    process *p = malloc(sizeof(process));
+
+    if (!p)
+        return NULL;
+
+    p->next = NULL;
+    p->argv = argv;
+    p->argc = argc;
+    p->envc = 0;
+    p->env = NULL;
+    p->input_path = NULL;
+    p->output_path = NULL;
+    p->error_path = NULL;
+    p->merge_error = 0;
     p->status = STATUS_NEW;
+    p->changed = 0;
     p->pid = -1;
+    p->exit_code = 0;
+    p->pidfd = -1;
+    p->shm_slot = -1;
+    p->runner = NULL;
+    memset(&p->usage, 0, sizeof(p->usage));
 
     return p;
 }
@@ -110,12 +170,28 @@ job* get_job_by_id(int id_job)
     return NULL;
 }
 
+static process* find_job_process(job *j, int pid)
+{
+    for (process* p = j->first_process; p; p = p->next) 
+        if (p->pid == pid) 
+            return p;
+
+    for (job* s = j->substs; s; s = s->next)
+    {
+        process *p = find_job_process(s, pid);
+
+        if (p)
+            return p;
+    }
+
+    return NULL;
+}
+
 job* get_job_by_pid(int pid)
 {
     for (job* j = first_job; j; j = j->next) 
-        for (process* p = j->first_process; p; p = p->next) 
-            if (p->pid == pid) 
-                return j;
+        if (find_job_process(j, pid))
+            return j;
 
     return NULL;
 }
@@ -139,9 +215,20 @@ int is_job_completed(job *j)
         if (!is_process_completed(p))
             return 0;
 
+    for (job* s = j->substs; s; s = s->next)
+        if (!is_job_completed(s))
+            return 0;
+
     return 1;
 }
 
+int get_job_exit_code(job *j)
+{
+    process *last_p = get_last_process(j);
+
+    return last_p ? last_p->exit_code : 0;
+}
+
 int is_job_runnig(job *j) 
 {
     for (process* p = j->first_process; p != NULL; p = p->next) 
@@ -157,9 +244,18 @@ int is_job_stoped(job *j)
         if (!is_process_stoped(p) && !is_process_completed(p))
             return 0;
 
+    for (job* s = j->substs; s; s = s->next)
+        if (!is_job_stoped(s))
+            return 0;
+
     return 1;
 }
 
+int is_job_queued(job *j) 
+{
+    return j->first_process && j->first_process->status == STATUS_QUEUED;
+}
+
 int is_any_job_in_foreground()
 {
     for (job* j = first_job; j; j = j->next)
@@ -191,15 +287,7 @@ process* get_process_by_pid(int pid)
     if(!j)
         return NULL;
 
-    process* p = j->first_process;
-
-    if(!p)
-        return NULL;
-
-    while (p->pid != pid)
-        p = p->next;
-
-    return p;
+    return find_job_process(j, pid);
 }
 
 int is_process_completed(process *p)
@@ -220,6 +308,7 @@ int is_process_stoped(process *p)
 void set_process_status(process* p, PROCESS_STATUS status)
 {
     p->status = status;
+    p->changed = get_monotonic_ns();
 }
 
 void free_job(job *j)
@@ -227,15 +316,41 @@ void free_job(job *j)
     process *aux;
     process *p = j->first_process;
 
+    job_shm_release(j);
+
     while(p)
     {
         free_array(p->argv, p->argc);
+        free_array(p->env, p->envc);
         free(p->input_path);
         free(p->output_path);
+        free(p->error_path);
         aux = p;
         p = p->next;
         free(aux);
     }
     
+    while (j->substs)
+    {
+        job *s = j->substs;
+
+        j->substs = s->next;
+
+        if (s->subst_fd >= 0)
+            close(s->subst_fd);
+
+        if (s->stdin_fd >= 0)
+            close(s->stdin_fd);
+
+        if (s->stdout_fd >= 0)
+            close(s->stdout_fd);
+
+        free_job(s);
+    }
+    
+    free(j->out.data);
+    free(j->err.data);
+    free(j->after);
+    free(j->dependents);
     free(j);
 }
\ No newline at end of file
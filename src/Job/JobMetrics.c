@@ -0,0 +1,171 @@
+/**
+ * @file JobMetrics.c
+ * @author Bottini, Franco Nicolas.
+ * @brief Implementacion de las metricas del control de trabajos.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../../inc/Job/JobMetrics.h"
+
+job_metrics metrics;
+
+static int histogram_index(uint64_t value)
+{
+    if (value < HIST_SUB_COUNT)
+        return (int)value;
+
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - HIST_SUB_BITS;
+
+    return (shift + 1) * HIST_SUB_COUNT + (int)((value >> shift) & (HIST_SUB_COUNT - 1));
+}
+
+static uint64_t histogram_bucket_top(int index)
+{
+    int group = index / HIST_SUB_COUNT;
+    uint64_t sub = index % HIST_SUB_COUNT;
+
+    if (group == 0)
+        return sub;
+
+    return ((HIST_SUB_COUNT + sub + 1) << (group - 1)) - 1;
+}
+
+void histogram_record(histogram *h, uint64_t value)
+{
+    if (!h->count || value < h->min)
+        h->min = value;
+
+    if (value > h->max)
+        h->max = value;
+
+    h->count++;
+    h->sum += value;
+    h->buckets[histogram_index(value)]++;
+}
+
+uint64_t histogram_percentile(histogram *h, double percentile)
+{
+    if (!h->count)
+        return 0;
+
+    uint64_t target = (uint64_t)(percentile / 100.0 * h->count + 0.5);
+    uint64_t seen = 0;
+
+    if (target < 1)
+        target = 1;
+
+    for (int i = 0; i < HIST_BUCKETS; i++)
+    {
+        seen += h->buckets[i];
+
+        if (seen >= target)
+        {
+            uint64_t top = histogram_bucket_top(i);
+            return top > h->max ? h->max : top;
+        }
+    }
+
+    return h->max;
+}
+
+void metrics_job_launched(void)
+{
+    metrics.jobs_launched++;
+
+    if (++metrics.jobs_active > metrics.jobs_peak)
+        metrics.jobs_peak = metrics.jobs_active;
+}
+
+void metrics_job_reaped(uint64_t duration)
+{
+    metrics.jobs_reaped++;
+
+    if (metrics.jobs_active)
+        metrics.jobs_active--;
+
+    histogram_record(&metrics.job_duration, duration);
+}
+
+void metrics_reset(void)
+{
+    uint64_t active = metrics.jobs_active;
+
+    memset(&metrics, 0, sizeof(metrics));
+
+    metrics.jobs_active = active;
+    metrics.jobs_peak = active;
+}
+
+static void histogram_print_text(FILE *fp, const char *name, histogram *h, double unit, const char *unit_name)
+{
+    fprintf(fp, KBLU"%-20s"KDEF" count %llu", name, (unsigned long long)h->count);
+
+    if (h->count)
+        fprintf(fp, "  min %.1f  p50 %.1f  p90 %.1f  p99 %.1f  max %.1f  mean %.1f (%s)",
+                h->min / unit,
+                histogram_percentile(h, 50) / unit,
+                histogram_percentile(h, 90) / unit,
+                histogram_percentile(h, 99) / unit,
+                h->max / unit,
+                (double)h->sum / h->count / unit,
+                unit_name);
+
+    fprintf(fp, "\n");
+}
+
+void metrics_print_text(FILE *fp)
+{
+    fprintf(fp, "\n");
+    fprintf(fp, KBLU"%-20s"KDEF" %llu\n", "jobs launched", (unsigned long long)metrics.jobs_launched);
+    fprintf(fp, KBLU"%-20s"KDEF" %llu\n", "jobs queued", (unsigned long long)metrics.jobs_queued);
+    fprintf(fp, KBLU"%-20s"KDEF" %llu\n", "processes forked", (unsigned long long)metrics.processes_forked);
+    fprintf(fp, KBLU"%-20s"KDEF" %llu\n", "exec failures", (unsigned long long)metrics.exec_failures);
+    fprintf(fp, KBLU"%-20s"KDEF" %llu\n", "jobs reaped", (unsigned long long)metrics.jobs_reaped);
+    fprintf(fp, KBLU"%-20s"KDEF" %llu\n", "signals received", (unsigned long long)metrics.signals_received);
+    fprintf(fp, KBLU"%-20s"KDEF" %llu\n", "active jobs", (unsigned long long)metrics.jobs_active);
+    fprintf(fp, KBLU"%-20s"KDEF" %llu\n", "peak concurrent jobs", (unsigned long long)metrics.jobs_peak);
+    histogram_print_text(fp, "spawn-to-exec", &metrics.spawn_latency, 1e3, "us");
+    histogram_print_text(fp, "zygote spawn-to-exec", &metrics.zygote_latency, 1e3, "us");
+    histogram_print_text(fp, "job duration", &metrics.job_duration, 1e6, "ms");
+    fprintf(fp, "\n");
+}
+
+static void histogram_print_json(FILE *fp, const char *name, histogram *h)
+{
+    fprintf(fp, "\"%s\":{\"count\":%llu,\"sum\":%llu,\"min\":%llu,\"p50\":%llu,\"p90\":%llu,\"p99\":%llu,\"p999\":%llu,\"max\":%llu}",
+            name,
+            (unsigned long long)h->count,
+            (unsigned long long)h->sum,
+            (unsigned long long)(h->count ? h->min : 0),
+            (unsigned long long)histogram_percentile(h, 50),
+            (unsigned long long)histogram_percentile(h, 90),
+            (unsigned long long)histogram_percentile(h, 99),
+            (unsigned long long)histogram_percentile(h, 99.9),
+            (unsigned long long)h->max);
+}
+
+void metrics_print_json(FILE *fp)
+{
+    fprintf(fp, "{\"jobs_launched\":%llu,\"jobs_queued\":%llu,\"processes_forked\":%llu,\"exec_failures\":%llu,\"jobs_reaped\":%llu,"
+                "\"signals_received\":%llu,\"jobs_active\":%llu,\"jobs_peak\":%llu,",
+            (unsigned long long)metrics.jobs_launched,
+            (unsigned long long)metrics.jobs_queued,
+            (unsigned long long)metrics.processes_forked,
+            (unsigned long long)metrics.exec_failures,
+            (unsigned long long)metrics.jobs_reaped,
+            (unsigned long long)metrics.signals_received,
+            (unsigned long long)metrics.jobs_active,
+            (unsigned long long)metrics.jobs_peak);
+
+    histogram_print_json(fp, "spawn_to_exec_ns", &metrics.spawn_latency);
+    fprintf(fp, ",");
+    histogram_print_json(fp, "zygote_spawn_to_exec_ns", &metrics.zygote_latency);
+    fprintf(fp, ",");
+    histogram_print_json(fp, "job_duration_ns", &metrics.job_duration);
+    fprintf(fp, "}\n");
+}
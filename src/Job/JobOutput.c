@@ -0,0 +1,249 @@
+/**
+ * @file JobOutput.c
+ * @author Bottini, Franco Nicolas.
+ * @brief Implementacion de la captura de la salida de los trabajos.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../../inc/Job/JobOutput.h"
+
+static int error_channel[2] = { -1, -1 };
+static int null_input = -1;
+static long captured_fds = 0;
+static struct rlimit original_fd_limit;
+static int fd_limit_raised = 0;
+
+void raise_fd_limit(void)
+{
+    struct rlimit rl;
+
+    if (getrlimit(RLIMIT_NOFILE, &rl) < 0)
+        return;
+
+    if (rl.rlim_cur < rl.rlim_max)
+    {
+        original_fd_limit = rl;
+        rl.rlim_cur = rl.rlim_max;
+        fd_limit_raised = setrlimit(RLIMIT_NOFILE, &rl) == 0;
+    }
+}
+
+void restore_fd_limit(void)
+{
+    if (fd_limit_raised)
+        setrlimit(RLIMIT_NOFILE, &original_fd_limit);
+}
+
+int job_error_channel(void)
+{
+    if (error_channel[1] >= 0)
+        return error_channel[1];
+
+    /* Un socket de flujo no tiene limite por escritura: una escritura grande espera a que la shell lea, en vez
+       de fallar o truncarse. Con SO_PASSCRED cada lectura trae los datos de un unico emisor, con sus credenciales */
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, error_channel) < 0)
+        return -1;
+
+    int on = 1;
+    int size = JOB_OUTPUT_SOCKBUF;
+
+    setsockopt(error_channel[0], SOL_SOCKET, SO_PASSCRED, &on, sizeof(on));
+    setsockopt(error_channel[0], SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    setsockopt(error_channel[1], SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    fcntl(error_channel[0], F_SETFL, fcntl(error_channel[0], F_GETFL) | O_NONBLOCK);
+
+    return error_channel[1];
+}
+
+int job_null_input(void)
+{
+    if (null_input < 0)
+        null_input = open("/dev/null", O_RDONLY | O_CLOEXEC);
+
+    return null_input;
+}
+
+int job_error_reader(void)
+{
+    return error_channel[0];
+}
+
+void forget_error_channel(void)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        if (error_channel[i] >= 0)
+            close(error_channel[i]);
+
+        error_channel[i] = -1;
+    }
+}
+
+static job* get_job_by_sender(pid_t pid)
+{
+    job *j = get_job_by_pid(pid);
+
+    if (j)
+        return j;
+
+    pid_t pgid = getpgid(pid);
+
+    if (pgid < 0)
+        return NULL;
+
+    for (j = first_job; j; j = j->next)
+        if (j->pgid == pgid)
+            return j;
+
+    return NULL;
+}
+
+void drain_job_output(void)
+{
+    static char buffer[JOB_OUTPUT_CHUNK];
+    char control[CMSG_SPACE(sizeof(struct ucred))];
+
+    if (error_channel[0] < 0)
+        return;
+
+    while (1)
+    {
+        struct iovec iov = {
+            .iov_base = buffer,
+            .iov_len = sizeof(buffer)
+        };
+        struct msghdr msg = {
+            .msg_iov = &iov,
+            .msg_iovlen = 1,
+            .msg_control = control,
+            .msg_controllen = sizeof(control)
+        };
+
+        ssize_t n = recvmsg(error_channel[0], &msg, MSG_DONTWAIT);
+
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        if (n <= 0)
+            break;
+
+        job *j = NULL;
+
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+        {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_CREDENTIALS)
+            {
+                struct ucred cred;
+
+                memcpy(&cred, CMSG_DATA(cmsg), sizeof(cred));
+                j = get_job_by_sender(cred.pid);
+            }
+        }
+
+        if (j)
+            append_job_buffer(&j->err, buffer, n);
+        else
+            fprintf(stdout, KRED"[?] %.*s"KDEF, (int)n, buffer);
+    }
+}
+
+void append_job_buffer(job_buffer *b, const char *data, size_t len)
+{
+    if (!len)
+        return;
+
+    if (b->len + len > b->cap)
+    {
+        size_t cap = b->cap ? b->cap : 256;
+
+        while (cap < b->len + len)
+            cap *= 2;
+
+        char *buf = realloc(b->data, cap);
+
+        if (!buf)
+            return;
+
+        b->data = buf;
+        b->cap = cap;
+    }
+
+    memcpy(b->data + b->len, data, len);
+    b->len += len;
+}
+
+void append_job_format(job_buffer *b, const char *format, ...)
+{
+    char text[256];
+    va_list ap;
+    int n;
+
+    va_start(ap, format);
+    n = vsnprintf(text, sizeof(text), format, ap);
+    va_end(ap);
+
+    if (n < (int)sizeof(text))
+    {
+        append_job_buffer(b, text, n > 0 ? n : 0);
+        return;
+    }
+
+    char *big = malloc(n + 1);
+
+    va_start(ap, format);
+    vsnprintf(big, n + 1, format, ap);
+    va_end(ap);
+
+    append_job_buffer(b, big, n);
+    free(big);
+}
+
+int write_job_buffer(int fd, const job_buffer *b)
+{
+    size_t done = 0;
+
+    while (done < b->len)
+    {
+        ssize_t n = write(fd, b->data + done, b->len - done);
+
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        if (n <= 0)
+            return -1;
+
+        done += n;
+    }
+
+    return 0;
+}
+
+int reserve_capture_fd(void)
+{
+    struct rlimit rl;
+
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur != RLIM_INFINITY && (rlim_t)captured_fds >= rl.rlim_cur / 2)
+    {
+        errno = EMFILE;
+        return -1;
+    }
+
+    captured_fds++;
+
+    return 0;
+}
+
+void release_capture_fd(void)
+{
+    if (captured_fds > 0)
+        captured_fds--;
+}
+
+int is_fd_exhausted(int err)
+{
+    return err == EMFILE || err == ENFILE;
+}
@@ -0,0 +1,205 @@
+/**
+ * @file JobParallel.c
+ * @author Bottini, Franco Nicolas.
+ * @brief Implementacion de la ejecucion en abanico de trabajos.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../../inc/Job/JobParallel.h"
+
+char* expand_parallel_template(const char *template, const char *arg)
+{
+    size_t ph_len = strlen(PARALLEL_PLACEHOLDER);
+    size_t arg_len = strlen(arg);
+    size_t len = 0;
+    int found = 0;
+
+    for (const char *c = template; *c; )
+    {
+        if (!strncmp(c, PARALLEL_PLACEHOLDER, ph_len))
+        {
+            len += arg_len;
+            c += ph_len;
+            found = 1;
+        }
+        else
+        {
+            len++;
+            c++;
+        }
+    }
+
+    char *command = malloc(len + arg_len + 2);
+    char *out = command;
+
+    for (const char *c = template; *c; )
+    {
+        if (!strncmp(c, PARALLEL_PLACEHOLDER, ph_len))
+        {
+            memcpy(out, arg, arg_len);
+            out += arg_len;
+            c += ph_len;
+        }
+        else
+            *out++ = *c++;
+    }
+
+    if (!found)
+    {
+        *out++ = ASCII_SPACE;
+        memcpy(out, arg, arg_len);
+        out += arg_len;
+    }
+
+    *out = ASCII_END_OF_STRING;
+
+    return command;
+}
+
+static void emit_buffer(FILE *fp, job_buffer *b, const char *tag)
+{
+    size_t start = 0;
+
+    if (!tag)
+    {
+        fwrite(b->data, 1, b->len, fp);
+        return;
+    }
+
+    for (size_t i = 0; i < b->len; i++)
+    {
+        if (b->data[i] == ASCII_LINE_BREAK)
+        {
+            fprintf(fp, "%s\t%.*s\n", tag, (int)(i - start), b->data + start);
+            start = i + 1;
+        }
+    }
+
+    if (start < b->len)
+        fprintf(fp, "%s\t%.*s\n", tag, (int)(b->len - start), b->data + start);
+}
+
+static int finish_parallel_job(job *j, const char *arg, parallel_options *opt)
+{
+    int code = get_job_exit_code(j);
+
+    emit_buffer(stdout, &j->out, opt->tag ? arg : NULL);
+    emit_buffer(stderr, &j->err, opt->tag ? arg : NULL);
+    fflush(stdout);
+    fflush(stderr);
+
+    metrics_job_reaped(get_monotonic_ns() - j->start_time);
+    remove_job(j);
+
+    return code != 0;
+}
+
+int run_parallel(const char *template, char **args, int n, parallel_options *opt, job_builder builder)
+{
+    uint64_t t_parallel = trace_begin();
+    job_waiter w;
+    job **slots = calloc(n ? n : 1, sizeof(job*));
+    char *done = calloc(n ? n : 1, sizeof(char));
+    int next = 0, emitted = 0, finished = 0, running = 0, failed = 0;
+
+    if (job_waiter_init(&w) < 0)
+    {
+        fprintf(stderr, KRED"\nepoll: %s !\n\n"KDEF, strerror(errno));
+        free(slots);
+        free(done);
+        return 1;
+    }
+
+    while (finished < n && !job_waiter_interrupted(&w))
+    {
+        while (running < opt->max_jobs && next < n)
+        {
+            char *command = expand_parallel_template(template, args[next]);
+            job *j = builder(command);
+
+            free(command);
+
+            if (!j->first_process)
+            {
+                free_job(j);
+                done[next++] = 1;
+                finished++;
+                failed++;
+                continue;
+            }
+
+            j->managed = 1;
+            launch_job(j, BACKGROUND_EXECUTION);
+            slots[next] = j;
+
+            if (job_waiter_add(&w, j) != 0)
+                done[next] = 1;
+            else
+                running++;
+
+            next++;
+        }
+
+        if (running > 0)
+        {
+            job *j = job_waiter_next(&w);
+
+            if (!j)
+                break;
+
+            for (int i = emitted; i < next; i++)
+                if (slots[i] == j)
+                {
+                    done[i] = 1;
+                    break;
+                }
+
+            running--;
+        }
+
+        for (int i = emitted; i < next && (done[i] || !opt->keep_order); i++)
+        {
+            if (done[i] && slots[i])
+            {
+                failed += finish_parallel_job(slots[i], args[i], opt);
+                slots[i] = NULL;
+                finished++;
+            }
+        }
+
+        while (emitted < next && done[emitted] && !slots[emitted])
+            emitted++;
+    }
+
+    int interrupted = job_waiter_interrupted(&w);
+
+    block_sigchld();
+    job_waiter_close(&w);
+
+    if (finished < n)
+    {
+        for (int i = 0; i < next; i++)
+            if (slots[i])
+                abort_managed_job(slots[i]);
+
+        failed = interrupted ? 128 + SIGINT : failed + n - finished;
+    }
+
+    unblock_sigchld();
+
+    free(slots);
+    free(done);
+
+    trace_end_arg("parallel", t_parallel, n);
+
+    if (failed > PARALLEL_MAX_EXIT && failed != 128 + SIGINT)
+        failed = PARALLEL_MAX_EXIT;
+
+    last_exit_status = failed;
+
+    return failed;
+}
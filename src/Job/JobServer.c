@@ -0,0 +1,515 @@
+/**
+ * @file JobServer.c
+ * @author Bottini, Franco Nicolas.
+ * @brief Implementacion del modo servidor de MyShell.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../../inc/Job/JobServer.h"
+
+static char listen_tag;
+static char waiter_tag;
+static server_client *clients = NULL;
+
+static void client_queue(server_client *c, uint8_t type, const void *data, size_t len)
+{
+    server_frame f = {
+        .type = type,
+        .len = len
+    };
+
+    append_job_buffer(&c->out, (const char*)&f, sizeof(f));
+
+    if (len)
+        append_job_buffer(&c->out, data, len);
+}
+
+/* Un cliente deja de leerse mientras tenga una trama completa sin procesar, hasta que su trabajo actual finalice */
+static int client_input_full(server_client *c)
+{
+    return c->in.len >= sizeof(server_frame) + SERVER_MAX_FRAME;
+}
+
+static void client_events(int epfd, server_client *c)
+{
+    struct epoll_event ev = {
+        .events = (c->eof || client_input_full(c) ? 0 : EPOLLIN) | (c->out.len ? EPOLLOUT : 0),
+        .data.ptr = c
+    };
+
+    if (c->closing || ev.events == c->events)
+        return;
+
+    epoll_ctl(epfd, EPOLL_CTL_MOD, c->fd, &ev);
+    c->events = ev.events;
+}
+
+static void client_dead(int epfd, server_client *c)
+{
+    c->closing = 1;
+    c->out.len = c->out_off = 0;
+
+    epoll_ctl(epfd, EPOLL_CTL_DEL, c->fd, NULL);
+
+    if (c->j && c->j->pgid > 0)
+        kill(-c->j->pgid, SIGKILL);
+}
+
+static void client_flush(int epfd, server_client *c)
+{
+    while (c->out_off < c->out.len)
+    {
+        ssize_t n = send(c->fd, c->out.data + c->out_off, c->out.len - c->out_off, MSG_NOSIGNAL | MSG_DONTWAIT);
+
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+
+            client_dead(epfd, c);
+            return;
+        }
+
+        c->out_off += n;
+    }
+
+    /* Lo ya enviado se descarta cuando ocupa la mitad del buffer, para que no crezca con un cliente que lee de a poco */
+    if (c->out_off == c->out.len)
+        c->out.len = c->out_off = 0;
+    else if (c->out_off >= c->out.len / 2)
+    {
+        c->out.len -= c->out_off;
+        memmove(c->out.data, c->out.data + c->out_off, c->out.len);
+        c->out_off = 0;
+    }
+
+    client_events(epfd, c);
+}
+
+static void client_output(server_client *c)
+{
+    job *j = c->j;
+
+    if (j->out.len)
+    {
+        client_queue(c, SERVER_FRAME_STDOUT, j->out.data, j->out.len);
+        j->out.len = 0;
+    }
+
+    if (j->err.len)
+    {
+        client_queue(c, SERVER_FRAME_STDERR, j->err.data, j->err.len);
+        j->err.len = 0;
+    }
+}
+
+/* Pasa la salida del trabajo al cliente mientras tenga menos de SERVER_MAX_OUTPUT bytes sin enviar. Al superarlo se
+   suspende la lectura de la salida estandar del trabajo, que se bloquea hasta que el cliente lea */
+static void client_stream(int epfd, job_waiter *w, server_client *c)
+{
+    job *j = c->j;
+
+    if (c->out.len - c->out_off < SERVER_MAX_OUTPUT)
+        client_output(c);
+    else if (j->err.len > SERVER_MAX_OUTPUT)
+    {
+        /* El canal de errores es compartido y no puede suspenderse: se corta al cliente que no lee */
+        client_dead(epfd, c);
+        return;
+    }
+
+    int full = c->out.len - c->out_off >= SERVER_MAX_OUTPUT;
+
+    if (full != c->throttled)
+    {
+        job_waiter_throttle(w, j, full);
+        c->throttled = full;
+    }
+}
+
+/* Envia lo pendiente y, si la salida del trabajo estaba suspendida, le hace lugar y la reanuda */
+static void client_write(int epfd, job_waiter *w, server_client *c)
+{
+    client_flush(epfd, c);
+
+    if (c->j && c->throttled && !c->closing)
+    {
+        client_stream(epfd, w, c);
+        client_flush(epfd, c);
+    }
+}
+
+static void client_finish(server_client *c)
+{
+    job *j = c->j;
+    int32_t code = get_job_exit_code(j);
+
+    if (!c->closing)
+    {
+        client_output(c);
+        client_queue(c, SERVER_FRAME_EXIT, &code, sizeof(code));
+    }
+
+    metrics_job_reaped(get_monotonic_ns() - j->start_time);
+    remove_job(j);
+
+    c->j = NULL;
+    c->throttled = 0;
+}
+
+static job* client_build_job(server_frame *f, char *data, command_runner runner)
+{
+    if (f->type == SERVER_FRAME_COMMAND)
+    {
+        job *j = new_job();
+        char **argv = malloc(sizeof(char*) * 3);
+
+        argv[0] = strdup(SERVER_SCRIPT_COMMAND);
+        argv[1] = malloc(f->len + 1);
+        argv[2] = NULL;
+
+        memcpy(argv[1], data, f->len);
+        argv[1][f->len] = ASCII_END_OF_STRING;
+
+        /* La linea se ejecuta en una copia de la shell, con los mismos builtins, expansiones y redirecciones que -c */
+        if (!trim_white_space(argv[1]))
+        {
+            free_array(argv, 2);
+            return j;
+        }
+
+        process *p = new_process_argv(argv, 2);
+
+        p->runner = runner;
+        insert_process(j, p);
+
+        return j;
+    }
+
+    job *j = new_job();
+    int argc = 0;
+    char **argv = malloc(sizeof(char*));
+
+    for (uint32_t off = 0; off < f->len; )
+    {
+        size_t len = strnlen(data + off, f->len - off);
+
+        argv = realloc(argv, sizeof(char*) * (argc + 2));
+        argv[argc] = malloc(len + 1);
+        memcpy(argv[argc], data + off, len);
+        argv[argc++][len] = ASCII_END_OF_STRING;
+
+        off += len + 1;
+    }
+
+    argv[argc] = NULL;
+
+    if (argc)
+        insert_process(j, new_process_argv(argv, argc));
+    else
+        free(argv);
+
+    return j;
+}
+
+static void client_dispatch(int epfd, job_waiter *w, server_client *c, command_runner runner)
+{
+    server_frame f;
+
+    while (!c->j && !c->closing && c->in.len >= sizeof(f))
+    {
+        memcpy(&f, c->in.data, sizeof(f));
+
+        if (f.len > SERVER_MAX_FRAME || (f.type != SERVER_FRAME_COMMAND && f.type != SERVER_FRAME_ARGV))
+        {
+            client_dead(epfd, c);
+            return;
+        }
+
+        if (c->in.len < sizeof(f) + f.len)
+            break;
+
+        job *j = client_build_job(&f, c->in.data + sizeof(f), runner);
+
+        c->in.len -= sizeof(f) + f.len;
+        memmove(c->in.data, c->in.data + sizeof(f) + f.len, c->in.len);
+
+        if (!j->first_process)
+        {
+            int32_t code = 2;
+
+            free_job(j);
+            client_queue(c, SERVER_FRAME_EXIT, &code, sizeof(code));
+            continue;
+        }
+
+        j->managed = 1;
+        launch_job(j, BACKGROUND_EXECUTION);
+        c->j = j;
+
+        int added = job_waiter_add(w, j);
+
+        if (added < 0 && j->pgid > 0)
+        {
+            kill(-j->pgid, SIGKILL);
+            added = job_waiter_add(w, j);
+        }
+
+        if (added != 0)
+            client_finish(c);
+    }
+
+    client_flush(epfd, c);
+}
+
+static void client_read(int epfd, job_waiter *w, server_client *c, command_runner runner)
+{
+    static char buffer[JOB_OUTPUT_CHUNK];
+    ssize_t n = 1;
+
+    while (!client_input_full(c) && (n = recv(c->fd, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0)
+        append_job_buffer(&c->in, buffer, n);
+
+    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+    {
+        client_dead(epfd, c);
+        return;
+    }
+
+    if (n == 0)
+        c->eof = 1;
+
+    client_dispatch(epfd, w, c, runner);
+}
+
+static void server_accept(int epfd, int listen_fd)
+{
+    int fd;
+
+    while ((fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+    {
+        server_client *c = calloc(1, sizeof(server_client));
+        struct epoll_event ev = {
+            .events = EPOLLIN,
+            .data.ptr = c
+        };
+
+        c->fd = fd;
+        c->events = ev.events;
+
+        if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) < 0)
+        {
+            close(fd);
+            free(c);
+            continue;
+        }
+
+        c->next = clients;
+        clients = c;
+    }
+}
+
+static void server_jobs(int epfd, job_waiter *w, command_runner runner)
+{
+    job *j;
+
+    while ((j = job_waiter_poll(w)))
+    {
+        for (server_client *c = clients; c; c = c->next)
+        {
+            if (c->j == j)
+            {
+                client_finish(c);
+                client_dispatch(epfd, w, c, runner);
+                break;
+            }
+        }
+    }
+
+    for (server_client *c = clients; c; c = c->next)
+    {
+        if (c->j && !c->closing)
+        {
+            client_stream(epfd, w, c);
+
+            if (!c->closing)
+                client_flush(epfd, c);
+        }
+    }
+}
+
+static void server_release_clients(void)
+{
+    server_client **link = &clients;
+
+    while (*link)
+    {
+        server_client *c = *link;
+
+        if (c->j || (!c->closing && !(c->eof && !c->out.len)))
+        {
+            link = &c->next;
+            continue;
+        }
+
+        *link = c->next;
+
+        close(c->fd);
+        free(c->in.data);
+        free(c->out.data);
+        free(c);
+    }
+}
+
+static int server_listen(const char *path)
+{
+    struct sockaddr_un addr = {
+        .sun_family = AF_UNIX
+    };
+
+    if (strlen(path) >= sizeof(addr.sun_path))
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    strcpy(addr.sun_path, path);
+    unlink(path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+    if (fd < 0)
+        return -1;
+
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, SOMAXCONN) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+int run_server(const char *path, command_runner runner)
+{
+    struct epoll_event events[SERVER_MAX_EVENTS];
+    struct sigaction interrupt_action, old_term;
+    job_waiter w;
+    int listen_fd, epfd;
+
+    if ((listen_fd = server_listen(path)) < 0)
+    {
+        fprintf(stderr, KRED"\n%s: %s !\n\n"KDEF, path, strerror(errno));
+        return -1;
+    }
+
+    job_error_channel();
+
+    if (job_waiter_init(&w) < 0 || (epfd = epoll_create1(EPOLL_CLOEXEC)) < 0)
+    {
+        fprintf(stderr, KRED"\nepoll: %s !\n\n"KDEF, strerror(errno));
+        close(listen_fd);
+        unlink(path);
+        return -1;
+    }
+
+    sigaction(SIGINT, NULL, &interrupt_action);
+    sigaction(SIGTERM, &interrupt_action, &old_term);
+    signal(SIGPIPE, SIG_IGN);
+
+    struct epoll_event ev = {
+        .events = EPOLLIN,
+        .data.ptr = &listen_tag
+    };
+    epoll_ctl(epfd, EPOLL_CTL_ADD, listen_fd, &ev);
+
+    ev.data.ptr = &waiter_tag;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, w.epfd, &ev);
+
+    while (!job_waiter_interrupted(&w))
+    {
+        int ready = epoll_wait(epfd, events, SERVER_MAX_EVENTS, -1);
+
+        if (ready < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            fprintf(stderr, KRED"\nepoll: %s !\n\n"KDEF, strerror(errno));
+            break;
+        }
+
+        for (int i = 0; i < ready; i++)
+        {
+            void *tag = events[i].data.ptr;
+
+            if (tag == &listen_tag)
+                server_accept(epfd, listen_fd);
+            else if (tag == &waiter_tag)
+                server_jobs(epfd, &w, runner);
+            else
+            {
+                server_client *c = tag;
+
+                if (c->closing)
+                    continue;
+
+                if (events[i].events & (EPOLLERR | EPOLLHUP))
+                    client_dead(epfd, c);
+                else if (events[i].events & EPOLLIN)
+                    client_read(epfd, &w, c, runner);
+                else if (events[i].events & EPOLLOUT)
+                    client_write(epfd, &w, c);
+            }
+        }
+
+        server_release_clients();
+    }
+
+    for (server_client *c = clients; c; c = c->next)
+    {
+        if (!c->j)
+            continue;
+
+        if (c->j->pgid > 0)
+            kill(-c->j->pgid, SIGKILL);
+
+        for (process *p = c->j->first_process; p; p = p->next)
+            if (p->pid > 0 && !is_process_completed(p))
+                while (waitpid(p->pid, NULL, 0) < 0 && errno == EINTR);
+
+        if (c->j->out_fd >= 0)
+        {
+            close(c->j->out_fd);
+            release_capture_fd();
+            c->j->out_fd = -1;
+        }
+    }
+
+    sigaction(SIGTERM, &old_term, NULL);
+    job_waiter_close(&w);
+
+    for (server_client *c = clients; c; c = c->next)
+    {
+        if (c->j)
+            remove_job(c->j);
+
+        c->j = NULL;
+        c->closing = 1;
+    }
+
+    server_release_clients();
+
+    close(epfd);
+    close(listen_fd);
+    unlink(path);
+
+    return 0;
+}
@@ -0,0 +1,236 @@
+/**
+ * @file JobShm.c
+ * @author Bottini, Franco Nicolas.
+ * @brief Implementacion de la tabla de trabajos publicada en memoria compartida.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../../inc/Job/JobShm.h"
+
+#define JOB_SHM_OPEN_FLAGS (O_RDWR | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC)
+
+static job_shm_table *table = NULL;
+static pid_t owner = 0;
+static char table_path[64];
+static int next_slot = 0;
+
+static void remove_table(void)
+{
+    if (table && owner == getpid())
+        unlink(table_path);
+}
+
+void job_shm_init(void)
+{
+    char *enabled = getenv(JOB_SHM_ENV_VAR);
+    int fd;
+
+    /* La tabla heredada de la shell que hizo fork es de esa shell: se deja de publicar en ella */
+    if (table && owner != getpid())
+    {
+        munmap(table, sizeof(job_shm_table));
+        table = NULL;
+    }
+
+    if (table || !enabled || !*enabled || !strcmp(enabled, "0"))
+        return;
+
+    snprintf(table_path, sizeof(table_path), JOB_SHM_PATH, (int)getpid());
+
+    /* Solo se usa un archivo creado aqui, legible solo por el usuario. El de una shell anterior con el mismo pid
+       que no llego a borrarlo se reemplaza; un enlace simbolico en su lugar tambien se borra, sin seguirlo */
+    fd = open(table_path, JOB_SHM_OPEN_FLAGS, 0600);
+
+    if (fd < 0 && errno == EEXIST && unlink(table_path) == 0)
+        fd = open(table_path, JOB_SHM_OPEN_FLAGS, 0600);
+
+    if (fd < 0)
+    {
+        fprintf(stderr, KRED"\n%s: %s !\n\n"KDEF, table_path, strerror(errno));
+        return;
+    }
+
+    if (ftruncate(fd, sizeof(job_shm_table)) < 0
+        || (table = mmap(NULL, sizeof(job_shm_table), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED)
+    {
+        fprintf(stderr, KRED"\n%s: %s !\n\n"KDEF, table_path, strerror(errno));
+        unlink(table_path);
+        table = NULL;
+        close(fd);
+        return;
+    }
+
+    close(fd);
+
+    /* El archivo recien creado ya esta en cero: todas las filas estan libres */
+    table->version = JOB_SHM_VERSION;
+    table->entry_size = sizeof(job_shm_entry);
+    table->n_slots = JOB_SHM_SLOTS;
+    table->shell_pid = getpid();
+    table->updated = get_monotonic_ns();
+    atomic_thread_fence(memory_order_release);
+    table->magic = JOB_SHM_MAGIC;
+
+    if (!owner)
+        atexit(remove_table);
+
+    owner = getpid();
+    next_slot = 0;
+}
+
+static sigset_t write_mask;
+
+static void write_begin(void)
+{
+    sigset_t set;
+    uint64_t seq;
+
+    sigemptyset(&set);
+    sigaddset(&set, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &set, &write_mask);
+
+    seq = atomic_load_explicit(&table->seq, memory_order_relaxed);
+    atomic_store_explicit(&table->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static void write_end(void)
+{
+    uint64_t seq = atomic_load_explicit(&table->seq, memory_order_relaxed);
+
+    table->updated = get_monotonic_ns();
+    atomic_store_explicit(&table->seq, seq + 1, memory_order_release);
+
+    sigprocmask(SIG_SETMASK, &write_mask, NULL);
+}
+
+static int alloc_slot(void)
+{
+    for (int n = 0; n < JOB_SHM_SLOTS; n++)
+    {
+        int slot = (next_slot + n) % JOB_SHM_SLOTS;
+
+        if (!table->entries[slot].job_id)
+        {
+            next_slot = (slot + 1) % JOB_SHM_SLOTS;
+            table->used++;
+
+            return slot;
+        }
+    }
+
+    table->overflow++;
+
+    return -1;
+}
+
+static void copy_command(char *command, process *p)
+{
+    size_t len = 0;
+
+    for (int i = 0; i < p->argc && len < JOB_SHM_COMMAND_LEN - 1; i++)
+    {
+        size_t n = strlen(p->argv[i]);
+
+        if (i)
+            command[len++] = ASCII_SPACE;
+
+        if (n > JOB_SHM_COMMAND_LEN - 1 - len)
+            n = JOB_SHM_COMMAND_LEN - 1 - len;
+
+        memcpy(command + len, p->argv[i], n);
+        len += n;
+    }
+
+    command[len] = ASCII_END_OF_STRING;
+}
+
+static void write_entry(job *j, process *p)
+{
+    job_shm_entry *e;
+
+    if (p->shm_slot < 0)
+    {
+        if ((p->shm_slot = alloc_slot()) < 0)
+            return;
+
+        e = &table->entries[p->shm_slot];
+        e->job_id = j->id;
+        copy_command(e->command, p);
+    }
+
+    e = &table->entries[p->shm_slot];
+    e->pgid = j->pgid;
+    e->pid = p->pid;
+    e->status = p->status;
+    e->exit_code = p->exit_code;
+    e->mode = j->mode;
+    e->start_time = j->start_time;
+    e->utime_us = p->usage.ru_utime.tv_sec * 1000000ULL + p->usage.ru_utime.tv_usec;
+    e->stime_us = p->usage.ru_stime.tv_sec * 1000000ULL + p->usage.ru_stime.tv_usec;
+    e->maxrss_kb = p->usage.ru_maxrss;
+}
+
+void job_shm_publish(job *j, process *p)
+{
+    if (!table || !j || owner != getpid())
+        return;
+
+    write_begin();
+
+    if (p)
+        write_entry(j, p);
+    else
+        for (p = j->first_process; p; p = p->next)
+            write_entry(j, p);
+
+    write_end();
+}
+
+void job_shm_release(job *j)
+{
+    int published = 0;
+
+    if (!table || owner != getpid())
+        return;
+
+    for (process *p = j->first_process; p; p = p->next)
+    {
+        if (p->shm_slot < 0)
+            continue;
+
+        if (!published++)
+            write_begin();
+
+        memset(&table->entries[p->shm_slot], 0, sizeof(job_shm_entry));
+        table->used--;
+        p->shm_slot = -1;
+    }
+
+    if (published)
+        write_end();
+}
+
+int job_shm_snapshot(const job_shm_table *shared, job_shm_table *copy)
+{
+    uint64_t before, after;
+
+    if (shared->magic != JOB_SHM_MAGIC || shared->version != JOB_SHM_VERSION || shared->entry_size != sizeof(job_shm_entry))
+        return -1;
+
+    do
+    {
+        while ((before = atomic_load_explicit((_Atomic uint64_t*)&shared->seq, memory_order_acquire)) & 1)
+            sched_yield();
+
+        memcpy(copy, shared, sizeof(job_shm_table));
+        atomic_thread_fence(memory_order_acquire);
+        after = atomic_load_explicit((_Atomic uint64_t*)&shared->seq, memory_order_relaxed);
+    } while (before != after);
+
+    return 0;
+}
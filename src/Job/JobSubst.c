@@ -0,0 +1,251 @@
+/**
+ * @file JobSubst.c
+ * @author Bottini, Franco Nicolas.
+ * @brief Implementacion de la sustitucion de comandos.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../../inc/Job/JobSubst.h"
+
+static int is_field_separator(char c)
+{
+    return c == ASCII_SPACE || c == ASCII_TAB || c == ASCII_LINE_BREAK;
+}
+
+int capture_job_output(char *command, job_builder builder, job_buffer *out, job_buffer *err)
+{
+    uint64_t t_subst = trace_begin();
+    job_waiter w;
+    job *j = builder(command);
+    int code;
+
+    if (!j->first_process)
+    {
+        free_job(j);
+        return EXIT_FAILURE;
+    }
+
+    if (job_waiter_init(&w) < 0)
+    {
+        fprintf(stderr, KRED"\nepoll: %s !\n\n"KDEF, strerror(errno));
+        free_job(j);
+        return EXIT_FAILURE;
+    }
+
+    j->managed = 1;
+    launch_job(j, BACKGROUND_EXECUTION);
+
+    if (job_waiter_add(&w, j) == 0)
+        job_waiter_next(&w);
+
+    block_sigchld();
+    job_waiter_close(&w);
+
+    if (is_job_completed(j))
+    {
+        code = get_job_exit_code(j);
+        append_job_buffer(out, j->out.data, j->out.len);
+
+        if (err && j->err.len)
+            append_job_buffer(err, j->err.data, j->err.len);
+        metrics_job_reaped(get_monotonic_ns() - j->start_time);
+        remove_job(j);
+    }
+    else
+    {
+        code = 128 + SIGINT;
+        abort_managed_job(j);
+    }
+
+    unblock_sigchld();
+
+    trace_end("substitution", t_subst);
+
+    return code;
+}
+
+static void append_fields(job_buffer *b, job_buffer *output)
+{
+    size_t i = 0;
+    int first = 1;
+
+    while (i < output->len)
+    {
+        while (i < output->len && is_field_separator(output->data[i]))
+            i++;
+
+        size_t start = i;
+
+        while (i < output->len && !is_field_separator(output->data[i]))
+            i++;
+
+        if (i == start)
+            break;
+
+        if (!first)
+            append_job_buffer(b, " ", 1);
+
+        append_job_buffer(b, output->data + start, i - start);
+        first = 0;
+    }
+}
+
+/* Retorna el final de la sustitucion que comienza en line, o NULL si no esta cerrada */
+static const char* find_substitution_end(const char *line)
+{
+    if (*line == ASCII_BACKTICK)
+        return strchr(line + 1, ASCII_BACKTICK);
+
+    return get_matching_paren((char*)line + 1);
+}
+
+/* Expande la variable que comienza en el '$' de line. Retorna la posicion siguiente, o NULL si no hay una variable */
+static const char* expand_variable(job_buffer *b, const char *line, variable_lookup lookup)
+{
+    const char *name = line + 1;
+    const char *next;
+    char buffer[SUBST_MAX_NAME];
+    size_t len = 0;
+
+    if (*name == '{')
+    {
+        if (!(next = strchr(++name, '}')))
+            return NULL;
+
+        len = next++ - name;
+    }
+    else if (isalpha((unsigned char)*name) || *name == '_')
+    {
+        while (isalnum((unsigned char)name[len]) || name[len] == '_')
+            len++;
+
+        next = name + len;
+    }
+    else if (*name && (isdigit((unsigned char)*name) || strchr("?#@*$", *name)))
+        next = name + (len = 1);
+    else
+        return NULL;
+
+    if (!len || len >= sizeof(buffer))
+        return NULL;
+
+    memcpy(buffer, name, len);
+    buffer[len] = ASCII_END_OF_STRING;
+
+    const char *value = lookup(buffer);
+
+    if (value)
+        append_job_buffer(b, value, strlen(value));
+
+    return next;
+}
+
+/* Indica si la sustitucion $(...) que comienza en line y termina en end es una expansion aritmetica $((...)) */
+static int is_arithmetic(const char *line, const char *end)
+{
+    return line[2] == ASCII_OPEN_PAREN && get_matching_paren((char*)line + 2) == end - 1;
+}
+
+/* Expande y evalua la expresion de $((...)), agregando su resultado. Retorna -1 si es invalida */
+static int expand_arithmetic(job_buffer *b, const char *line, const char *end, const expansion_hooks *hooks)
+{
+    char *inner = strndup(line + 3, end - line - 4);
+    char *expr = expand_substitutions(inner, hooks);
+    char number[32];
+    long value;
+    int result = -1;
+
+    if (expr && hooks->arith(expr, hooks->lookup, &value) == 0)
+    {
+        append_job_buffer(b, number, snprintf(number, sizeof(number), "%ld", value));
+        result = 0;
+    }
+
+    free(expr);
+    free(inner);
+
+    return result;
+}
+
+char* expand_substitutions(const char *line, const expansion_hooks *hooks)
+{
+    job_buffer result = {0};
+
+    while (*line)
+    {
+        size_t len = strcspn(line, "$`");
+
+        append_job_buffer(&result, line, len);
+        line += len;
+
+        if (!*line)
+            break;
+
+        if (*line == ASCII_MONEY_SIGN && line[1] != ASCII_OPEN_PAREN)
+        {
+            const char *next = hooks->lookup ? expand_variable(&result, line, hooks->lookup) : NULL;
+
+            if (next)
+                line = next;
+            else
+                append_job_buffer(&result, line++, 1);
+
+            continue;
+        }
+
+        const char *end = find_substitution_end(line);
+
+        if (!end)
+        {
+            fprintf(stderr, KRED"\nUnterminated command substitution !\n\n"KDEF);
+            free(result.data);
+            return NULL;
+        }
+
+        if (*line == ASCII_MONEY_SIGN && hooks->arith && is_arithmetic(line, end))
+        {
+            if (expand_arithmetic(&result, line, end, hooks) < 0)
+            {
+                free(result.data);
+                return NULL;
+            }
+
+            line = end + 1;
+            continue;
+        }
+
+        int skip = *line == ASCII_BACKTICK ? 1 : 2;
+        char *inner = strndup(line + skip, end - line - skip);
+        char *command = expand_substitutions(inner, hooks);
+
+        free(inner);
+
+        if (!command)
+        {
+            free(result.data);
+            return NULL;
+        }
+
+        job_buffer output = {0};
+        char *trimmed = trim_white_space(command);
+
+        /* Como en sh, $? queda con el codigo de la ultima sustitucion hasta que se ejecuta el comando */
+        if (trimmed)
+            last_exit_status = hooks->run(trimmed, &output);
+
+        append_fields(&result, &output);
+
+        free(output.data);
+        free(command);
+
+        line = end + 1;
+    }
+
+    append_job_buffer(&result, "", 1);
+
+    return result.data;
+}
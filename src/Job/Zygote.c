@@ -0,0 +1,346 @@
+/**
+ * @file Zygote.c
+ * @author Bottini, Franco Nicolas.
+ * @brief Implementacion del proceso auxiliar de creacion de procesos.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../../inc/Job/Zygote.h"
+
+extern char **environ;
+
+static int zygote_fd = -1;
+static pid_t zygote_pid = -1;
+
+static void zygote_child(zygote_request *req, char **argv, char **envp, int *fds)
+{
+    pid_t pgid = req->pgid ? req->pgid : getpid();
+    int err;
+
+    if (pgid > 0)
+        setpgid(0, pgid);
+
+    if (req->foreground)
+    {
+        write(STDOUT_FILENO, KYEL"\n", strlen(KYEL"\n"));
+        tcsetpgrp(STDIN_FILENO, pgid);
+    }
+
+    signal(SIGINT, SIG_DFL);
+    signal(SIGQUIT, SIG_DFL);
+    signal(SIGTSTP, SIG_DFL);
+    signal(SIGTTIN, SIG_DFL);
+    signal(SIGTTOU, SIG_DFL);
+
+    sigset_t set;
+    sigemptyset(&set);
+    sigprocmask(SIG_SETMASK, &set, NULL);
+
+    fchdir(fds[4]);
+
+    for (int i = 0; i < 3; i++)
+        dup2(fds[i], i);
+
+    restore_fd_limit();
+
+    environ = envp;
+    execvp(argv[0], argv);
+
+    err = errno;
+    write(fds[3], &err, sizeof(err));
+    dprintf(STDERR_FILENO, "Command not found!\n");
+    _exit(EXIT_FAILURE);
+}
+
+static pid_t zygote_handle(zygote_request *req, char *payload, size_t len, int *fds)
+{
+    int count = req->argc + req->envc;
+    size_t off = 0;
+    pid_t pid;
+
+    if (req->argc < 1 || req->envc < 0 || req->len != len || (len && payload[len - 1] != ASCII_END_OF_STRING))
+        return -EINVAL;
+
+    char **vec = malloc((count + 2) * sizeof(char*));
+
+    if (!vec)
+        return -ENOMEM;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (off >= len)
+        {
+            free(vec);
+            return -EINVAL;
+        }
+
+        vec[i + (i >= req->argc)] = payload + off;
+        off += strlen(payload + off) + 1;
+    }
+
+    vec[req->argc] = NULL;
+    vec[count + 1] = NULL;
+
+    pid = syscall(SYS_clone, CLONE_PARENT | SIGCHLD, 0, NULL, NULL, 0);
+
+    if (pid == 0)
+        zygote_child(req, vec, vec + req->argc + 1, fds);
+
+    free(vec);
+
+    return pid < 0 ? -errno : pid;
+}
+
+static void zygote_main(int fd)
+{
+    static char payload[ZYGOTE_MAX_REQUEST];
+    union {
+        char buf[CMSG_SPACE(sizeof(int) * ZYGOTE_FDS)];
+        struct cmsghdr align;
+    } control;
+
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+
+    signal(SIGCHLD, SIG_DFL);
+    signal(SIGINT, SIG_IGN);
+    signal(SIGQUIT, SIG_IGN);
+    signal(SIGTSTP, SIG_IGN);
+    signal(SIGTTIN, SIG_IGN);
+    signal(SIGTTOU, SIG_IGN);
+
+    if (fd > 3)
+        close_range(3, fd - 1, 0);
+
+    close_range(fd + 1, ~0U, 0);
+
+    while (1)
+    {
+        zygote_request req;
+        int fds[ZYGOTE_FDS];
+        int nfds = 0;
+        pid_t reply;
+
+        struct iovec iov[2] = {
+            { .iov_base = &req, .iov_len = sizeof(req) },
+            { .iov_base = payload, .iov_len = sizeof(payload) }
+        };
+        struct msghdr msg = {
+            .msg_iov = iov,
+            .msg_iovlen = 2,
+            .msg_control = control.buf,
+            .msg_controllen = sizeof(control.buf)
+        };
+
+        ssize_t n = recvmsg(fd, &msg, MSG_CMSG_CLOEXEC);
+
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        if (n <= 0)
+            _exit(EXIT_SUCCESS);
+
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+        {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+            {
+                nfds = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+
+                if (nfds > ZYGOTE_FDS)
+                    nfds = ZYGOTE_FDS;
+
+                memcpy(fds, CMSG_DATA(cmsg), nfds * sizeof(int));
+            }
+        }
+
+        if (nfds != ZYGOTE_FDS || (msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) || (size_t)n < sizeof(req))
+            reply = -EINVAL;
+        else
+            reply = zygote_handle(&req, payload, n - sizeof(req), fds);
+
+        for (int i = 0; i < nfds; i++)
+            close(fds[i]);
+
+        while (send(fd, &reply, sizeof(reply), MSG_NOSIGNAL) < 0 && errno == EINTR);
+    }
+}
+
+int zygote_start(void)
+{
+    int sv[2];
+
+    if (zygote_fd >= 0)
+        return 0;
+
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sv) < 0)
+        return -1;
+
+    pid_t pid = fork();
+
+    if (pid == 0)
+    {
+        close(sv[0]);
+        zygote_main(sv[1]);
+    }
+
+    close(sv[1]);
+
+    if (pid < 0)
+    {
+        close(sv[0]);
+        return -1;
+    }
+
+    zygote_fd = sv[0];
+    zygote_pid = pid;
+
+    return 0;
+}
+
+void zygote_stop(void)
+{
+    sigset_t set, old;
+    pid_t pid = zygote_pid;
+
+    if (zygote_fd < 0)
+        return;
+
+    sigemptyset(&set);
+    sigaddset(&set, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &set, &old);
+
+    close(zygote_fd);
+    zygote_fd = -1;
+    zygote_pid = -1;
+
+    while (pid > 0 && waitpid(pid, NULL, 0) < 0 && errno == EINTR);
+
+    sigprocmask(SIG_SETMASK, &old, NULL);
+}
+
+void zygote_forget(void)
+{
+    if (zygote_fd >= 0)
+        close(zygote_fd);
+
+    zygote_fd = -1;
+    zygote_pid = -1;
+}
+
+int zygote_enabled(void)
+{
+    return zygote_fd >= 0;
+}
+
+int zygote_exited(pid_t pid)
+{
+    if (pid <= 0 || pid != zygote_pid)
+        return 0;
+
+    close(zygote_fd);
+    zygote_fd = -1;
+    zygote_pid = -1;
+
+    return 1;
+}
+
+pid_t zygote_spawn(process *p, pid_t pgid, int in_fd, int out_fd, int err_fd, int status_fd, EXECUTION_MODES mode)
+{
+    zygote_request req = {
+        .pgid = pgid,
+        .foreground = mode == FOREGROUND_EXECUTION && pgid >= 0
+    };
+    size_t len = 0;
+    pid_t reply;
+    ssize_t n;
+    char **envp = p->env ? env_block_with(p->env) : env_block();
+
+    for (char **s = p->argv; *s; s++, req.argc++)
+        len += strlen(*s) + 1;
+
+    for (char **s = envp; *s; s++, req.envc++)
+        len += strlen(*s) + 1;
+
+    char *payload = len <= ZYGOTE_MAX_REQUEST ? malloc(len ? len : 1) : NULL;
+    char *out = payload;
+
+    if (payload)
+    {
+        for (char **s = p->argv; *s; s++)
+            out = stpcpy(out, *s) + 1;
+
+        for (char **s = envp; *s; s++)
+            out = stpcpy(out, *s) + 1;
+    }
+
+    if (p->env)
+        free(envp);
+
+    if (!payload)
+    {
+        if (len > ZYGOTE_MAX_REQUEST)
+            errno = E2BIG;
+
+        return -1;
+    }
+
+    req.len = len;
+
+    int cwd = open(".", O_PATH | O_DIRECTORY | O_CLOEXEC);
+
+    if (cwd < 0)
+    {
+        free(payload);
+        return -1;
+    }
+
+    int fds[ZYGOTE_FDS] = { in_fd, out_fd, err_fd, status_fd, cwd };
+    union {
+        char buf[CMSG_SPACE(sizeof(fds))];
+        struct cmsghdr align;
+    } control;
+
+    struct iovec iov[2] = {
+        { .iov_base = &req, .iov_len = sizeof(req) },
+        { .iov_base = payload, .iov_len = len }
+    };
+    struct msghdr msg = {
+        .msg_iov = iov,
+        .msg_iovlen = 2,
+        .msg_control = control.buf,
+        .msg_controllen = sizeof(control.buf)
+    };
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    while ((n = sendmsg(zygote_fd, &msg, MSG_NOSIGNAL)) < 0 && errno == EINTR);
+
+    close(cwd);
+    free(payload);
+
+    if (n < 0)
+        return -1;
+
+    while ((n = recv(zygote_fd, &reply, sizeof(reply), 0)) < 0 && errno == EINTR);
+
+    if (n != sizeof(reply))
+    {
+        errno = EPIPE;
+        return -1;
+    }
+
+    if (reply < 0)
+    {
+        errno = -reply;
+        return -1;
+    }
+
+    return reply;
+}
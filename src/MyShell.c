@@ -11,16 +11,57 @@
 
 #include "../inc/MyShell.h"
 
+static job_buffer pending_script = {0};
+static const expansion_hooks expansions = { substitute_command, script_variable, evaluate_arithmetic };
+
+/* Prepara una copia de la shell cuya salida es un pipe compartido con sus trabajos. Los builtins escriben por stdio
+   y los trabajos directo en el pipe: se vacia cada linea para no desordenarlos */
+static void share_output_with_jobs(void)
+{
+    setvbuf(stdout, NULL, _IOLBF, 0);
+}
+
+/* Ejecuta una linea recibida por el servidor en la copia de la shell creada para ella, como si se pasara con -c */
+static int server_command(char* command)
+{
+    share_output_with_jobs();
+
+    return myshell_run_command(command);
+}
+
 int main(int argc, char* argv[])
 {
     FILE* source;
 
-    myshell_validate_execution(argc);
-    job_control_init();
+    trace_init();
+    script_init(input_decode, &expansions);
+
+    if (argc == 3 && !strcmp(argv[1], SERVER_OPTION))
+    {
+        job_control_init_headless();
+        stdin_reserved = 1;
+        return run_server(argv[2], server_command) < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    if (argc > 2 && strcmp(argv[1], COMMAND_OPTION))
+        return myshell_run_batches(argc - 1, argv + 1);
+
+    myshell_validate_execution(argc, argv);
+
+    if (argc == 3)
+    {
+        job_control_init_headless();
+        return myshell_run_command(argv[2]);
+    }
 
     source = command_source(argc, argv);
 
-    if (source == stdin)
+    if (isatty(STDIN_FILENO))
+        job_control_init();
+    else
+        job_control_init_headless();
+
+    if (source == stdin && job_control_interactive)
         print_welcome();
         
     myshell_loop(source);
@@ -35,55 +76,338 @@ void print_welcome()
     fprintf(stdout, "Built-in Commands:\n");
     fprintf(stdout, "   * cd  : change current working directory\n");
     fprintf(stdout, "   * quit: terminate the shell\n");
-    fprintf(stdout, "   * jobs: list all current jobs\n");
+    fprintf(stdout, "   * jobs: list all current jobs (--json, -r, -s, -p, --since NS)\n");
     fprintf(stdout, "   * fg  : reanude foreground job execution\n");
+    fprintf(stdout, "   * bg  : reanude background job execution\n");
+    fprintf(stdout, "   * wait: wait for all jobs, given jobs (%%N) or the first to finish (-n)\n");
     fprintf(stdout, "   * kill: terminate job or process\n");
     fprintf(stdout, "   * clr : clear terminal\n");
     fprintf(stdout, "   * echo: print in terminal message or enviroment variable value\n");
+    fprintf(stdout, "   * parallel: run a command template over many arguments (-j N, --tag, --keep-order)\n");
+    fprintf(stdout, "   * stats: show shell-internal counters and latency histograms (--json)\n");
+    fprintf(stdout, "   * zygote: spawn processes through a pre-forked helper (on | off)\n");
+    fprintf(stdout, "   * sched: cap and order queued background jobs (-n N, fifo | priority, -p N cmd &)\n");
+    fprintf(stdout, "   * after: run a background job when the given jobs succeed (after %%N ... cmd &)\n");
+    fprintf(stdout, "   * coproc: run a command with its input and output piped to the shell (-u NAME, -c)\n");
+    fprintf(stdout, "   * write: send a line to a coprocess (write [-u NAME] text)\n");
+    fprintf(stdout, "   * read: print the next line from a coprocess (read [-u NAME] [-t secs])\n");
+    fprintf(stdout, "   * test, [ ]: evaluate a condition in-process (-n, -z, -f, -d, =, !=, -eq, -lt, ...)\n");
+    fprintf(stdout, "   * true, false: succeed or fail without spawning a process\n");
     fprintf(stdout, "Implement job control\n");
     fprintf(stdout, "Run externed programs either in foreground or background (&)\n");
     fprintf(stdout, "Create pipeline using pipe operator (|)\n");
     fprintf(stdout, "Ctrl-C, Ctrl-Z and Ctrl-\\ signal handling in jobs\n");
-    fprintf(stdout, "Standard input/output redirection operators: < and >\n\n");
+    fprintf(stdout, "Standard input/output redirection operators: < and >\n");
+    fprintf(stdout, "Control flow: if/elif/else, while, until, for ... in, case, functions, && and ||\n\n");
     fprintf(stdout, KDEF);
 }
 
-void myshell_validate_execution(int argc)
+void myshell_validate_execution(int argc, char* argv[])
 {
-    if(argc > 2)
+    if(argc > 3 || (argc == 3 && strcmp(argv[1], COMMAND_OPTION)) || (argc == 2 && !strcmp(argv[1], COMMAND_OPTION)))
     {
         fprintf(stderr, KRED"\nOnly one input argument is allowed !\n"KDEF);
-        fprintf(stderr, KBLU"Input argument: batchfile.\n\n"KDEF);
+        fprintf(stderr, KBLU"Input argument: batchfile, %s 'command' or %s socket.\n"KDEF, COMMAND_OPTION, SERVER_OPTION);
+        fprintf(stderr, KBLU"Several batchfiles run concurrently: batchfile... [%s N].\n\n"KDEF, PARALLEL_OPTION);
+        exit(EXIT_FAILURE);
+    }
+}
+
+int myshell_run_command(char* command)
+{
+    char* line = trim_white_space(command);
+
+    if (!line)
+        return EXIT_SUCCESS;
+
+    if (!*find_chars(line, "|<>&;$`#*?[\n"))
+    {
+        char* args;
+        char* line_cpy = malloc(sizeof(char) * (strlen(line) + 1));
+        char* word;
+
+        strcpy(line_cpy, line);
+        word = strtok_r(line_cpy, " ", &args);
+
+        if (get_command_flag(word) == CMM_EXTERN && !is_script_keyword(word) && !strchr(word, '='))
+        {
+            int argc;
+            char** argv = str_to_array(line, &argc);
+
+            trace_flush();
+            execvp(argv[0], argv);
+
+            fprintf(stderr, "Command not found!\n");
+            exit(EXIT_FAILURE);
+        }
+
+        free(line_cpy);
+    }
+
+    if (input_script(line))
+        input_script_end();
+
+    return last_exit_status;
+}
+
+/* Lanza la sesion de un archivo de comandos, con la entrada en /dev/null y las salidas en pipes propios */
+static int start_session(batch_session* sessions, int n, int i)
+{
+    int out[2], err[2];
+    batch_session* s = &sessions[i];
+
+    if (pipe2(out, O_CLOEXEC) < 0)
+        return -1;
+
+    if (pipe2(err, O_CLOEXEC) < 0)
+    {
+        close(out[0]);
+        close(out[1]);
+        return -1;
+    }
+
+    if ((s->pid = fork()) < 0)
+    {
+        close(out[0]); close(out[1]);
+        close(err[0]); close(err[1]);
+        return -1;
+    }
+
+    if (s->pid == 0)
+    {
+        int null = open("/dev/null", O_RDONLY);
+        FILE* source;
+
+        for (int j = 0; j < n; j++)
+        {
+            if (sessions[j].out_fd >= 0)
+                close(sessions[j].out_fd);
+
+            if (sessions[j].err_fd >= 0)
+                close(sessions[j].err_fd);
+        }
+
+        dup2(null, STDIN_FILENO);
+        dup2(out[1], STDOUT_FILENO);
+        dup2(err[1], STDERR_FILENO);
+        close(null);
+
+        share_output_with_jobs();
+
+        if (!(source = fopen(s->path, "r")))
+        {
+            fprintf(stderr, KRED"\n%s: %s\n\n"KDEF, s->path, strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+
+        job_control_init_headless();
+        myshell_loop(source);
+        exit(last_exit_status);
+    }
+
+    close(out[1]);
+    close(err[1]);
+    s->out_fd = out[0];
+    s->err_fd = err[0];
+
+    return 0;
+}
+
+static void write_all(int fd, const char* data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = write(fd, data, len);
+
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        if (n <= 0)
+            return;
+
+        data += n;
+        len -= n;
+    }
+}
+
+/* Lee lo disponible de una salida: la sesion en turno la emite y las demas la acumulan */
+static void read_session(batch_session* s, int* fd, job_buffer* b, int target, int streaming)
+{
+    char buffer[JOB_OUTPUT_CHUNK];
+    ssize_t n = read(*fd, buffer, sizeof(buffer));
+
+    if (n < 0 && errno == EINTR)
+        return;
+
+    if (n <= 0)
+    {
+        close(*fd);
+        *fd = -1;
+        return;
+    }
+
+    if (streaming)
+        write_all(target, buffer, n);
+    else
+        append_job_buffer(b, buffer, n);
+}
+
+int myshell_run_batches(int argc, char* argv[])
+{
+    batch_session* sessions = calloc(argc, sizeof(batch_session));
+    struct pollfd* fds = calloc(argc * 2, sizeof(struct pollfd));
+    long max_sessions = sysconf(_SC_NPROCESSORS_ONLN);
+    int n = 0, next = 0, head = 0, running = 0, failed = 0;
+
+    for (int i = 0; i < argc; i++)
+    {
+        if (!strcmp(argv[i], PARALLEL_OPTION))
+        {
+            if (i + 1 >= argc || (max_sessions = atoi(argv[++i])) < 1)
+            {
+                fprintf(stderr, KRED"\nUsage: MyShell batchfile... [%s N] !\n\n"KDEF, PARALLEL_OPTION);
+                exit(EXIT_FAILURE);
+            }
+        }
+        else
+            sessions[n++] = (batch_session){ argv[i], -1, -1, -1, { NULL, 0, 0 }, { NULL, 0, 0 }, 0, 0 };
+    }
+
+    if (!n)
+    {
+        fprintf(stderr, KRED"\nUsage: MyShell batchfile... [%s N] !\n\n"KDEF, PARALLEL_OPTION);
         exit(EXIT_FAILURE);
     }
+
+    while (head < n)
+    {
+        int nfds = 0;
+
+        while (running < max_sessions && next < n)
+        {
+            if (start_session(sessions, n, next) < 0)
+            {
+                fprintf(stderr, KRED"\n%s: %s !\n\n"KDEF, sessions[next].path, strerror(errno));
+                sessions[next].status = EXIT_FAILURE;
+                sessions[next].done = 1;
+            }
+            else
+                running++;
+
+            next++;
+        }
+
+        /* La sesion en turno emite lo acumulado y pasa a transmitir; al finalizar cede el turno a la siguiente */
+        while (head < n && (sessions[head].out.len || sessions[head].err.len || sessions[head].done))
+        {
+            batch_session* s = &sessions[head];
+
+            write_all(STDOUT_FILENO, s->out.data, s->out.len);
+            write_all(STDERR_FILENO, s->err.data, s->err.len);
+            s->out.len = s->err.len = 0;
+
+            if (!s->done)
+                break;
+
+            free(s->out.data);
+            free(s->err.data);
+            head++;
+        }
+
+        for (int i = head; i < next; i++)
+        {
+            if (sessions[i].out_fd >= 0)
+                fds[nfds++] = (struct pollfd){ sessions[i].out_fd, POLLIN, 0 };
+
+            if (sessions[i].err_fd >= 0)
+                fds[nfds++] = (struct pollfd){ sessions[i].err_fd, POLLIN, 0 };
+        }
+
+        if (nfds && poll(fds, nfds, -1) < 0 && errno != EINTR)
+            break;
+
+        for (int i = head; i < next; i++)
+        {
+            batch_session* s = &sessions[i];
+
+            for (int k = 0; k < nfds; k++)
+            {
+                if (!fds[k].revents)
+                    continue;
+
+                if (fds[k].fd == s->out_fd)
+                    read_session(s, &s->out_fd, &s->out, STDOUT_FILENO, i == head);
+                else if (fds[k].fd == s->err_fd)
+                    read_session(s, &s->err_fd, &s->err, STDERR_FILENO, i == head);
+            }
+
+            if (!s->done && s->pid > 0 && s->out_fd < 0 && s->err_fd < 0)
+            {
+                int status;
+
+                while (waitpid(s->pid, &status, 0) < 0 && errno == EINTR);
+
+                s->status = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+                s->done = 1;
+                running--;
+            }
+        }
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        if (sessions[i].status)
+        {
+            fprintf(stderr, KRED"\n%s: exit status %d !\n"KDEF, sessions[i].path, sessions[i].status);
+            failed++;
+        }
+    }
+
+    free(sessions);
+    free(fds);
+
+    return failed > PARALLEL_MAX_EXIT ? PARALLEL_MAX_EXIT : failed;
 }
 
 void myshell_loop(FILE* input_source)
 {
     READ_INPUT_RESULT read_result = INP_NULL;
+    int interactive = input_source == stdin && job_control_interactive;
+    int pending = 0;
+
+    stdin_reserved = input_source == stdin;
 
     while (1)
     {
-        char* input_buffer = malloc(MAX_LEN_INPUT * sizeof(char));
+        char* input_buffer = malloc((MAX_LEN_INPUT + 1) * sizeof(char));
 
-        if(input_source == stdin && (read_result != INP_END || flag_work_tube_printed))
+        process_job_changes();
+        drain_job_output();
+
+        if(interactive && (read_result != INP_END || flag_work_tube_printed))
         {
-            print_prompt();
+            if (pending)
+                fprintf(stdout, KGRN"> "KDEF);
+            else
+                print_prompt();
+
             flag_work_tube_printed = 0;
         }    
         
+        uint64_t t_input = trace_begin();
         read_result = get_input(input_buffer, MAX_LEN_INPUT, input_source);
+        trace_end("get_input", t_input);
 
         if (read_result == INP_READ)
         {
             if(input_source != stdin)
                 fprintf(stdout, KDEF"> %s\n", input_buffer);
 
-            input_decode(input_buffer);
+            pending = input_script(input_buffer);
         }
         else
         {
-            if(input_source != stdin)
+            if(!interactive)
             {
                 if(read_result != INP_EMPTY_LINE)
                 {
@@ -91,8 +415,16 @@ void myshell_loop(FILE* input_source)
 
                     if(read_result == INP_END)
                     {
-                        while(first_job);
-                        exit(EXIT_SUCCESS);
+                        int status;
+
+                        input_script_end();
+                        status = last_exit_status;
+
+                        /* La shell finaliza despues que sus trabajos en segundo plano, con el codigo del script. Un
+                           coproceso espera su entrada hasta que la shell la cierra */
+                        coproc_free_all();
+                        wait_jobs(NULL, 0, 0);
+                        exit(status);
                     }
                         
                     if(read_result == INP_TO_LONG)
@@ -109,7 +441,7 @@ void myshell_loop(FILE* input_source)
 
 void print_prompt(void)
 {
-    fprintf(stdout, KGRN"%s@%s~$ "KDEF, getenv("USER"), getenv("PWD"));
+    fprintf(stdout, KGRN"%s@%s~$ "KDEF, env_get("USER"), env_get("PWD"));
 }
 
 FILE* command_source(int argc, char* argv[])
@@ -152,27 +484,166 @@ READ_INPUT_RESULT get_input(char* buffer, int buffer_size, FILE* fp)
     return INP_READ;
 }
 
+int input_script(char* input)
+{
+    script_node* tree;
+
+    append_job_buffer(&pending_script, input, strlen(input));
+    append_job_buffer(&pending_script, "\n", 2);
+    pending_script.len--;
+
+    uint64_t t_parse = trace_begin();
+    SCRIPT_PARSE_RESULT result = script_parse(pending_script.data, &tree);
+    trace_end("script_parse", t_parse);
+
+    if (result == PARSE_INCOMPLETE)
+        return 1;
+
+    pending_script.len = 0;
+
+    if (result == PARSE_OK)
+    {
+        execute_script(tree);
+        free_script(tree);
+    }
+    else
+        last_exit_status = 2;
+
+    return 0;
+}
+
+void input_script_end(void)
+{
+    if (!pending_script.len)
+        return;
+
+    fprintf(stderr, KRED"\nSyntax error: unexpected end of file !\n\n"KDEF);
+    pending_script.len = 0;
+    last_exit_status = 2;
+}
+
+/* Ejecuta un builtin precedido por asignaciones 'NAME=valor', que solo valen durante el builtin. Una linea
+   formada solo por asignaciones las guarda en la shell. Retorna 0 si el comando es externo y debe lanzarse */
+static int input_assignments(const char* input)
+{
+    char* line = strdup(input);
+    char* args;
+    char* word = strtok_r(line, " ", &args);
+    char** words = NULL;
+    int n = 0;
+
+    while (word && env_assignment(word))
+    {
+        words = realloc(words, sizeof(char*) * (n + 1));
+        words[n++] = word;
+        word = strtok_r(NULL, " ", &args);
+    }
+
+    COMMANDS_FLAGS flag = word ? get_command_flag(word) : CMM_EXTERN;
+
+    if (word && flag == CMM_EXTERN)
+    {
+        free(words);
+        free(line);
+        return 0;
+    }
+
+    if (!word)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            char* equal = strchr(words[i], '=');
+
+            *equal = ASCII_END_OF_STRING;
+            env_set(words[i], equal + 1);
+        }
+
+        last_exit_status = EXIT_SUCCESS;
+    }
+    else
+    {
+        env_saved* saved = malloc(sizeof(env_saved) * n);
+
+        for (int i = 0; i < n; i++)
+            env_push(words[i], &saved[i]);
+
+        last_exit_status = EXIT_SUCCESS;
+        command_handler(flag, args);
+
+        for (int i = n - 1; i >= 0; i--)
+            env_pop(&saved[i]);
+
+        free(saved);
+    }
+
+    free(words);
+    free(line);
+
+    return 1;
+}
+
 void input_decode(char* input)
 {
+    uint64_t t_decode = trace_begin();
     COMMANDS_FLAGS flag;
     char* command;
     char* args;
-    char* input_cpy = malloc(sizeof(char) * strlen(input));
+    char* expanded = NULL;
+    char* globbed = NULL;
+
+    if (*find_chars(input, "$`"))
+    {
+        if (!(expanded = expand_substitutions(input, &expansions)))
+        {
+            trace_end("input_decode", t_decode);
+            return;
+        }
+
+        input = expanded;
+    }
+
+    if (*find_chars(input, "*?["))
+        input = globbed = expand_globs(input);
+
+    if (env_assignment(input) && input_assignments(input))
+    {
+        free(expanded);
+        free(globbed);
+        trace_end("input_decode", t_decode);
+        return;
+    }
+
+    char* input_cpy = malloc(sizeof(char) * (strlen(input) + 1));
 
     strcpy(input_cpy, input);
 
     command = strtok_r(input, " ", &args);
-
-    for(flag = CONST_STR_ARR_SIZE(CMM_VALIDS) - 1; flag >= -1; flag--)
-        if(flag == CMM_EXTERN || !strcmp(CMM_VALIDS[flag], command)) 
-            break;
+    flag = get_command_flag(command);
 
     if (flag != CMM_EXTERN)
+    {
+        last_exit_status = EXIT_SUCCESS;
         command_handler(flag, args);
+    }
     else
         command_handler(flag, input_cpy);
 
     free(input_cpy);
+    free(expanded);
+    free(globbed);
+
+    trace_end("input_decode", t_decode);
+}
+
+COMMANDS_FLAGS get_command_flag(const char* command)
+{
+    COMMANDS_FLAGS flag;
+
+    for(flag = CONST_STR_ARR_SIZE(CMM_VALIDS) - 1; flag >= -1; flag--)
+        if(flag == CMM_EXTERN || !strcmp(CMM_VALIDS[flag], command)) 
+            break;
+
+    return flag;
 }
 
 void command_handler(COMMANDS_FLAGS cmm, char* args)
@@ -203,6 +674,74 @@ void command_handler(COMMANDS_FLAGS cmm, char* args)
             execute_fg(args);
             break;
 
+        case CMM_BG:
+            execute_bg(args);
+            break;
+
+        case CMM_WAIT:
+            execute_wait(args);
+            break;
+
+        case CMM_PARALLEL:
+            execute_parallel(args);
+            break;
+
+        case CMM_STATS:
+            execute_stats(args);
+            break;
+
+        case CMM_ZYGOTE:
+            execute_zygote(args);
+            break;
+
+        case CMM_SCHED:
+            execute_sched(args);
+            break;
+
+        case CMM_AFTER:
+            execute_after(args);
+            break;
+
+        case CMM_COPROC:
+            execute_coproc(args);
+            break;
+
+        case CMM_WRITE:
+            execute_write(args);
+            break;
+
+        case CMM_READ:
+            execute_read(args);
+            break;
+
+        case CMM_TEST:
+            execute_test(args);
+            break;
+
+        case CMM_BRACKET:
+            execute_bracket(args);
+            break;
+
+        case CMM_TRUE:
+            execute_true(args);
+            break;
+
+        case CMM_FALSE:
+            execute_false(args);
+            break;
+
+        case CMM_EXPORT:
+            execute_export(args);
+            break;
+
+        case CMM_UNSET:
+            execute_unset(args);
+            break;
+
+        case CMM_CACHE:
+            execute_cache(args);
+            break;
+
         case CMM_QUIT:
             execute_quit(args);
             break;
@@ -0,0 +1,538 @@
+/**
+ * @file ScriptArith.c
+ * @author Bottini, Franco Nicolas.
+ * @brief Implementacion de la expansion aritmetica.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../../inc/Script/ScriptArith.h"
+
+#define ARITH_ARR_SIZE(arr) (sizeof(arr) / sizeof(*arr))
+
+/** Estado del analisis de una expresion **/
+typedef struct arith_parser
+{
+    const char *pos;    /** Posicion actual en la expresion **/
+    int error;          /** 1 si la expresion es invalida **/
+} arith_parser;
+
+/** Entrada de la cache de expresiones analizadas **/
+typedef struct arith_cache_entry
+{
+    char *text;         /** Texto de la expresion **/
+    arith_node *tree;   /** Arbol analizado **/
+} arith_cache_entry;
+
+/** Operador binario con su precedencia, de menor a mayor **/
+typedef struct arith_binary_op
+{
+    const char *token;
+    ARITH_OPS op;
+    int prec;
+} arith_binary_op;
+
+/* Los operadores mas largos van primero, para que '<' no tome el comienzo de '<<' o '<=' */
+static const arith_binary_op BINARY_OPS[] = {
+    { "||", ARITH_OR, 1 }, { "&&", ARITH_AND, 2 },
+    { "==", ARITH_EQ, 6 }, { "!=", ARITH_NE, 6 },
+    { "<<", ARITH_SHL, 8 }, { ">>", ARITH_SHR, 8 }, { "<=", ARITH_LE, 7 }, { ">=", ARITH_GE, 7 },
+    { "|", ARITH_BIT_OR, 3 }, { "^", ARITH_BIT_XOR, 4 }, { "&", ARITH_BIT_AND, 5 },
+    { "<", ARITH_LT, 7 }, { ">", ARITH_GT, 7 },
+    { "+", ARITH_ADD, 9 }, { "-", ARITH_SUB, 9 }, { "*", ARITH_MUL, 10 }, { "/", ARITH_DIV, 10 }, { "%", ARITH_MOD, 10 }
+};
+
+/* Operadores de asignacion compuesta, sin el '=' final */
+static const arith_binary_op ASSIGN_OPS[] = {
+    { "<<", ARITH_SHL, 0 }, { ">>", ARITH_SHR, 0 }, { "+", ARITH_ADD, 0 }, { "-", ARITH_SUB, 0 },
+    { "*", ARITH_MUL, 0 }, { "/", ARITH_DIV, 0 }, { "%", ARITH_MOD, 0 },
+    { "&", ARITH_BIT_AND, 0 }, { "^", ARITH_BIT_XOR, 0 }, { "|", ARITH_BIT_OR, 0 }, { "", ARITH_ASSIGN, 0 }
+};
+
+static arith_cache_entry cache[ARITH_CACHE_SIZE];
+
+static arith_node* parse_comma(arith_parser *p);
+static arith_node* parse_assign(arith_parser *p);
+static arith_node* parse_unary(arith_parser *p);
+
+static void free_arith(arith_node *n)
+{
+    if (!n)
+        return;
+
+    free_arith(n->left);
+    free_arith(n->right);
+    free_arith(n->third);
+    free(n->name);
+    free(n);
+}
+
+static arith_node* new_arith(ARITH_OPS op, arith_node *left, arith_node *right)
+{
+    arith_node *n = calloc(1, sizeof(arith_node));
+
+    n->op = op;
+    n->left = left;
+    n->right = right;
+
+    return n;
+}
+
+static void skip_spaces(arith_parser *p)
+{
+    while (isspace((unsigned char)*p->pos))
+        p->pos++;
+}
+
+static int accept_token(arith_parser *p, const char *token)
+{
+    size_t len = strlen(token);
+
+    skip_spaces(p);
+
+    if (strncmp(p->pos, token, len))
+        return 0;
+
+    p->pos += len;
+
+    return 1;
+}
+
+static size_t name_length(const char *s)
+{
+    size_t len = 0;
+
+    if (!isalpha((unsigned char)*s) && *s != '_')
+        return 0;
+
+    while (isalnum((unsigned char)s[len]) || s[len] == '_')
+        len++;
+
+    return len;
+}
+
+static arith_node* parse_primary(arith_parser *p)
+{
+    size_t len;
+
+    skip_spaces(p);
+
+    if (accept_token(p, "("))
+    {
+        arith_node *n = parse_comma(p);
+
+        if (!accept_token(p, ")"))
+            p->error = 1;
+
+        return n;
+    }
+
+    if (isdigit((unsigned char)*p->pos))
+    {
+        char *end;
+        arith_node *n = new_arith(ARITH_NUM, NULL, NULL);
+
+        errno = 0;
+        n->value = strtol(p->pos, &end, 0);
+
+        if (errno || isalnum((unsigned char)*end) || *end == '_')
+            p->error = 1;
+
+        p->pos = end;
+
+        return n;
+    }
+
+    if ((len = name_length(p->pos)))
+    {
+        arith_node *n = new_arith(ARITH_VAR, NULL, NULL);
+
+        n->name = strndup(p->pos, len);
+        p->pos += len;
+
+        if (accept_token(p, "++"))
+            n->op = ARITH_POST_INC;
+        else if (accept_token(p, "--"))
+            n->op = ARITH_POST_DEC;
+
+        return n;
+    }
+
+    p->error = 1;
+
+    return NULL;
+}
+
+static arith_node* parse_unary(arith_parser *p)
+{
+    static const struct { const char *token; ARITH_OPS op; } UNARY_OPS[] = {
+        { "-", ARITH_NEG }, { "+", ARITH_PLUS }, { "!", ARITH_NOT }, { "~", ARITH_BIT_NOT }
+    };
+
+    skip_spaces(p);
+
+    if ((!strncmp(p->pos, "++", 2) || !strncmp(p->pos, "--", 2)))
+    {
+        const char *s = p->pos + 2;
+        size_t len;
+
+        while (isspace((unsigned char)*s))
+            s++;
+
+        if ((len = name_length(s)))
+        {
+            arith_node *n = new_arith(*p->pos == '+' ? ARITH_PRE_INC : ARITH_PRE_DEC, NULL, NULL);
+
+            n->name = strndup(s, len);
+            p->pos = s + len;
+
+            return n;
+        }
+    }
+
+    for (size_t i = 0; i < ARITH_ARR_SIZE(UNARY_OPS); i++)
+        if (accept_token(p, UNARY_OPS[i].token))
+            return new_arith(UNARY_OPS[i].op, parse_unary(p), NULL);
+
+    return parse_primary(p);
+}
+
+/* '**' asocia a derecha y tiene mas precedencia que los operadores binarios restantes */
+static arith_node* parse_power(arith_parser *p)
+{
+    arith_node *left = parse_unary(p);
+
+    if (accept_token(p, "**"))
+        return new_arith(ARITH_POW, left, parse_power(p));
+
+    return left;
+}
+
+static const arith_binary_op* match_binary(arith_parser *p, int min_prec)
+{
+    skip_spaces(p);
+
+    for (size_t i = 0; i < ARITH_ARR_SIZE(BINARY_OPS); i++)
+    {
+        const arith_binary_op *b = &BINARY_OPS[i];
+        size_t len = strlen(b->token);
+
+        if (strncmp(p->pos, b->token, len))
+            continue;
+
+        /* 'a += 1' es una asignacion y 'a ** 2' una potencia, no operadores binarios */
+        if (b->prec < min_prec || (b->prec >= 3 && b->prec != 6 && b->prec != 7 && p->pos[len] == '='))
+            return NULL;
+
+        if (b->op == ARITH_MUL && p->pos[1] == '*')
+            return NULL;
+
+        return b;
+    }
+
+    return NULL;
+}
+
+static arith_node* parse_binary(arith_parser *p, int min_prec)
+{
+    arith_node *left = parse_power(p);
+    const arith_binary_op *b;
+
+    while (!p->error && (b = match_binary(p, min_prec)))
+    {
+        p->pos += strlen(b->token);
+        left = new_arith(b->op, left, parse_binary(p, b->prec + 1));
+    }
+
+    return left;
+}
+
+static arith_node* parse_ternary(arith_parser *p)
+{
+    arith_node *cond = parse_binary(p, 1);
+
+    if (p->error || !accept_token(p, "?"))
+        return cond;
+
+    arith_node *n = new_arith(ARITH_TERNARY, cond, parse_assign(p));
+
+    if (!accept_token(p, ":"))
+        p->error = 1;
+    else
+        n->third = parse_ternary(p);
+
+    return n;
+}
+
+static arith_node* parse_assign(arith_parser *p)
+{
+    size_t len;
+
+    skip_spaces(p);
+
+    if ((len = name_length(p->pos)))
+    {
+        const char *s = p->pos + len;
+
+        while (isspace((unsigned char)*s))
+            s++;
+
+        for (size_t i = 0; i < ARITH_ARR_SIZE(ASSIGN_OPS); i++)
+        {
+            size_t op_len = strlen(ASSIGN_OPS[i].token);
+
+            if (strncmp(s, ASSIGN_OPS[i].token, op_len) || s[op_len] != '=' || s[op_len + 1] == '=')
+                continue;
+
+            arith_node *n = new_arith(ARITH_ASSIGN, NULL, NULL);
+
+            n->assign_op = ASSIGN_OPS[i].op;
+            n->name = strndup(p->pos, len);
+            p->pos = s + op_len + 1;
+            n->right = parse_assign(p);
+
+            return n;
+        }
+    }
+
+    return parse_ternary(p);
+}
+
+static arith_node* parse_comma(arith_parser *p)
+{
+    arith_node *left = parse_assign(p);
+
+    while (!p->error && accept_token(p, ","))
+        left = new_arith(ARITH_COMMA, left, parse_assign(p));
+
+    return left;
+}
+
+static arith_node* parse_arithmetic(const char *expr)
+{
+    arith_parser p = { .pos = expr };
+    arith_node *tree = parse_comma(&p);
+
+    skip_spaces(&p);
+
+    if (p.error || *p.pos)
+    {
+        fprintf(stderr, KRED"\n%s: syntax error in expression (near '%s') !\n\n"KDEF, expr, *p.pos ? p.pos : "end");
+        free_arith(tree);
+        return NULL;
+    }
+
+    return tree;
+}
+
+/* Obtiene el arbol de una expresion de la cache, analizandola si no esta */
+static arith_node* cached_arithmetic(const char *expr)
+{
+    uint32_t hash = 2166136261u;
+
+    for (const char *s = expr; *s; s++)
+        hash = (hash ^ (unsigned char)*s) * 16777619u;
+
+    arith_cache_entry *entry = &cache[hash & (ARITH_CACHE_SIZE - 1)];
+
+    if (entry->text && !strcmp(entry->text, expr))
+        return entry->tree;
+
+    arith_node *tree = parse_arithmetic(expr);
+
+    if (!tree)
+        return NULL;
+
+    free(entry->text);
+    free_arith(entry->tree);
+
+    entry->text = strdup(expr);
+    entry->tree = tree;
+
+    return tree;
+}
+
+static long read_variable(const char *name, variable_lookup lookup, int *error)
+{
+    const char *value = lookup(name);
+    char *end;
+    long result;
+
+    if (!value || !*value)
+        return 0;
+
+    errno = 0;
+    result = strtol(value, &end, 0);
+
+    while (isspace((unsigned char)*end))
+        end++;
+
+    if (errno || *end || end == value)
+    {
+        fprintf(stderr, KRED"\n%s: '%s' is not an integer !\n\n"KDEF, name, value);
+        *error = 1;
+    }
+
+    return result;
+}
+
+static void write_variable(const char *name, long value)
+{
+    char buffer[32];
+
+    snprintf(buffer, sizeof(buffer), "%ld", value);
+    env_set(name, buffer);
+}
+
+/* Aritmetica en complemento a 2, sin comportamiento indefinido ante desbordes */
+static long binary_operation(ARITH_OPS op, long a, long b, int *error)
+{
+    unsigned long ua = a, ub = b;
+
+    switch (op)
+    {
+        case ARITH_ADD:     return (long)(ua + ub);
+        case ARITH_SUB:     return (long)(ua - ub);
+        case ARITH_MUL:     return (long)(ua * ub);
+        case ARITH_SHL:     return (long)(ua << (b & 63));
+        case ARITH_SHR:     return a >> (b & 63);
+        case ARITH_LT:      return a < b;
+        case ARITH_LE:      return a <= b;
+        case ARITH_GT:      return a > b;
+        case ARITH_GE:      return a >= b;
+        case ARITH_EQ:      return a == b;
+        case ARITH_NE:      return a != b;
+        case ARITH_BIT_AND: return a & b;
+        case ARITH_BIT_XOR: return a ^ b;
+        case ARITH_BIT_OR:  return a | b;
+
+        case ARITH_DIV:
+        case ARITH_MOD:
+            if (b == 0)
+            {
+                fprintf(stderr, KRED"\nDivision by 0 !\n\n"KDEF);
+                *error = 1;
+                return 0;
+            }
+
+            if (b == -1)
+                return op == ARITH_DIV ? (long)(0 - ua) : 0;
+
+            return op == ARITH_DIV ? a / b : a % b;
+
+        case ARITH_POW:
+        {
+            unsigned long result = 1;
+
+            if (b < 0)
+            {
+                fprintf(stderr, KRED"\nExponent less than 0 !\n\n"KDEF);
+                *error = 1;
+                return 0;
+            }
+
+            for (; b; b >>= 1, ua *= ua)
+                if (b & 1)
+                    result *= ua;
+
+            return (long)result;
+        }
+
+        default:
+            return 0;
+    }
+}
+
+static long evaluate(arith_node *n, variable_lookup lookup, int *error)
+{
+    long a, b;
+
+    if (*error)
+        return 0;
+
+    switch (n->op)
+    {
+        case ARITH_NUM:
+            return n->value;
+
+        case ARITH_VAR:
+            return read_variable(n->name, lookup, error);
+
+        case ARITH_NEG:
+            return (long)(0 - (unsigned long)evaluate(n->left, lookup, error));
+
+        case ARITH_PLUS:
+            return evaluate(n->left, lookup, error);
+
+        case ARITH_NOT:
+            return !evaluate(n->left, lookup, error);
+
+        case ARITH_BIT_NOT:
+            return ~evaluate(n->left, lookup, error);
+
+        case ARITH_PRE_INC:
+        case ARITH_PRE_DEC:
+        case ARITH_POST_INC:
+        case ARITH_POST_DEC:
+            a = read_variable(n->name, lookup, error);
+            b = (long)((unsigned long)a + (n->op == ARITH_PRE_INC || n->op == ARITH_POST_INC ? 1 : -1));
+
+            if (!*error)
+                write_variable(n->name, b);
+
+            return n->op == ARITH_PRE_INC || n->op == ARITH_PRE_DEC ? b : a;
+
+        case ARITH_AND:
+            return evaluate(n->left, lookup, error) && evaluate(n->right, lookup, error);
+
+        case ARITH_OR:
+            return evaluate(n->left, lookup, error) || evaluate(n->right, lookup, error);
+
+        case ARITH_TERNARY:
+            return evaluate(n->left, lookup, error) ? evaluate(n->right, lookup, error) : evaluate(n->third, lookup, error);
+
+        case ARITH_COMMA:
+            evaluate(n->left, lookup, error);
+            return evaluate(n->right, lookup, error);
+
+        case ARITH_ASSIGN:
+            b = evaluate(n->right, lookup, error);
+
+            if (n->assign_op != ARITH_ASSIGN)
+                b = binary_operation(n->assign_op, read_variable(n->name, lookup, error), b, error);
+
+            if (!*error)
+                write_variable(n->name, b);
+
+            return b;
+
+        default:
+            a = evaluate(n->left, lookup, error);
+            b = evaluate(n->right, lookup, error);
+
+            return *error ? 0 : binary_operation(n->op, a, b, error);
+    }
+}
+
+int evaluate_arithmetic(const char *expr, variable_lookup lookup, long *result)
+{
+    int error = 0;
+
+    *result = 0;
+
+    /* Una expresion vacia vale 0 */
+    if (!expr[strspn(expr, " \t\n")])
+        return 0;
+
+    arith_node *tree = cached_arithmetic(expr);
+
+    if (!tree)
+        return -1;
+
+    *result = evaluate(tree, lookup, &error);
+
+    return error ? -1 : 0;
+}
@@ -0,0 +1,670 @@
+/**
+ * @file ScriptInterpreter.c
+ * @author Bottini, Franco Nicolas.
+ * @brief Implementacion del interprete de estructuras de control.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../../inc/Script/ScriptInterpreter.h"
+
+/** Maximo de llamadas a funciones anidadas **/
+#define SCRIPT_MAX_CALL_DEPTH 1000
+
+static script_runner run_command = NULL;
+static const expansion_hooks *expansion = NULL;
+static script_function *functions = NULL;
+static script_frame *frame = NULL;
+static int call_depth = 0;
+static int loop_depth = 0;
+static int break_levels = 0;
+static int continue_levels = 0;
+static int returning = 0;
+static int return_status = 0;
+static volatile sig_atomic_t interrupted = 0;
+
+static int execute_node(script_node *n);
+
+static void script_interrupt_handler()
+{
+    interrupted = 1;
+}
+
+void script_init(script_runner run, const expansion_hooks *hooks)
+{
+    run_command = run;
+    expansion = hooks;
+}
+
+/* Indica si se debe dejar de ejecutar sentencias: break, continue, return o Ctrl-C */
+static int aborting(void)
+{
+    return interrupted || break_levels || continue_levels || returning;
+}
+
+/* Indica si el bucle actual debe terminar despues de ejecutar su cuerpo o su condicion */
+static int leave_loop(void)
+{
+    if (break_levels)
+    {
+        break_levels--;
+        return 1;
+    }
+
+    if (continue_levels && --continue_levels)
+        return 1;
+
+    return interrupted || returning;
+}
+
+static int execute_list(script_node *n)
+{
+    int status = EXIT_SUCCESS;
+
+    for (; n && !aborting(); n = n->next)
+        status = execute_node(n);
+
+    return status;
+}
+
+static char* expand_text(const char *text)
+{
+    return expand_substitutions(text, expansion);
+}
+
+/* Expande una lista de palabras, incluidos los patrones de nombres de archivo */
+static char* expand_words(const char *text)
+{
+    char *expanded = expand_text(text);
+
+    if (expanded && strpbrk(expanded, "*?["))
+    {
+        char *globbed = expand_globs(expanded);
+
+        free(expanded);
+        expanded = globbed;
+    }
+
+    return expanded;
+}
+
+/* Remueve un par de comillas que encierre toda la cadena */
+static char* unquote(char *s)
+{
+    size_t len = strlen(s);
+
+    if (len >= 2 && (*s == '"' || *s == '\'') && s[len - 1] == *s)
+    {
+        s[len - 1] = ASCII_END_OF_STRING;
+        return s + 1;
+    }
+
+    return s;
+}
+
+static int is_word(const char *text, size_t len, const char *word)
+{
+    return len == strlen(word) && !strncmp(text, word, len);
+}
+
+/* Expande los argumentos de break, continue, return y shift y los interpreta como un numero */
+static int numeric_argument(const char *args, int fallback)
+{
+    char *expanded = *args ? expand_text(args) : NULL;
+    char *end;
+    long value;
+
+    if (!expanded)
+        return fallback;
+
+    value = strtol(expanded, &end, 10);
+
+    while (*end == ASCII_SPACE)
+        end++;
+
+    if (end == expanded || *end)
+        value = fallback;
+
+    free(expanded);
+
+    return value;
+}
+
+static script_function* find_function(const char *name, size_t len)
+{
+    for (script_function *f = functions; f; f = f->next)
+        if (is_word(name, len, f->name))
+            return f;
+
+    return NULL;
+}
+
+static int define_function(script_node *n)
+{
+    script_function *f = find_function(n->name, strlen(n->name));
+
+    if (!f)
+    {
+        f = calloc(1, sizeof(script_function));
+        f->name = strdup(n->name);
+        f->next = functions;
+        functions = f;
+    }
+    else if (f->active)
+    {
+        /* El cuerpo anterior sigue en ejecucion: se libera cuando terminen sus llamadas */
+        f->body->next = f->stale;
+        f->stale = f->body;
+    }
+    else
+        free_script(f->body);
+
+    f->body = clone_script(n->body);
+
+    return EXIT_SUCCESS;
+}
+
+static int call_function(script_function *f, const char *args)
+{
+    char *expanded = expand_words(args);
+    script_frame call = { .prev = frame };
+    int saved_loop_depth = loop_depth;
+    int status;
+
+    if (!expanded)
+        return EXIT_FAILURE;
+
+    if (call_depth >= SCRIPT_MAX_CALL_DEPTH)
+    {
+        fprintf(stderr, KRED"\n%s: maximum function nesting level exceeded !\n\n"KDEF, f->name);
+        free(expanded);
+        interrupted = 1;
+        return EXIT_FAILURE;
+    }
+
+    call.argv = str_to_array(expanded, &call.argc);
+    frame = &call;
+    loop_depth = 0;
+    call_depth++;
+    f->active++;
+
+    status = execute_node(f->body);
+
+    if (returning)
+    {
+        status = return_status;
+        returning = 0;
+    }
+
+    if (!--f->active && f->stale)
+    {
+        free_script(f->stale);
+        f->stale = NULL;
+    }
+
+    call_depth--;
+    loop_depth = saved_loop_depth;
+    break_levels = continue_levels = 0;
+    frame = call.prev;
+
+    free_array(call.argv, call.argc);
+    free(expanded);
+
+    return status;
+}
+
+/* Arma la asignacion 'NAME=valor' que empieza en s, con el valor sin comillas y expandido salvo entre comillas
+   simples. Deja en end el final de la palabra. Retorna NULL si la expansion falla */
+static char* assignment_entry(const char *s, const char **end)
+{
+    const char *equal = strchr(s, '=');
+    char *raw, *value, *expanded = NULL, *entry;
+
+    *end = script_word_end(equal + 1);
+    raw = strndup(equal + 1, *end - equal - 1);
+    value = unquote(raw);
+
+    if (*raw != '\'' && !(value = expanded = expand_text(value)))
+    {
+        free(raw);
+        return NULL;
+    }
+
+    entry = malloc(equal - s + strlen(value) + 2);
+    sprintf(entry, "%.*s=%s", (int)(equal - s), s, value);
+
+    free(expanded);
+    free(raw);
+
+    return entry;
+}
+
+/* Ejecuta una linea 'NAME=valor ...' formada solo por asignaciones. Retorna -1 si no lo es, y si no el codigo de
+   la ultima sustitucion de comandos de los valores, o 0 si no tienen */
+static int execute_assignments(const char *text)
+{
+    const char *s = text;
+
+    /* Primero se valida toda la linea, para no asignar a medias */
+    while (*s)
+    {
+        const char *end;
+
+        if (!env_assignment(s) || !(end = script_word_end(strchr(s, '=') + 1)))
+            return -1;
+
+        s = end;
+
+        while (*s == ASCII_SPACE || *s == ASCII_TAB)
+            s++;
+    }
+
+    last_exit_status = EXIT_SUCCESS;
+
+    for (s = text; *s; )
+    {
+        const char *end;
+        char *entry = assignment_entry(s, &end);
+        char *equal;
+
+        if (!entry)
+            return EXIT_FAILURE;
+
+        equal = strchr(entry, '=');
+        *equal = ASCII_END_OF_STRING;
+        env_set(entry, equal + 1);
+        free(entry);
+
+        for (s = end; *s == ASCII_SPACE || *s == ASCII_TAB; s++);
+    }
+
+    return last_exit_status;
+}
+
+/* Llama a una funcion precedida por asignaciones 'NAME=valor', que solo valen durante la llamada.
+   Retorna -1 si el comando no es una funcion, y la shell lo ejecuta con las asignaciones en su entorno */
+static int call_with_assignments(const char *text)
+{
+    const char *s = text;
+    script_function *f;
+    env_saved *saved;
+    int n = 0;
+    int status = EXIT_SUCCESS;
+
+    while (env_assignment(s))
+    {
+        if (!(s = script_word_end(strchr(s, '=') + 1)))
+            return -1;
+
+        while (*s == ASCII_SPACE || *s == ASCII_TAB)
+            s++;
+
+        n++;
+    }
+
+    size_t len = strcspn(s, " \t");
+
+    if (!len || !(f = find_function(s, len)))
+        return -1;
+
+    saved = malloc(sizeof(env_saved) * n);
+
+    for (int i = 0; i < n; i++)
+    {
+        const char *end;
+        char *entry = assignment_entry(text, &end);
+
+        if (!entry)
+        {
+            n = i;
+            status = EXIT_FAILURE;
+            break;
+        }
+
+        env_push(entry, &saved[i]);
+        free(entry);
+
+        for (text = end; *text == ASCII_SPACE || *text == ASCII_TAB; text++);
+    }
+
+    if (status == EXIT_SUCCESS)
+        status = call_function(f, s + len + strspn(s + len, " \t"));
+
+    while (n--)
+        env_pop(&saved[n]);
+
+    free(saved);
+
+    return status;
+}
+
+/* Ejecuta '((expr))': finaliza con exito si la expresion es distinta de 0 */
+static int execute_arithmetic(const char *text)
+{
+    char *inner = strndup(text + 2, strlen(text) - 4);
+    char *expr = expand_text(inner);
+    long value = 0;
+    int status = EXIT_FAILURE;
+
+    if (expr && expansion->arith(expr, expansion->lookup, &value) == 0)
+        status = value ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    free(expr);
+    free(inner);
+
+    return status;
+}
+
+static int execute_command(script_node *n)
+{
+    const char *text = n->text;
+    size_t len = strcspn(text, " \t");
+    const char *args = text + len + strspn(text + len, " \t");
+    script_function *f;
+    int status;
+
+    if (is_word(text, len, "break") || is_word(text, len, "continue"))
+    {
+        int levels = numeric_argument(args, 1);
+
+        if (levels < 1 || !loop_depth)
+            return levels < 1 ? EXIT_FAILURE : EXIT_SUCCESS;
+
+        if (levels > loop_depth)
+            levels = loop_depth;
+
+        if (*text == 'b')
+            break_levels = levels;
+        else
+            continue_levels = levels;
+
+        return EXIT_SUCCESS;
+    }
+
+    if (is_word(text, len, "return"))
+    {
+        if (!frame)
+        {
+            fprintf(stderr, KRED"\nreturn: can only be used in a function !\n\n"KDEF);
+            return EXIT_FAILURE;
+        }
+
+        return_status = numeric_argument(args, last_exit_status) & 0xFF;
+        returning = 1;
+
+        return return_status;
+    }
+
+    if (is_word(text, len, "shift") && frame)
+    {
+        int count = numeric_argument(args, 1);
+
+        if (count < 0 || count > frame->argc - frame->shift)
+            return EXIT_FAILURE;
+
+        frame->shift += count;
+
+        return EXIT_SUCCESS;
+    }
+
+    if (strchr(text, '=') && (status = execute_assignments(text)) >= 0)
+        return status;
+
+    if (!strncmp(text, "((", 2) && get_matching_paren((char*)text) == text + strlen(text) - 1
+        && get_matching_paren((char*)text + 1) == text + strlen(text) - 2)
+        return execute_arithmetic(text);
+
+    if (env_assignment(text) && (status = call_with_assignments(text)) >= 0)
+        return status;
+
+    if ((f = find_function(text, len)))
+        return call_function(f, args);
+
+    char *line = strdup(text);
+
+    run_command(line);
+    free(line);
+
+    if (last_exit_status == 128 + SIGINT)
+        interrupted = 1;
+
+    return last_exit_status;
+}
+
+static int execute_loop(script_node *n)
+{
+    int status = EXIT_SUCCESS;
+
+    loop_depth++;
+
+    while (1)
+    {
+        int result = execute_list(n->cond);
+
+        if (leave_loop() || (result == EXIT_SUCCESS) != (n->type == NODE_WHILE))
+            break;
+
+        status = execute_list(n->body);
+
+        if (leave_loop())
+            break;
+    }
+
+    loop_depth--;
+
+    return status;
+}
+
+static int execute_for(script_node *n)
+{
+    int status = EXIT_SUCCESS;
+    char *words = expand_words(n->text ? n->text : "$@");
+    char **argv;
+    int argc;
+
+    if (!words)
+        return EXIT_FAILURE;
+
+    argv = str_to_array(words, &argc);
+    loop_depth++;
+
+    for (int i = 0; i < argc; i++)
+    {
+        env_set(n->name, argv[i]);
+        status = execute_list(n->body);
+
+        if (leave_loop())
+            break;
+    }
+
+    loop_depth--;
+
+    free_array(argv, argc);
+    free(words);
+
+    return status;
+}
+
+static int execute_case(script_node *n)
+{
+    char *expanded = expand_text(n->text);
+    int status = EXIT_SUCCESS;
+
+    if (!expanded)
+        return EXIT_FAILURE;
+
+    char *word = unquote(expanded);
+
+    for (case_item *item = n->items; item; item = item->next)
+    {
+        int match = 0;
+
+        for (int i = 0; i < item->n_patterns && !match; i++)
+        {
+            char *pattern = expand_text(item->patterns[i]);
+
+            match = pattern && !fnmatch(unquote(pattern), word, 0);
+            free(pattern);
+        }
+
+        if (match)
+        {
+            status = execute_list(item->body);
+            break;
+        }
+    }
+
+    free(expanded);
+
+    return status;
+}
+
+static int execute_node(script_node *n)
+{
+    int status = EXIT_SUCCESS;
+
+    switch (n->type)
+    {
+        case NODE_COMMAND:
+            status = execute_command(n);
+            break;
+
+        case NODE_AND:
+            if ((status = execute_node(n->cond)) == EXIT_SUCCESS && !aborting())
+                status = execute_node(n->body);
+            break;
+
+        case NODE_OR:
+            if ((status = execute_node(n->cond)) != EXIT_SUCCESS && !aborting())
+                status = execute_node(n->body);
+            break;
+
+        case NODE_NOT:
+            status = execute_node(n->body) == EXIT_SUCCESS ? EXIT_FAILURE : EXIT_SUCCESS;
+            break;
+
+        case NODE_GROUP:
+            status = execute_list(n->body);
+            break;
+
+        case NODE_IF:
+            status = execute_list(n->cond);
+
+            if (aborting())
+                break;
+
+            if (status == EXIT_SUCCESS)
+                status = execute_list(n->body);
+            else
+                status = execute_list(n->alt);
+            break;
+
+        case NODE_WHILE:
+        case NODE_UNTIL:
+            status = execute_loop(n);
+            break;
+
+        case NODE_FOR:
+            status = execute_for(n);
+            break;
+
+        case NODE_CASE:
+            status = execute_case(n);
+            break;
+
+        case NODE_FUNCTION:
+            status = define_function(n);
+            break;
+    }
+
+    last_exit_status = status;
+
+    return status;
+}
+
+int execute_script(script_node *tree)
+{
+    struct sigaction interrupt_action = { .sa_handler = script_interrupt_handler, .sa_flags = SA_RESTART }, old;
+    int status;
+
+    if (job_control_interactive)
+    {
+        sigemptyset(&interrupt_action.sa_mask);
+        sigaction(SIGINT, &interrupt_action, &old);
+    }
+
+    interrupted = 0;
+    status = execute_list(tree);
+
+    if (job_control_interactive)
+        sigaction(SIGINT, &old, NULL);
+
+    if (interrupted)
+        status = 128 + SIGINT;
+
+    interrupted = break_levels = continue_levels = returning = 0;
+    last_exit_status = status;
+
+    return status;
+}
+
+const char* script_variable(const char *name)
+{
+    static char number[16];
+    static job_buffer joined = {0};
+    int shift = frame ? frame->shift : 0;
+    int argc = frame ? frame->argc - shift : 0;
+
+    if (!name[1])
+    {
+        switch (*name)
+        {
+            case '?':
+                snprintf(number, sizeof(number), "%d", last_exit_status);
+                return number;
+
+            case '#':
+                snprintf(number, sizeof(number), "%d", argc);
+                return number;
+
+            case '$':
+                snprintf(number, sizeof(number), "%d", getpid());
+                return number;
+
+            case '0':
+                return SCRIPT_SHELL_NAME;
+
+            case '@':
+            case '*':
+                joined.len = 0;
+
+                for (int i = 0; i < argc; i++)
+                {
+                    if (i)
+                        append_job_buffer(&joined, " ", 1);
+
+                    append_job_buffer(&joined, frame->argv[shift + i], strlen(frame->argv[shift + i]));
+                }
+
+                append_job_buffer(&joined, "", 1);
+                return joined.data;
+        }
+    }
+
+    if (isdigit((unsigned char)*name))
+    {
+        int index = atoi(name);
+
+        return index >= 1 && index <= argc ? frame->argv[shift + index - 1] : NULL;
+    }
+
+    return env_get(name);
+}
+
+int is_script_function(const char *name)
+{
+    return find_function(name, strlen(name)) != NULL;
+}
@@ -0,0 +1,804 @@
+/**
+ * @file ScriptParser.c
+ * @author Bottini, Franco Nicolas.
+ * @brief Implementacion del analizador de estructuras de control.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../../inc/Script/ScriptParser.h"
+
+/** Estado del analisis **/
+typedef struct parser
+{
+    const char *pos;                /** Posicion actual en el texto **/
+    SCRIPT_PARSE_RESULT result;     /** Resultado, PARSE_OK mientras no haya errores **/
+} parser;
+
+static const char *KEYWORDS[] = {
+    "if", "then", "elif", "else", "fi", "while", "until", "do", "done",
+    "for", "case", "esac", "function", "{", "}", "!", NULL
+};
+
+/* Palabras que solo pueden cerrar una estructura abierta */
+static const char *CLOSING_WORDS[] = {
+    "then", "elif", "else", "fi", "do", "done", "esac", "}", NULL
+};
+
+static const char *STOP_THEN[] = { "then", NULL };
+static const char *STOP_IF_BODY[] = { "elif", "else", "fi", NULL };
+static const char *STOP_FI[] = { "fi", NULL };
+static const char *STOP_DO[] = { "do", NULL };
+static const char *STOP_DONE[] = { "done", NULL };
+static const char *STOP_GROUP[] = { "}", NULL };
+static const char *STOP_CASE_ITEM[] = { ";;", "esac", NULL };
+
+static script_node* parse_list(parser *p, const char **stops);
+static script_node* parse_statement(parser *p);
+
+static int is_word_end(char c)
+{
+    return !c || strchr(" \t\n;&|()", c);
+}
+
+static int is_blank(char c)
+{
+    return c == ASCII_SPACE || c == ASCII_TAB;
+}
+
+static int in_words(const char *word, size_t len, const char **words)
+{
+    for (; words && *words; words++)
+        if (strlen(*words) == len && !strncmp(*words, word, len))
+            return 1;
+
+    return 0;
+}
+
+static void fail(parser *p, const char *near, size_t len)
+{
+    if (p->result != PARSE_OK)
+        return;
+
+    p->result = PARSE_ERROR;
+
+    if (!len || *near == ASCII_LINE_BREAK)
+        fprintf(stderr, KRED"\nSyntax error near '\\n' !\n\n"KDEF);
+    else
+        fprintf(stderr, KRED"\nSyntax error near '%.*s' !\n\n"KDEF, (int)len, near);
+}
+
+static void incomplete(parser *p)
+{
+    if (p->result == PARSE_OK)
+        p->result = PARSE_INCOMPLETE;
+}
+
+/* Saltea espacios y comentarios, sin consumir el salto de linea */
+static void skip_blanks(parser *p)
+{
+    while (is_blank(*p->pos))
+        p->pos++;
+
+    if (*p->pos == '#')
+        p->pos += strcspn(p->pos, "\n");
+}
+
+/* Saltea espacios, saltos de linea y ';' sueltos. Un ';;' queda para el case */
+static void skip_separators(parser *p)
+{
+    while (1)
+    {
+        skip_blanks(p);
+
+        if (*p->pos == ASCII_LINE_BREAK || (*p->pos == ';' && p->pos[1] != ';'))
+            p->pos++;
+        else
+            break;
+    }
+}
+
+/* Retorna la longitud de la palabra en la posicion actual, sin consumirla */
+static size_t peek_word(parser *p)
+{
+    size_t len = 0;
+
+    skip_blanks(p);
+
+    while (!is_word_end(p->pos[len]))
+        len++;
+
+    return len;
+}
+
+static int accept_word(parser *p, const char *word)
+{
+    size_t len = peek_word(p);
+
+    if (len != strlen(word) || strncmp(p->pos, word, len))
+        return 0;
+
+    p->pos += len;
+
+    return 1;
+}
+
+static int expect_word(parser *p, const char *word)
+{
+    if (accept_word(p, word))
+        return 1;
+
+    if (!*p->pos)
+        incomplete(p);
+    else
+        fail(p, p->pos, peek_word(p));
+
+    return 0;
+}
+
+/*
+ * Avanza hasta el final de un texto respetando comillas, parentesis y acentos graves. Se detiene en el
+ * fin de linea, ';', '&&', '||', un comentario o, si stop_at_blank, un espacio. Retorna NULL si termina
+ * dentro de una comilla o un parentesis.
+ */
+static const char* scan_text(const char *s, int stop_at_blank)
+{
+    const char *start = s;
+
+    while (*s)
+    {
+        const char *end;
+
+        switch (*s)
+        {
+            case '\'':
+            case '"':
+            case ASCII_BACKTICK:
+                if (!(end = strchr(s + 1, *s)))
+                    return NULL;
+
+                s = end + 1;
+                continue;
+
+            case ASCII_OPEN_PAREN:
+                if (!(end = get_matching_paren((char*)s)))
+                    return NULL;
+
+                s = end + 1;
+                continue;
+
+            case ASCII_LINE_BREAK:
+            case ';':
+                return s;
+
+            case ASCII_AMPERSAND:
+            case ASCII_PLECA:
+                if (s[1] == *s)
+                    return s;
+                break;
+
+            case '#':
+                if (s == start || is_blank(s[-1]))
+                    return s;
+                break;
+
+            case ASCII_SPACE:
+            case ASCII_TAB:
+                if (stop_at_blank)
+                    return s;
+                break;
+        }
+
+        s++;
+    }
+
+    return s;
+}
+
+/* Copia el texto entre start y end sin los espacios finales */
+static char* copy_text(const char *start, const char *end)
+{
+    while (end > start && is_blank(end[-1]))
+        end--;
+
+    return strndup(start, end - start);
+}
+
+static script_node* new_node(SCRIPT_NODE_TYPES type)
+{
+    script_node *n = calloc(1, sizeof(script_node));
+
+    n->type = type;
+
+    return n;
+}
+
+/* Analiza la condicion de un if, while o until, que no puede estar vacia */
+static script_node* parse_condition(parser *p, const char **stops)
+{
+    script_node *cond = parse_list(p, stops);
+
+    if (!cond && p->result == PARSE_OK)
+        fail(p, p->pos, peek_word(p));
+
+    return cond;
+}
+
+static script_node* parse_command(parser *p)
+{
+    const char *start = p->pos;
+    const char *end = scan_text(start, 0);
+
+    if (!end)
+    {
+        incomplete(p);
+        return NULL;
+    }
+
+    if (end == start)
+    {
+        fail(p, start, strcspn(start, " \t"));
+        return NULL;
+    }
+
+    script_node *n = new_node(NODE_COMMAND);
+
+    n->text = copy_text(start, end);
+    p->pos = end;
+
+    return n;
+}
+
+static script_node* parse_if(parser *p)
+{
+    script_node *n = new_node(NODE_IF);
+
+    /* Consume 'if' o 'elif' */
+    p->pos += peek_word(p);
+
+    if (!(n->cond = parse_condition(p, STOP_THEN)) || !expect_word(p, "then"))
+        goto error;
+
+    n->body = parse_list(p, STOP_IF_BODY);
+
+    if (p->result != PARSE_OK)
+        goto error;
+
+    if (peek_word(p) == 4 && !strncmp(p->pos, "elif", 4))
+    {
+        if (!(n->alt = parse_if(p)))
+            goto error;
+    }
+    else if (accept_word(p, "else"))
+    {
+        n->alt = parse_list(p, STOP_FI);
+
+        if (!expect_word(p, "fi"))
+            goto error;
+    }
+    else if (!expect_word(p, "fi"))
+        goto error;
+
+    return n;
+
+error:
+    free_script(n);
+    return NULL;
+}
+
+static script_node* parse_loop(parser *p, SCRIPT_NODE_TYPES type)
+{
+    script_node *n = new_node(type);
+
+    p->pos += peek_word(p);
+
+    if (!(n->cond = parse_condition(p, STOP_DO)) || !expect_word(p, "do"))
+        goto error;
+
+    n->body = parse_list(p, STOP_DONE);
+
+    if (!expect_word(p, "done"))
+        goto error;
+
+    return n;
+
+error:
+    free_script(n);
+    return NULL;
+}
+
+static int is_name(const char *s, size_t len)
+{
+    if (!len || !(isalpha((unsigned char)*s) || *s == '_'))
+        return 0;
+
+    for (size_t i = 1; i < len; i++)
+        if (!isalnum((unsigned char)s[i]) && s[i] != '_')
+            return 0;
+
+    return 1;
+}
+
+static script_node* parse_for(parser *p)
+{
+    script_node *n = new_node(NODE_FOR);
+    size_t len;
+
+    p->pos += peek_word(p);
+    len = peek_word(p);
+
+    if (!is_name(p->pos, len))
+    {
+        if (!*p->pos)
+            incomplete(p);
+        else
+            fail(p, p->pos, len);
+
+        goto error;
+    }
+
+    n->name = strndup(p->pos, len);
+    p->pos += len;
+
+    if (accept_word(p, "in"))
+    {
+        const char *start = p->pos;
+        const char *end = scan_text(start, 0);
+
+        if (!end)
+        {
+            incomplete(p);
+            goto error;
+        }
+
+        n->text = copy_text(start, end);
+        p->pos = end;
+    }
+
+    skip_separators(p);
+
+    if (!expect_word(p, "do"))
+        goto error;
+
+    n->body = parse_list(p, STOP_DONE);
+
+    if (!expect_word(p, "done"))
+        goto error;
+
+    return n;
+
+error:
+    free_script(n);
+    return NULL;
+}
+
+static case_item* parse_case_item(parser *p)
+{
+    case_item *item = calloc(1, sizeof(case_item));
+    const char *end;
+
+    if (*p->pos == ASCII_OPEN_PAREN)
+        p->pos++;
+
+    end = p->pos + strcspn(p->pos, ")\n");
+
+    if (*end != ASCII_CLOSE_PAREN)
+    {
+        if (!*end)
+            incomplete(p);
+        else
+            fail(p, end, 1);
+
+        free(item);
+        return NULL;
+    }
+
+    char *patterns = strndup(p->pos, end - p->pos);
+    char *end_str;
+
+    item->patterns = malloc(sizeof(char*));
+
+    for (char *pattern = strtok_r(patterns, "|", &end_str); pattern; pattern = strtok_r(NULL, "|", &end_str))
+    {
+        while (is_blank(*pattern))
+            pattern++;
+
+        item->patterns = realloc(item->patterns, sizeof(char*) * (item->n_patterns + 1));
+        item->patterns[item->n_patterns++] = copy_text(pattern, pattern + strlen(pattern));
+    }
+
+    free(patterns);
+    p->pos = end + 1;
+
+    item->body = parse_list(p, STOP_CASE_ITEM);
+
+    if (p->result == PARSE_OK && *p->pos == ';')
+        p->pos += 2;
+
+    return item;
+}
+
+static script_node* parse_case(parser *p)
+{
+    script_node *n = new_node(NODE_CASE);
+    case_item **tail = &n->items;
+    const char *end;
+
+    p->pos += peek_word(p);
+    skip_blanks(p);
+
+    if (!(end = scan_text(p->pos, 1)) || end == p->pos)
+    {
+        if (!end || !*p->pos)
+            incomplete(p);
+        else
+            fail(p, p->pos, 1);
+
+        goto error;
+    }
+
+    n->text = strndup(p->pos, end - p->pos);
+    p->pos = end;
+
+    skip_separators(p);
+
+    if (!expect_word(p, "in"))
+        goto error;
+
+    while (1)
+    {
+        skip_separators(p);
+
+        if (!*p->pos)
+        {
+            incomplete(p);
+            goto error;
+        }
+
+        if (accept_word(p, "esac"))
+            break;
+
+        if (!(*tail = parse_case_item(p)))
+            goto error;
+
+        tail = &(*tail)->next;
+
+        if (p->result != PARSE_OK)
+            goto error;
+    }
+
+    return n;
+
+error:
+    free_script(n);
+    return NULL;
+}
+
+static script_node* parse_group(parser *p)
+{
+    script_node *n = new_node(NODE_GROUP);
+
+    p->pos += peek_word(p);
+    n->body = parse_list(p, STOP_GROUP);
+
+    if (!expect_word(p, "}"))
+    {
+        free_script(n);
+        return NULL;
+    }
+
+    return n;
+}
+
+/* Analiza 'function name [()] { ... }' o 'name() { ... }' */
+static script_node* parse_function(parser *p, int keyword)
+{
+    script_node *n = new_node(NODE_FUNCTION);
+    size_t len;
+
+    if (keyword)
+        p->pos += peek_word(p);
+
+    len = peek_word(p);
+
+    if (!is_name(p->pos, len) || is_script_keyword(n->name = strndup(p->pos, len)))
+    {
+        if (!*p->pos)
+            incomplete(p);
+        else
+            fail(p, p->pos, len);
+
+        free_script(n);
+        return NULL;
+    }
+
+    p->pos += len;
+    skip_blanks(p);
+
+    if (*p->pos == ASCII_OPEN_PAREN)
+    {
+        p->pos++;
+        skip_blanks(p);
+
+        if (*p->pos != ASCII_CLOSE_PAREN)
+        {
+            fail(p, p->pos, 1);
+            free_script(n);
+            return NULL;
+        }
+
+        p->pos++;
+    }
+
+    skip_separators(p);
+
+    if (peek_word(p) != 1 || *p->pos != '{')
+    {
+        if (!*p->pos)
+            incomplete(p);
+        else
+            fail(p, p->pos, peek_word(p));
+
+        free_script(n);
+        return NULL;
+    }
+
+    if (!(n->body = parse_group(p)))
+    {
+        free_script(n);
+        return NULL;
+    }
+
+    return n;
+}
+
+/* Indica si la posicion actual es 'name ()' */
+static int at_function_definition(parser *p, size_t len)
+{
+    const char *s = p->pos + len;
+
+    if (!is_name(p->pos, len))
+        return 0;
+
+    while (is_blank(*s))
+        s++;
+
+    if (*s++ != ASCII_OPEN_PAREN)
+        return 0;
+
+    while (is_blank(*s))
+        s++;
+
+    return *s == ASCII_CLOSE_PAREN;
+}
+
+static script_node* parse_statement(parser *p)
+{
+    size_t len = peek_word(p);
+    const char *word = p->pos;
+
+    if (in_words(word, len, CLOSING_WORDS))
+    {
+        fail(p, word, len);
+        return NULL;
+    }
+
+    if (len == 2 && !strncmp(word, "if", 2))
+        return parse_if(p);
+
+    if (len == 5 && !strncmp(word, "while", 5))
+        return parse_loop(p, NODE_WHILE);
+
+    if (len == 5 && !strncmp(word, "until", 5))
+        return parse_loop(p, NODE_UNTIL);
+
+    if (len == 3 && !strncmp(word, "for", 3))
+        return parse_for(p);
+
+    if (len == 4 && !strncmp(word, "case", 4))
+        return parse_case(p);
+
+    if (len == 8 && !strncmp(word, "function", 8))
+        return parse_function(p, 1);
+
+    if (len == 1 && *word == '{')
+        return parse_group(p);
+
+    if (len == 1 && *word == '!')
+    {
+        script_node *n = new_node(NODE_NOT);
+
+        p->pos++;
+        skip_blanks(p);
+
+        if (!*p->pos)
+            incomplete(p);
+        else if (!(n->body = parse_statement(p)) && p->result == PARSE_OK)
+            fail(p, p->pos, 1);
+
+        if (p->result != PARSE_OK)
+        {
+            free_script(n);
+            return NULL;
+        }
+
+        return n;
+    }
+
+    if (at_function_definition(p, len))
+        return parse_function(p, 0);
+
+    return parse_command(p);
+}
+
+/* Analiza una sentencia seguida de cualquier numero de '&& sentencia' o '|| sentencia' */
+static script_node* parse_and_or(parser *p)
+{
+    script_node *left = parse_statement(p);
+
+    while (left)
+    {
+        skip_blanks(p);
+
+        if ((*p->pos != ASCII_AMPERSAND && *p->pos != ASCII_PLECA) || p->pos[1] != *p->pos)
+            break;
+
+        script_node *n = new_node(*p->pos == ASCII_AMPERSAND ? NODE_AND : NODE_OR);
+
+        n->cond = left;
+        left = n;
+        p->pos += 2;
+
+        /* Despues de && y || se admiten saltos de linea */
+        skip_blanks(p);
+
+        while (*p->pos == ASCII_LINE_BREAK)
+        {
+            p->pos++;
+            skip_blanks(p);
+        }
+
+        if (!*p->pos)
+            incomplete(p);
+        else
+            n->body = parse_statement(p);
+
+        if (!n->body)
+        {
+            free_script(left);
+            return NULL;
+        }
+    }
+
+    return left;
+}
+
+/* Analiza sentencias hasta una palabra de stops, sin consumirla, o hasta el final del texto si stops es NULL */
+static script_node* parse_list(parser *p, const char **stops)
+{
+    script_node *head = NULL;
+    script_node **tail = &head;
+
+    while (1)
+    {
+        skip_separators(p);
+
+        if (!*p->pos)
+        {
+            if (stops)
+                incomplete(p);
+
+            break;
+        }
+
+        if (*p->pos == ';')
+        {
+            if (!in_words(";;", 2, stops))
+                fail(p, p->pos, 2);
+
+            break;
+        }
+
+        if (in_words(p->pos, peek_word(p), stops))
+            break;
+
+        if (!(*tail = parse_and_or(p)))
+            break;
+
+        tail = &(*tail)->next;
+    }
+
+    if (p->result != PARSE_OK)
+    {
+        free_script(head);
+        return NULL;
+    }
+
+    return head;
+}
+
+SCRIPT_PARSE_RESULT script_parse(const char *text, script_node **tree)
+{
+    parser p = { .pos = text, .result = PARSE_OK };
+
+    *tree = parse_list(&p, NULL);
+
+    return p.result;
+}
+
+static case_item* clone_items(const case_item *item)
+{
+    if (!item)
+        return NULL;
+
+    case_item *c = calloc(1, sizeof(case_item));
+
+    c->n_patterns = item->n_patterns;
+    c->patterns = malloc(sizeof(char*) * (item->n_patterns + 1));
+
+    for (int i = 0; i < item->n_patterns; i++)
+        c->patterns[i] = strdup(item->patterns[i]);
+
+    c->body = clone_script(item->body);
+    c->next = clone_items(item->next);
+
+    return c;
+}
+
+script_node* clone_script(const script_node *n)
+{
+    if (!n)
+        return NULL;
+
+    script_node *c = new_node(n->type);
+
+    c->text = n->text ? strdup(n->text) : NULL;
+    c->name = n->name ? strdup(n->name) : NULL;
+    c->cond = clone_script(n->cond);
+    c->body = clone_script(n->body);
+    c->alt = clone_script(n->alt);
+    c->items = clone_items(n->items);
+    c->next = clone_script(n->next);
+
+    return c;
+}
+
+void free_script(script_node *n)
+{
+    while (n)
+    {
+        script_node *next = n->next;
+        case_item *item = n->items;
+
+        while (item)
+        {
+            case_item *next_item = item->next;
+
+            free_array(item->patterns, item->n_patterns);
+            free_script(item->body);
+            free(item);
+            item = next_item;
+        }
+
+        free(n->text);
+        free(n->name);
+        free_script(n->cond);
+        free_script(n->body);
+        free_script(n->alt);
+        free(n);
+        n = next;
+    }
+}
+
+const char* script_word_end(const char *s)
+{
+    return scan_text(s, 1);
+}
+
+int is_script_keyword(const char *word)
+{
+    return in_words(word, strlen(word), KEYWORDS);
+}
@@ -0,0 +1,90 @@
+/**
+ * @file Trace.c
+ * @author Bottini, Franco Nicolas.
+ * @brief Implementacion del trazado de las fases de ejecucion de MyShell.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../../inc/Trace/Trace.h"
+
+int trace_enabled = 0;
+
+static trace_event *trace_ring = NULL;
+static volatile uint64_t trace_head = 0;
+static const char *trace_path = NULL;
+static pid_t trace_owner = 0;
+
+void trace_init(void)
+{
+    trace_path = getenv(TRACE_ENV_VAR);
+
+    if (!trace_path || !*trace_path)
+        return;
+
+    trace_ring = calloc(TRACE_RING_SIZE, sizeof(trace_event));
+
+    if (!trace_ring)
+        return;
+
+    trace_owner = getpid();
+    trace_enabled = 1;
+
+    atexit(trace_flush);
+}
+
+uint64_t trace_clock(void)
+{
+    return get_monotonic_ns();
+}
+
+void trace_record(const char *name, uint64_t start, int64_t arg)
+{
+    uint64_t now = trace_clock();
+    trace_event *e = &trace_ring[trace_head++ & (TRACE_RING_SIZE - 1)];
+
+    e->name = name;
+    e->ts = start;
+    e->dur = now - start;
+    e->arg = arg;
+}
+
+void trace_flush(void)
+{
+    if (!trace_enabled || getpid() != trace_owner)
+        return;
+
+    trace_enabled = 0;
+
+    FILE *fp = fopen(trace_path, "w");
+
+    if (!fp)
+        return;
+
+    uint64_t first = trace_head > TRACE_RING_SIZE ? trace_head - TRACE_RING_SIZE : 0;
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(fp, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"MyShell\"}}", trace_owner, trace_owner);
+
+    for (uint64_t i = first; i < trace_head; i++)
+    {
+        trace_event *e = &trace_ring[i & (TRACE_RING_SIZE - 1)];
+
+        fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"myshell\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d",
+                e->name, e->ts / 1000.0, e->dur / 1000.0, trace_owner, trace_owner);
+
+        if (e->arg >= 0)
+            fprintf(fp, ",\"args\":{\"value\":%lld}", (long long)e->arg);
+
+        fprintf(fp, "}");
+    }
+
+    fprintf(fp, "\n]}\n");
+    fclose(fp);
+
+    free(trace_ring);
+    trace_ring = NULL;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file Scan.c
+ * @author Bottini, Franco Nicolas.
+ * @brief Implementacion del escaner de caracteres especiales.
+ * @version 1.5
+ * @date Octubre de 2022.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../../inc/Utilities/Scan.h"
+
+typedef const char* (*scan_function)(const char* str, const char* set, size_t n_set);
+
+static const char* scan_resolve(const char* str, const char* set, size_t n_set);
+
+static scan_function scan_impl = scan_resolve;
+
+static const char* scan_scalar(const char* str, const char* set, size_t n_set)
+{
+    return str + strcspn(str, set);
+}
+
+#ifdef SCAN_SIMD
+
+/*
+ * Los bloques se leen alineados, por lo que nunca cruzan a una pagina que no contiene a la cadena aunque se lean
+ * bytes posteriores a su fin. Los bytes previos al comienzo del primer bloque se descartan de la mascara.
+ */
+__attribute__((target("sse2"), no_sanitize_address))
+static const char* scan_sse2(const char* str, const char* set, size_t n_set)
+{
+    __m128i want[SCAN_SSE2_MAX_SET];
+    uintptr_t offset = (uintptr_t)str & 15;
+    const __m128i* block = (const __m128i*)(str - offset);
+    unsigned mask = 0xFFFFu << offset;
+
+    if (n_set > SCAN_SSE2_MAX_SET)
+        return scan_scalar(str, set, n_set);
+
+    for (size_t i = 0; i < n_set; i++)
+        want[i] = _mm_set1_epi8(set[i]);
+
+    for (;; block++, mask = 0xFFFFu)
+    {
+        __m128i data = _mm_load_si128(block);
+        __m128i hits = _mm_cmpeq_epi8(data, _mm_setzero_si128());
+
+        for (size_t i = 0; i < n_set; i++)
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(data, want[i]));
+
+        if ((mask &= (unsigned)_mm_movemask_epi8(hits)))
+            return (const char*)block + __builtin_ctz(mask);
+    }
+}
+
+/* Cada nibble alto distinto del conjunto recibe un bit; el fin de cadena siempre pertenece */
+static int build_set(const char* set, scan_set* t)
+{
+    int groups = 1;
+
+    memset(t, 0, sizeof(scan_set));
+    t->lo[0] = t->hi[0] = 1;
+
+    for (; *set; set++)
+    {
+        uint8_t c = (uint8_t)*set;
+
+        if (!t->hi[c >> 4])
+        {
+            if (groups == 8)
+                return -1;
+
+            t->hi[c >> 4] = 1 << groups++;
+        }
+
+        t->lo[c & 15] |= t->hi[c >> 4];
+    }
+
+    return 0;
+}
+
+__attribute__((target("avx2"), no_sanitize_address))
+static const char* scan_avx2(const char* str, const char* set, size_t n_set)
+{
+    scan_set t;
+    uintptr_t offset = (uintptr_t)str & 31;
+    const __m256i* block = (const __m256i*)(str - offset);
+    unsigned mask = 0xFFFFFFFFu << offset;
+
+    if (build_set(set, &t) < 0)
+        return scan_scalar(str, set, n_set);
+
+    __m256i lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)t.lo));
+    __m256i hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)t.hi));
+    __m256i nibble = _mm256_set1_epi8(15);
+
+    for (;; block++, mask = 0xFFFFFFFFu)
+    {
+        __m256i data = _mm256_load_si256(block);
+        __m256i groups = _mm256_and_si256(_mm256_shuffle_epi8(lo, _mm256_and_si256(data, nibble)),
+                                          _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi16(data, 4), nibble)));
+        __m256i misses = _mm256_cmpeq_epi8(groups, _mm256_setzero_si256());
+
+        if ((mask &= ~(unsigned)_mm256_movemask_epi8(misses)))
+            return (const char*)block + __builtin_ctz(mask);
+    }
+}
+
+#endif
+
+/* Elige la implementacion en la primera busqueda, segun el procesador y el limite de MYSHELL_SCAN */
+static const char* scan_resolve(const char* str, const char* set, size_t n_set)
+{
+    const char* limit = getenv(SCAN_ENV_VAR);
+
+    scan_impl = scan_scalar;
+
+#ifdef SCAN_SIMD
+    if (!limit || strcmp(limit, "scalar"))
+    {
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx2") && (!limit || !strcmp(limit, "avx2")))
+            scan_impl = scan_avx2;
+        else if (__builtin_cpu_supports("sse2"))
+            scan_impl = scan_sse2;
+    }
+#else
+    (void)limit;
+#endif
+
+    return scan_impl(str, set, n_set);
+}
+
+char* find_chars(const char* str, const char* set)
+{
+    return (char*)scan_impl(str, set, strlen(set));
+}
@@ -13,58 +13,108 @@
 
 char* get_substr_before_chars(char* str, char c1, char c2)
 {
-    int l = 0;
-    char* substr = malloc(sizeof(char));
+    size_t l = find_chars(str, (char[]){ c1, c2, ASCII_END_OF_STRING }) - str;
 
-    for (size_t i = 0; (i < strlen(str) && str[i] != c1 && str[i] != c2); i++)
-    {
-        substr[l++] = str[i];
-        substr = realloc(substr, (l + 1) * sizeof(char));
-    }
+    char* substr = malloc((l + 1) * sizeof(char));
 
-    substr[l++] = ASCII_END_OF_STRING;
+    memcpy(substr, str, l);
+    substr[l] = ASCII_END_OF_STRING;
 
     return substr;
 }
 
 char* get_word_after_char(char* str, char c)
 {
-    int l = 0;
-    char* word = malloc(sizeof(char));
-    
-    int match = 0;
-    for (size_t i = 0; i < strlen(str); i++)
+    char set[] = { c, ASCII_END_OF_STRING };
+    char* start = find_chars(str, set);
+    char* end;
+    char* word;
+    size_t l = 0;
+
+    if (!*start)
+        return NULL;
+
+    while (*start == c || *start == ASCII_SPACE)
+        start++;
+
+    /* La palabra termina en el primer espacio y no incluye las apariciones del caracter dentro de ella */
+    end = find_chars(start, " ");
+    word = malloc(end - start + 2);
+
+    for (char* s = start; s < end; )
     {
-        if(match)
+        char* next = find_chars(s, set);
+
+        if (next > end)
+            next = end;
+
+        memcpy(word + l, s, next - s);
+        l += next - s;
+        s = next + 1;
+    }
+
+    if (l < 1)
+        word[l++] = ASCII_LINE_BREAK;
+
+    word[l] = ASCII_END_OF_STRING;
+
+    return word;
+}
+
+char* cut_error_redirection(char* str, int* merge)
+{
+    char* path = NULL;
+
+    *merge = 0;
+
+    /* Las dos redirecciones terminan en '>': se salta de uno al siguiente y se mira el caracter previo */
+    for (char* g = find_chars(str, ">"); *g; g = find_chars(g + 1, ">"))
+    {
+        size_t i = g - str;
+
+        if (i == 0)
+            continue;
+
+        i--;
+
+        if (str[i] == ASCII_AMPERSAND)
+        {
+            str[i] = ASCII_SPACE;
+            *merge = 1;
+        }
+        else if (str[i] == ASCII_TWO && (i == 0 || str[i - 1] == ASCII_SPACE))
         {
-            if (str[i] == c)
+            if (str[i + 2] == ASCII_AMPERSAND && str[i + 3] == ASCII_ONE)
+            {
+                memset(str + i, ASCII_SPACE, 4);
+                *merge = 1;
                 continue;
-                
-            if(str[i] != ASCII_SPACE)
+            }
+
+            size_t start, end;
+
+            str[i] = str[i + 1] = ASCII_SPACE;
+
+            for (start = i + 2; str[start] == ASCII_SPACE; start++);
+            end = find_chars(str + start, " <>") - str;
+
+            free(path);
+            path = malloc(end - start + 2);
+
+            if (end == start)
+                strcpy(path, "\n");
+            else
             {
-                word[l++] = str[i];
-                word = realloc(word, (l + 1) * sizeof(char));
+                memcpy(path, str + start, end - start);
+                path[end - start] = ASCII_END_OF_STRING;
             }
-            else if(l > 0)
-                break;
-        }
-        else if (str[i] == c)
-        {
-            match = 1;
+
+            memset(str + start, ASCII_SPACE, end - start);
+            g = str + end - 1;
         }
     }
 
-    if(match)
-    {
-        if (l < 1)
-            word[l] = ASCII_LINE_BREAK;
-        else
-            word[l] = ASCII_END_OF_STRING;
-        
-        return word;
-    }
-    else
-        return NULL;
+    return path;
 }
 
 char* trim_white_space(char* str)
@@ -85,6 +135,21 @@ char* trim_white_space(char* str)
     return str;
 }
 
+char* get_matching_paren(char* str)
+{
+    int depth = 0;
+
+    for (; *str; str++)
+    {
+        if (*str == ASCII_OPEN_PAREN)
+            depth++;
+        else if (*str == ASCII_CLOSE_PAREN && --depth == 0)
+            return str;
+    }
+
+    return NULL;
+}
+
 char** str_to_array(char* str, int* n)
 {
     char** argv = malloc(sizeof(char*));
@@ -94,7 +159,7 @@ char** str_to_array(char* str, int* n)
     char* token = strtok(str, " ");
     while (token != NULL)
     {
-        argv[*n] = malloc(sizeof(char) * strlen(token));
+        argv[*n] = malloc(sizeof(char) * (strlen(token) + 1));
         strcpy(argv[(*n)++], token);
         argv = realloc(argv, sizeof(char*) * (*n + 1));
         token = strtok(NULL, " ");
@@ -105,6 +170,15 @@ char** str_to_array(char* str, int* n)
     return argv;
 }
 
+uint64_t get_monotonic_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
 void free_array(char** array, int n)
 {
     for (int i = 0; i < n; i++)
@@ -0,0 +1,35 @@
+# Dependencias entre trabajos: after %N encola un comando hasta que sus prerequisitos finalizan con exito
+
+printf 'sleep 0.2\nexit 3\n' > "$WORK/cwd/fail.sh"
+
+check_match "a dependent runs after its prerequisite" 0 '^dep$' '/bin/sleep 0.2 &
+after %1 /bin/echo dep &
+wait'
+
+check_match "a dependent waits while its prerequisite runs" 0 '^\[2\] -1 queued /bin/echo \(after %1\)$' '/bin/sleep 0.2 &
+after %1 /bin/echo dep &
+jobs
+wait'
+
+check_match "a failed prerequisite cancels its dependents in chain" 0 '^st 1$' '/bin/sh fail.sh &
+after %1 /bin/echo dep &
+after %2 /bin/echo dep2 &
+wait %3
+echo st $?'
+
+check_match "a prerequisite that already finished with status 0 is satisfied" 0 '^now$' '/bin/true &
+/bin/sleep 0.2
+after %1 /bin/echo now &
+wait'
+
+check_match "a prerequisite that already failed is not launched" 0 '^st 1$' '/bin/false &
+/bin/sleep 0.2
+after %1 /bin/echo now &
+echo st $?
+wait'
+
+check_err "an unknown job is reported" 'Job 7 not found' 'after %7 /bin/echo x &'
+
+check_err "a prerequisite that already failed is reported" 'after: job 1 failed' '/bin/false &
+/bin/sleep 0.2
+after %1 /bin/echo now &'
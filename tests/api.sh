@@ -0,0 +1,111 @@
+# Biblioteca libmyshell: un programa de prueba enlazado con lib/libmyshell.a lanza trabajos sin la shell
+
+cat > "$WORK/api.c" << 'EOF'
+#include <stdio.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+
+#include "Api/MyShellApi.h"
+
+static void on_done(myshell_job *mj, int status, void *data)
+{
+    printf("callback %s %d\n", (char*)data, status);
+    myshell_job_free(mj);
+}
+
+int main(void)
+{
+    myshell_context *ctx = myshell_context_new();
+    int out[2];
+    char buffer[64];
+    ssize_t n;
+
+    /* Pipeline con la salida en un pipe del llamador */
+    myshell_job *mj = myshell_job_new();
+    char *echo[] = { "echo", "one two", NULL }, *wc[] = { "wc", "-w", NULL };
+
+    pipe(out);
+    myshell_job_add_process(mj, echo);
+    myshell_job_add_process(mj, wc);
+    myshell_job_set_fds(mj, -1, out[1], -1);
+    myshell_job_launch(ctx, mj);
+    close(out[1]);
+
+    n = read(out[0], buffer, sizeof(buffer) - 1);
+    buffer[n > 0 ? n : 0] = 0;
+    printf("pipeline %s", buffer);
+    printf("status %d\n", myshell_job_wait(mj));
+    myshell_job_free(mj);
+
+    /* Comando inexistente */
+    char *missing[] = { "/nonexistent/command", NULL };
+
+    mj = myshell_job_new();
+    myshell_job_add_process(mj, missing);
+    myshell_job_launch(ctx, mj);
+    printf("missing %d\n", myshell_job_wait(mj));
+    myshell_job_free(mj);
+
+    /* Señal al grupo del trabajo */
+    char *sleeper[] = { "sleep", "10", NULL };
+
+    mj = myshell_job_new();
+    myshell_job_add_process(mj, sleeper);
+    myshell_job_launch(ctx, mj);
+    printf("running %d\n", myshell_job_status(mj));
+    myshell_job_signal(mj, SIGKILL);
+    printf("killed %d\n", myshell_job_wait(mj));
+    myshell_job_free(mj);
+
+    /* Finalizacion informada por el descriptor del contexto */
+    char *fail[] = { "false", NULL };
+    struct epoll_event ev = { .events = EPOLLIN };
+    int epfd = epoll_create1(0);
+
+    mj = myshell_job_new();
+    myshell_job_add_process(mj, fail);
+    myshell_job_set_callback(mj, on_done, "false");
+    myshell_job_launch(ctx, mj);
+
+    epoll_ctl(epfd, EPOLL_CTL_ADD, myshell_context_fd(ctx), &ev);
+    epoll_wait(epfd, &ev, 1, 5000);
+    myshell_context_dispatch(ctx, 0);
+
+    myshell_context_free(ctx);
+
+    return 0;
+}
+EOF
+
+check_true "libmyshell links into a C program" gcc -Wall -Werror -D_GNU_SOURCE -I"$ROOT_DIR/inc" "$WORK/api.c" \
+    "$ROOT_DIR/lib/libmyshell.a" -o "$WORK/api"
+
+(cd "$WORK/cwd" && timeout "$TIMEOUT" "$WORK/api" > "$WORK/stdout" 2> "$WORK/stderr")
+
+result "libmyshell runs pipelines, signals and callbacks" "$?" 0 "$(normalize < "$WORK/stdout")" "pipeline 2
+status 0
+missing 127
+running -1
+killed 137
+callback false 1"
+
+cat > "$WORK/opaque.c" << 'EOF'
+#include "MyShellApi.h"
+
+#ifdef __JOB_LIST_H__
+#error "the public header exposes the internal job list"
+#endif
+
+int main(void)
+{
+    myshell_job *mj = myshell_job_new();
+
+    myshell_job_free(mj);
+
+    return 0;
+}
+EOF
+
+check_true "the public header stands alone and keeps its types opaque" gcc -Wall -Werror -pedantic -I"$ROOT_DIR/inc/Api" \
+    "$WORK/opaque.c" "$ROOT_DIR/lib/libmyshell.a" -o "$WORK/opaque"
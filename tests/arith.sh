@@ -0,0 +1,28 @@
+# Expansion aritmetica $((...)) y el comando ((...)), evaluados dentro de la shell
+
+check "operators follow C precedence" 0 "7 1024 1 24 16" 'echo $((1 + 2 * 3)) $((2 ** 10)) $((7 % 3)) $((0x10 + 010)) $((1 << 4))'
+
+check "variables are read with or without \$" 0 "25 6" 'i=5
+echo $((i * i)) $(($i + 1))'
+
+check "conditional, logical and bitwise operators" 0 "1 1 -1" 'i=5
+echo $((i > 3 ? 1 : 0)) $((!0)) $((~0))'
+
+check "compound assignments store the result" 0 "i 7" 'i=5
+((i += 2))
+echo i $i'
+
+check "((expr)) drives a loop" 0 "j 0
+j 1
+j 2" 'j=0
+while (( j < 3 )); do echo j $j; j=$((j + 1)); done'
+
+check "((expr)) fails when the value is zero" 0 "st 1" '((0))
+echo st $?'
+
+check "an unset variable is zero" 0 "1" 'echo $((unset_variable + 1))'
+
+check "division by zero does not run the line" 0 "after" 'echo $((1 / 0))
+echo after'
+
+check_err "division by zero is reported" 'Division by 0' 'echo $((1 / 0))'
@@ -0,0 +1,34 @@
+# Varios archivos de comandos en una invocacion: cada uno en su sesion, con la salida en el orden dado
+
+printf '/bin/sleep 0.3\necho one\ncd /\nexport Q=1\n' > "$WORK/cwd/one.sh"
+printf 'echo two\n/bin/pwd\n/usr/bin/printenv Q\n/bin/false\n' > "$WORK/cwd/two.sh"
+printf 'echo three\n/bin/ls /nonexistent\n' > "$WORK/cwd/three.sh"
+printf 'echo ok\n' > "$WORK/cwd/ok.sh"
+
+# check_batch NAME STATUS EXPECTED ARGUMENTO...: la salida de los archivos, sin los comandos que se muestran, es EXPECTED
+check_batch()
+{
+    local name=$1 want_status=$2 want_output=$3
+    shift 3
+    (cd "$WORK/cwd" && timeout "$TIMEOUT" "$MYSHELL" "$@" 2> "$WORK/stderr" > "$WORK/stdout")
+    result "$name" "$?" "$want_status" "$(normalize < "$WORK/stdout" | grep -v '^> ')" "$want_output"
+}
+
+check_batch "output keeps the order of the files and sessions are isolated" 2 "one
+two
+$WORK/cwd
+three" one.sh two.sh three.sh --parallel 2
+
+cp "$WORK/stderr" "$WORK/batch.err"
+
+check_true "failed files are reported with their status" grep -q 'two.sh: exit status 1' "$WORK/batch.err"
+
+check_true "standard error of every file is kept" grep -q "cannot access '/nonexistent'" "$WORK/batch.err"
+
+check_batch "sessions run one at a time with --parallel 1" 2 "one
+two
+$WORK/cwd
+three" one.sh two.sh three.sh --parallel 1
+
+check_batch "files that all succeed exit with status 0" 0 "ok
+ok" ok.sh ok.sh
@@ -0,0 +1,42 @@
+# Cache de resultados: un comando repetido con las mismas entradas reproduce su salida sin lanzarse
+
+CACHE="MYSHELL_CACHE=$WORK/cache"
+printf '3\n1\n2\n' > "$WORK/cwd/data.txt"
+printf '3\n1\n2\n0\n' > "$WORK/cwd/more.txt"
+
+check "a hit replays the output" 0 "1
+2
+3
+1
+2
+3" 'cache /usr/bin/sort -n < data.txt
+cache /usr/bin/sort -n < data.txt' "$CACHE"
+
+check_match "a hit does not launch a job" 0 '^jobs launched +0$' 'cache /usr/bin/sort -n < data.txt
+stats' "$CACHE"
+
+check "a hit replays the exit status" 0 "st 2
+st 2" 'cache /bin/ls /nonexistent
+echo st $?
+cache /bin/ls /nonexistent
+echo st $?' "$CACHE"
+
+check_err "a hit replays standard error" 'cannot access' 'cache /bin/ls /nonexistent' "$CACHE"
+
+check "a changed input file is a miss" 0 "0
+1
+2
+3" '/bin/cp more.txt data.txt
+cache /usr/bin/sort -n < data.txt' "$CACHE"
+
+check "a hit rewrites the redirected file" 0 "same" 'cache /bin/date +%N > stamp.txt
+/bin/cp stamp.txt first.txt
+/bin/rm stamp.txt
+cache /bin/date +%N > stamp.txt
+/usr/bin/cmp -s stamp.txt first.txt && echo same' "$CACHE"
+
+check "variables named with -e are part of the key" 0 "a
+b" 'export TARGET=a
+cache -e TARGET /usr/bin/printenv TARGET
+export TARGET=b
+cache -e TARGET /usr/bin/printenv TARGET' "$CACHE"
@@ -0,0 +1,37 @@
+# Estructuras de control evaluadas dentro de la shell: if, while, for, case y funciones
+
+/bin/mkdir "$WORK/cwd/sub"
+/usr/bin/touch "$WORK/cwd/a"
+
+check "if and for over a list" 0 "file a
+dir sub" 'for f in a sub; do
+    if [ -d $f ]; then echo dir $f; else echo file $f; fi
+done'
+
+check "while with break and continue" 0 "i 1
+i 3" 'i=0
+while [ $i -lt 5 ]; do
+    i=$((i + 1))
+    if [ $i -eq 2 ]; then continue; fi
+    if [ $i -eq 4 ]; then break; fi
+    echo i $i
+done'
+
+check "continue N leaves nested loops" 0 "1 1
+2 1" 'for x in 1 2; do for y in 1 2; do if [ $y -eq 2 ]; then continue 2; fi; echo $x $y; done; done'
+
+check "functions get arguments and return a status" 0 "hello bob 2
+st 3" 'greet() { echo hello $1 $#; return 3; }
+greet bob x
+echo st $?'
+
+check "shift drops a function argument" 0 "rest b" 'f() { shift; echo rest $1; }
+f a b c'
+
+check "case matches fnmatch patterns" 0 "matched" 'case abc in a*) echo matched;; *) echo no;; esac'
+
+check "an if condition runs external commands" 0 "no" 'if /bin/false; then echo yes; else echo no; fi'
+
+check_match "a loop over builtins does not fork" 0 '^processes forked +0$' 'i=0
+while [ $i -lt 50 ]; do i=$((i + 1)); done
+stats'
@@ -0,0 +1,29 @@
+# Coprocesos: la shell escribe en la entrada de un comando y lee su salida por pipes
+
+check_match "read returns the coprocess reply" 0 '^hi$' 'coproc /bin/cat
+write hi
+read'
+
+check_match "named coprocesses are independent" 0 '^b$' 'coproc -u A /bin/cat
+coproc -u B /bin/cat
+write -u A a
+write -u B b
+read -u B'
+
+check_match "a bare write sends an empty line" 0 '^1$' 'coproc /usr/bin/wc -l
+write
+coproc -c
+read'
+
+check_match "read fails when the coprocess closes its output" 0 '^st 1$' 'coproc /bin/true
+/bin/sleep 0.1
+read
+echo st $?'
+
+check_match "a script that ends with a live coprocess exits" 0 '^end$' 'coproc /bin/cat
+write hi
+echo end'
+
+check_match "quit with a live coprocess exits" 0 '^end$' 'coproc /bin/cat
+echo end
+quit'
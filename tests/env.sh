@@ -0,0 +1,40 @@
+# Variables de la shell y entorno de los comandos: export, unset y asignaciones por comando
+
+check "a new variable is not passed to children" 0 "st 1" 'X=1
+/usr/bin/printenv X
+echo st $?'
+
+check "export passes a variable to children" 0 "1
+2" 'X=1
+export X
+/usr/bin/printenv X
+export Y=2
+/usr/bin/printenv Y'
+
+check "unset removes an exported variable" 0 "st 1" 'export Y=2
+unset Y
+/usr/bin/printenv Y
+echo st $?'
+
+check "inherited variables start out exported" 0 "inherited" '/usr/bin/printenv INHERITED' INHERITED=inherited
+
+check "an assignment before a command applies only to it" 0 "tmp
+z" 'Z=tmp /usr/bin/printenv Z
+echo z $Z'
+
+check "each pipeline stage takes its own assignments" 0 "2" 'A=1 /usr/bin/printenv A > /dev/null | B=2 /usr/bin/printenv B'
+
+check "an assignment before a function is restored after the call" 0 "in new
+out old" 'f() { echo in $V; }
+V=old
+V=new f
+echo out $V'
+
+check "a changed export reaches the next command" 0 "a
+b" 'export X=a
+/usr/bin/printenv X
+X=b
+/usr/bin/printenv X'
+
+check_match "export alone lists exported variables" 0 '^export X="1"$' 'export X=1
+export'
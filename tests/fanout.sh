@@ -0,0 +1,17 @@
+# Operador |+: cada consumidor recibe una copia completa de la salida del productor
+
+check "every consumer gets the whole stream" 0 "3
+3" '/usr/bin/seq 3 |+ /usr/bin/wc -l > a.txt |+ /usr/bin/wc -l
+/bin/cat a.txt'
+
+check "the last consumer can be piped further" 0 "3" '/usr/bin/seq 3 |+ /usr/bin/wc -c > /dev/null |+ /bin/cat | /usr/bin/wc -l'
+
+check "a consumer that exits early does not stop the others" 0 "1
+100000" '/usr/bin/seq 100000 |+ /usr/bin/head -1 > first.txt |+ /usr/bin/wc -l > n.txt
+/bin/cat first.txt
+/bin/cat n.txt'
+
+check "a single consumer is an ordinary pipe" 0 "2" '/usr/bin/seq 2 |+ /usr/bin/wc -l'
+
+check "the status is the last consumer's" 0 "st 1" '/usr/bin/seq 2 |+ /bin/cat > /dev/null |+ /bin/false
+echo st $?'
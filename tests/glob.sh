@@ -0,0 +1,23 @@
+# Expansion de nombres de ruta: *, ?, [...] y ** sobre el arbol de prueba de abajo
+
+(cd "$WORK/cwd" && /bin/mkdir -p src/x/y .hid dir && /usr/bin/touch a.c b.c c.h .dot.c src/m.c src/x/n.c src/x/y/o.c .hid/p.c)
+
+check "* matches names in sorted order" 0 "a.c b.c" 'echo *.c'
+
+check "? and [...] match one character" 0 "c.h a.c b.c" 'echo ?.h [ab].c'
+
+check "** matches any number of directories" 0 "src/m.c src/x/n.c src/x/y/o.c" 'echo src/**/*.c'
+
+check "** matches no directory and skips hidden ones" 0 "a.c b.c src/m.c src/x/n.c src/x/y/o.c" 'echo **/*.c'
+
+check "a trailing / matches only directories" 0 "d dir/
+d src/" 'for d in */; do echo d $d; done'
+
+check "hidden files need a leading ." 0 ".dot.c" 'echo .*.c'
+
+check "a pattern without matches is left as typed" 0 "*.zzz" 'echo *.zzz'
+
+check "redirect targets are not expanded" 0 "a.c b.c" '/bin/echo *.c > *.log
+/bin/cat *.log'
+
+check "external commands get the expanded words" 0 "3" '/bin/ls -d src/**/*.c | /usr/bin/wc -l'
@@ -0,0 +1,23 @@
+# Modos sin terminal: -c 'comando' y script por stdin
+
+check_c "-c runs a builtin" 0 "hi" 'echo hi'
+
+check_c "-c runs an external command directly" 0 "ext" '/bin/echo ext'
+
+check_c "-c returns the command's exit status" 1 "" '/bin/false'
+
+check_c "-c keeps builtin and job output in order" 0 "a
+b
+c" 'echo a; /bin/echo b; echo c'
+
+check "stdin script keeps builtin and job output in order" 0 "hi
+ext
+bye" 'echo hi
+/bin/echo ext
+echo bye'
+
+check "stdin script does not print the welcome banner" 0 "ok" 'echo ok'
+
+check "stdin script exits with the last status" 124 "" '/usr/bin/timeout 0.1 /bin/sleep 1'
+
+check_err "stdin script reports unknown commands" 'Command not found' '/nonexistent/command'
@@ -0,0 +1,41 @@
+# Listado de trabajos para herramientas: jobs --json, -r, -s, -p y --since
+
+run_script '/bin/sleep 0.3 &
+/bin/sleep 0.3 | /bin/cat &
+jobs -p'
+result "jobs -p prints one pid per process" "$?" 0 "$(normalize < "$WORK/stdout" | grep -cE '^[0-9]+$')" 3
+
+run_script '/bin/sleep 0.3 &
+/bin/sleep 0.3 &
+jobs -p
+jobs --json -p' MYSHELL_MAX_JOBS=1
+result "jobs -p skips queued jobs" "$?" 0 "$(normalize < "$WORK/stdout" | grep -cE '^[0-9]+$|^\{"now":[0-9]+,"pids":\[[0-9]+\]\}$'; normalize < "$WORK/stdout" | grep -cE -- '^-1$|[[,]-1[],]')" "2
+0"
+
+check_match "jobs -r lists running jobs" 0 '^\[1\] [0-9]+ running /bin/sleep$' '/bin/sleep 0.3 &
+jobs -r'
+
+run_script '/bin/sleep 0.3 &
+jobs -s
+echo end'
+result "jobs -s lists nothing while every job runs" "$?" 0 "$(normalize < "$WORK/stdout" | grep -v '/bin/sleep$')" "end"
+
+check_match "jobs --json lists jobs and processes" 0 '^\{"now":[0-9]+,"jobs":\[\{"id":1,"pgid":[0-9]+,"mode":"background",.*"argv":\["/bin/sleep","0.3"\]\}\]\}\]\}$' '/bin/sleep 0.3 &
+jobs --json'
+
+check_match "jobs --json shows after dependencies" 0 '"id":2,.*"after":\[1\]' '/bin/sleep 0.3 &
+after %1 /bin/true &
+jobs --json'
+
+check_match "jobs --json -p lists pids" 0 '^\{"now":[0-9]+,"pids":\[[0-9]+\]\}$' '/bin/sleep 0.3 &
+jobs --json -p'
+
+check_match "--since skips processes that did not change" 0 '^\{"now":[0-9]+,"jobs":\[\]\}$' '/bin/sleep 0.3 &
+jobs --json --since 9223372036854775807'
+
+run_script '/bin/sleep 0.3 &
+/bin/echo "a\b" x &
+jobs --json'
+normalize < "$WORK/stdout" | grep '^{' > "$WORK/jobs.json"
+
+check_true "jobs --json is valid JSON" python3 -c 'import json, sys; json.load(open(sys.argv[1]))' "$WORK/jobs.json"
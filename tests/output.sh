@@ -0,0 +1,28 @@
+# Captura de la salida de los trabajos en segundo plano y limite de descriptores
+
+check_match "background stdout is shown when the job finishes" 0 '^hello$' '/bin/echo hello &
+wait'
+
+check_match "background stderr goes through the shared channel" 2 "cannot access '/nonexistent'" '/bin/ls /nonexistent &
+wait %1'
+
+printf 'import os\nprint("wrote", os.write(2, b"e" * 150000))\n' > "$WORK/cwd/big.py"
+printf 'import os\nprint("wrote", os.write(2, b"e" * 5000000))\n' > "$WORK/cwd/huge.py"
+
+run_script '/usr/bin/python3 big.py &
+/usr/bin/python3 huge.py &
+wait'
+result "background stderr over 64 KiB is kept whole" "$?" 0 \
+    "$(normalize < "$WORK/stdout" | grep -o 'wrote [0-9]*' | sort; normalize < "$WORK/stdout" | grep -o 'e\{1000\}' | wc -l)" "wrote 150000
+wrote 5000000
+5150"
+
+check_err "foreground stderr is not captured" "cannot access '/nonexistent'" '/bin/ls /nonexistent'
+
+check_match "many background jobs keep their own output" 0 '^job 40$' "$(for i in $(seq 40); do echo "/bin/echo job $i &"; done; echo wait)"
+
+check_true "children get the original soft descriptor limit" \
+    bash -c "ulimit -Sn 256 && printf '/bin/cat /proc/self/limits\n' | '$MYSHELL' | grep -Eq 'open files +256 '"
+
+check_true "zygote children get the original soft descriptor limit" \
+    bash -c "ulimit -Sn 256 && printf '/bin/cat /proc/self/limits\n' | MYSHELL_ZYGOTE=1 '$MYSHELL' | grep -Eq 'open files +256 '"
@@ -0,0 +1,26 @@
+# Builtin parallel
+
+check "parallel runs the template once per argument" 0 "x-a
+x-b
+x-c" 'parallel --keep-order /bin/echo x-{} ::: a b c'
+
+check "parallel appends the argument without {}" 0 "a
+b" 'parallel --keep-order -j 1 /bin/echo ::: a b'
+
+check "parallel --tag prefixes each line" 0 "a	a" 'parallel --tag /bin/echo ::: a'
+
+check_match "parallel returns the number of failed jobs" 0 '^st 2$' 'parallel /bin/ls ::: /nonexistent1 /nonexistent2 /
+echo st $?'
+
+check "parallel does not read the script as arguments" 0 "after" 'parallel /bin/echo {}
+/bin/echo after'
+
+check_err "parallel rejects a script on stdin as its source" 'standard input holds the script' 'parallel /bin/echo {}'
+
+printf 'a\nb\n' > "$WORK/cwd/items"
+
+check "parallel reads arguments from a file" 0 "a
+b" 'parallel --keep-order /bin/echo {} :::: items'
+
+check_true "parallel reads stdin with -c" \
+    bash -c "printf 'a\nb\n' | '$MYSHELL' -c 'parallel --keep-order /bin/echo x{} :::: -' | grep -q '^xb$'"
@@ -0,0 +1,17 @@
+# Sustitucion de procesos <(...) y >(...): el comando recibe un /dev/fd/N conectado por un pipe
+
+check "<(cmd) is read as a file" 0 "1	a
+2" '/usr/bin/paste <(/usr/bin/seq 2) <(/bin/echo a)'
+
+check "the command's status is kept" 0 "st 1" '/usr/bin/diff <(/usr/bin/seq 3) <(/usr/bin/seq 4) > /dev/null
+echo st $?'
+
+check ">(cmd) receives what the command writes" 0 "5
+5" '/usr/bin/seq 5 | /usr/bin/tee >(/usr/bin/wc -l > n.txt) > copy.txt
+/bin/cat n.txt
+/usr/bin/wc -l < copy.txt'
+
+check "a substitution can contain a command substitution" 0 "nested" '/bin/cat <(/bin/echo $(/bin/echo nested))'
+
+check "substitutions leave no jobs behind" 0 "" '/bin/cat <(/bin/echo x) > /dev/null
+jobs'
@@ -0,0 +1,13 @@
+# Redireccion de la salida de errores: 2>, 2>&1 y &>
+
+check "2> writes stderr to a file" 0 "/bin/ls: cannot access '/nonexistent': No such file or directory" '/bin/ls /nonexistent 2> err.txt
+/bin/cat err.txt'
+
+check "2>&1 sends stderr through the pipeline" 0 "1" '/bin/ls /nonexistent 2>&1 | /bin/wc -l'
+
+check "&> writes stdout and stderr to one file" 0 "2" '/bin/ls -d / /nonexistent &> all.txt
+/bin/wc -l < all.txt'
+
+check "2> keeps stdout on the terminal" 2 "/" '/bin/ls -d / /nonexistent 2> err.txt'
+
+check_err "2> without a file is a parse error" "Parse error near" '/bin/ls /nonexistent 2>'
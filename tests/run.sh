@@ -0,0 +1,137 @@
+#!/bin/bash
+#
+# Pruebas de comportamiento de MyShell. Cada archivo tests/*.sh define casos con las funciones de abajo: un caso
+# ejecuta comandos con '-c' o como script por stdin, sin terminal, y compara la salida estandar y el codigo de
+# salida con los esperados. Antes de comparar se quitan los colores, los espacios finales y las lineas vacias.
+#
+# Uso: tests/run.sh [MyShell] [archivo...]
+#
+
+MYSHELL=$(realpath "${1:-bin/MyShell}")
+TESTS_DIR=$(dirname "$(realpath "$0")")
+ROOT_DIR=$(dirname "$TESTS_DIR")
+WORK=$(mktemp -d)
+TIMEOUT=${CHECK_TIMEOUT:-20}
+
+passed=0
+failed=0
+
+shift
+trap 'rm -rf "$WORK"' EXIT
+
+normalize()
+{
+    sed 's/\x1b\[[0-9;]*m//g; s/[[:space:]]*$//' | grep -v '^$'
+}
+
+result()
+{
+    local name=$1 status=$2 want_status=$3 output=$4 want_output=$5
+
+    if [ "$status" = "$want_status" ] && [ "$output" = "$want_output" ]; then
+        passed=$((passed + 1))
+        return
+    fi
+
+    failed=$((failed + 1))
+    printf 'FAIL %s: %s\n' "$CASE_FILE" "$name"
+    printf '  status: %s, expected %s\n' "$status" "$want_status"
+
+    if [ "$output" != "$want_output" ]; then
+        diff <(printf '%s\n' "$want_output") <(printf '%s\n' "$output") | sed 's/^/  /'
+    fi
+
+    if [ -s "$WORK/stderr" ]; then
+        normalize < "$WORK/stderr" | head -5 | sed 's/^/  stderr: /'
+    fi
+}
+
+# Ejecuta el script dado en $1 por stdin, con el resto de los argumentos como entorno adicional
+run_script()
+{
+    local script=$1
+    shift
+    (cd "$WORK/cwd" && printf '%s\n' "$script" | env "$@" timeout "$TIMEOUT" "$MYSHELL" 2> "$WORK/stderr" > "$WORK/stdout")
+}
+
+# check NAME STATUS EXPECTED SCRIPT [VAR=valor...]: la salida estandar del script es EXPECTED
+check()
+{
+    local name=$1 want_status=$2 want_output=$3 script=$4
+    shift 4
+    run_script "$script" "$@"
+    result "$name" "$?" "$want_status" "$(normalize < "$WORK/stdout")" "$want_output"
+}
+
+# check_c NAME STATUS EXPECTED COMMAND: la salida estandar de 'myshell -c COMMAND' es EXPECTED
+check_c()
+{
+    (cd "$WORK/cwd" && timeout "$TIMEOUT" "$MYSHELL" -c "$4" 2> "$WORK/stderr" > "$WORK/stdout")
+    result "$1" "$?" "$2" "$(normalize < "$WORK/stdout")" "$3"
+}
+
+# check_match NAME STATUS REGEX SCRIPT [VAR=valor...]: alguna linea de la salida estandar del script cumple REGEX
+check_match()
+{
+    local name=$1 want_status=$2 regex=$3 script=$4
+    shift 4
+    run_script "$script" "$@"
+    local status=$? output
+
+    output=$(normalize < "$WORK/stdout")
+
+    if printf '%s\n' "$output" | grep -Eq -- "$regex"; then
+        result "$name" "$status" "$want_status" "" ""
+    else
+        result "$name" "$status" "$want_status" "$output" "(una linea que cumpla /$regex/)"
+    fi
+}
+
+# check_err NAME REGEX SCRIPT [VAR=valor...]: alguna linea de la salida de errores del script cumple REGEX
+check_err()
+{
+    local name=$1 regex=$2 script=$3
+    shift 3
+    run_script "$script" "$@"
+
+    local output
+
+    output=$(normalize < "$WORK/stderr")
+
+    if printf '%s\n' "$output" | grep -Eq -- "$regex"; then
+        result "$name" 0 0 "" ""
+    else
+        result "$name" 0 0 "$output" "(una linea de stderr que cumpla /$regex/)"
+    fi
+}
+
+# check_true NAME COMMAND...: un comando de la shell de pruebas finaliza con exito
+check_true()
+{
+    local name=$1
+    shift
+
+    if "$@" > "$WORK/stdout" 2> "$WORK/stderr"; then
+        result "$name" 0 0 "" ""
+    else
+        result "$name" "$?" 0 "$(normalize < "$WORK/stdout")" ""
+    fi
+}
+
+if [ $# -eq 0 ]; then
+    set -- "$TESTS_DIR"/*.sh
+fi
+
+for CASE_FILE in "$@"; do
+    [ "$(realpath "$CASE_FILE")" = "$TESTS_DIR/run.sh" ] && continue
+
+    rm -rf "$WORK/cwd"
+    mkdir -p "$WORK/cwd"
+
+    CASE_FILE=$(basename "$CASE_FILE")
+    . "$TESTS_DIR/$CASE_FILE"
+done
+
+printf '%d passed, %d failed\n' "$passed" "$failed"
+
+[ "$failed" -eq 0 ]
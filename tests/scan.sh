@@ -0,0 +1,28 @@
+# Busqueda de operadores en la linea de comandos: cada implementacion del escaner da el mismo resultado
+
+# Palabras de relleno que corren los operadores por distintas posiciones de los bloques de 16 y 32 bytes
+PAD=$(printf 'w%d ' $(seq 3000))
+
+# check_scan NAME EXPECTED COMMAND: 'myshell -c COMMAND' da EXPECTED con cada valor de MYSHELL_SCAN
+check_scan()
+{
+    local name=$1 want_output=$2 command=$3
+
+    for scan in scalar sse2 avx2; do
+        (cd "$WORK/cwd" && MYSHELL_SCAN=$scan timeout "$TIMEOUT" "$MYSHELL" -c "$command" 2> "$WORK/stderr" > "$WORK/stdout")
+        result "$name ($scan)" "$?" 0 "$(normalize < "$WORK/stdout")" "$want_output"
+    done
+}
+
+check_scan "a pipeline is split at |" "3" '/bin/echo a b c | /usr/bin/wc -w'
+
+# '/bin/echo ' ocupa 10 bytes y la palabra de ceros corre el | hasta el desplazamiento n
+for n in 14 15 16 17 30 31 32 33 47 48 64; do
+    check_scan "an operator at offset $n" "1" "/bin/echo $(printf "%0$((n - 11))d" 0) | /usr/bin/wc -l"
+done
+
+check_scan "redirections are found" "1" '/bin/echo hi > out.txt; /usr/bin/wc -l < out.txt'
+
+check_scan "a long line keeps its operators" "3000" "/bin/echo $PAD | /usr/bin/wc -w"
+
+check_scan "operators after a long line of words" "3001" "/bin/echo $PAD x > long.txt; /usr/bin/wc -w < long.txt"
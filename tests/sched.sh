@@ -0,0 +1,35 @@
+# Planificador de trabajos en segundo plano: cola con maximo de trabajos en ejecucion
+
+printf 'sleep 1\ntest -e started\n' > "$WORK/cwd/probe.sh"
+printf 'sleep 0.3\necho late\n' > "$WORK/cwd/late.sh"
+
+check_match "the cap keeps one job running at a time" 0 '^peak concurrent jobs 1$' '/bin/echo a &
+/bin/echo b &
+/bin/echo c &
+wait
+stats' MYSHELL_MAX_JOBS=1
+
+check_match "wait runs every queued job" 0 '^c$' '/bin/echo a &
+/bin/echo b &
+/bin/echo c &
+wait' MYSHELL_MAX_JOBS=1
+
+check_match "queued jobs are listed as queued" 0 '^\[2\] -1 queued /bin/echo$' '/bin/sleep 0.3 &
+/bin/echo b &
+jobs
+wait' MYSHELL_MAX_JOBS=1
+
+check_match "wait %N reports a queued job" 0 '^st 1$' '/bin/sleep 0.2 &
+/bin/false &
+wait %2
+echo st $?' MYSHELL_MAX_JOBS=1
+
+check_match "a queued job starts while a foreground command runs" 0 '^st 0$' '/bin/sleep 0.2 &
+/bin/touch started &
+/bin/sh probe.sh
+echo st $?' MYSHELL_MAX_JOBS=1
+
+check_match "the script waits for its background jobs" 0 '^late$' '/bin/sh late.sh &'
+
+check_match "the script keeps its own exit status" 1 '^\[1\] [0-9]+ done /bin/true$' '/bin/true &
+/bin/false'
@@ -0,0 +1,93 @@
+# Modo servidor: los pedidos se envian con un cliente minimo del protocolo de tramas
+
+cat > "$WORK/client.py" << 'EOF'
+import socket, struct, sys, time
+
+# Uso: client.py socket [--slow] pedido... Un pedido 'a:arg arg' se envia como argv; el resto como linea de comandos
+s = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+s.connect(sys.argv[1])
+slow = sys.argv[2] == '--slow'
+
+for request in sys.argv[3 if slow else 2:]:
+    kind, data = (b'a', request[2:].replace(' ', '\0').encode() + b'\0') if request.startswith('a:') else (b'c', request.encode())
+    s.sendall(struct.pack('=c3xI', kind, len(data)) + data)
+
+s.shutdown(socket.SHUT_WR)
+
+if slow:
+    time.sleep(1)
+
+reply = bytearray()
+
+while True:
+    chunk = s.recv(1 << 16)
+    if not chunk:
+        break
+    reply += chunk
+
+received = 0
+i = 0
+
+while i < len(reply):
+    kind, n = struct.unpack('=c3xI', reply[i:i + 8])
+    data = reply[i + 8:i + 8 + n]
+    i += 8 + n
+
+    if kind == b'x':
+        print('exit %d' % struct.unpack('=i', data)[0])
+    elif slow:
+        received += n
+    else:
+        sys.stdout.write(data.decode())
+
+if slow:
+    print('bytes %d' % received)
+EOF
+
+(cd "$WORK/cwd" && exec "$MYSHELL" --server "$WORK/server.sock" > /dev/null 2>&1) &
+SERVER_PID=$!
+
+for _ in $(seq 50); do
+    [ -S "$WORK/server.sock" ] && break
+    sleep 0.1
+done
+
+# check_server NAME EXPECTED PEDIDO...: la respuesta del servidor, normalizada, es EXPECTED
+check_server()
+{
+    local name=$1 want_output=$2
+    shift 2
+    (timeout "$TIMEOUT" python3 "$WORK/client.py" "$WORK/server.sock" "$@" 2> "$WORK/stderr" > "$WORK/stdout")
+    result "$name" "$?" 0 "$(normalize < "$WORK/stdout")" "$want_output"
+}
+
+check_server "server runs builtins and expansions" "hi 3
+exit 0" 'echo hi $((1+2))'
+
+check_server "server runs control flow and assignments" "n 1
+n 2
+v 5
+exit 0" 'for i in 1 2; do echo n $i; done; X=5; echo v $X'
+
+check_server "server applies redirections" "exit 0
+ok
+exit 0" '/bin/echo ok > out.txt' '/bin/cat out.txt'
+
+check_server "server merges stderr with 2>&1" "/bin/ls: cannot access '/nonexistent': No such file or directory
+exit 2" '/bin/ls /nonexistent 2>&1'
+
+check_server "server reports exit status" "exit 1
+exit 0" '/bin/false' 'true'
+
+check_server "server runs argv frames directly" "a \$HOME
+exit 0" 'a:/bin/echo a $HOME'
+
+check_server "server holds output of a slow client" "exit 0
+bytes 64000000" --slow '/usr/bin/head -c 64000000 /dev/zero'
+
+check_true "server does not buffer a slow client's output" awk '/^VmHWM/ { exit !($2 < 32768) }' "/proc/$SERVER_PID/status"
+
+kill "$SERVER_PID"
+wait "$SERVER_PID" 2> /dev/null
+
+check_true "server removes the socket on exit" test ! -e "$WORK/server.sock"
@@ -0,0 +1,9 @@
+# Tabla de trabajos en memoria compartida: MYSHELL_JOB_TABLE=1 publica /dev/shm/myshell-<pid>.jobs
+
+printf '/bin/echo $PPID > shell.pid\n/usr/bin/stat -c %%a /dev/shm/myshell-$PPID.jobs\n' > "$WORK/cwd/table.sh"
+
+check "the table is readable only by its user" 0 "600" '/bin/sh table.sh' MYSHELL_JOB_TABLE=1
+
+check_true "the table is removed when the shell exits" test ! -e "/dev/shm/myshell-$(cat "$WORK/cwd/shell.pid").jobs"
+
+check "no table is published by default" 1 "" '/bin/sh table.sh' MYSHELL_JOB_TABLE=0
@@ -0,0 +1,33 @@
+# Contadores e histogramas del builtin stats
+
+check_match "stats counts launched jobs" 0 '^jobs launched +2$' '/bin/true
+/bin/true
+stats'
+
+check_match "stats counts reaped jobs" 0 '^jobs reaped +2$' '/bin/true
+/bin/true
+stats'
+
+check_match "stats counts exec failures" 0 '^exec failures +1$' '/nonexistent/command
+stats'
+
+check_match "no job stays active" 0 '^active jobs +0$' '/bin/true
+/bin/true | /bin/true
+stats'
+
+check_match "process substitutions are counted with their job" 0 '^\{"jobs_launched":2,.*"jobs_reaped":2,.*"jobs_active":0,' '/bin/cat <(/usr/bin/seq 3) <(/bin/echo x)
+/bin/true
+stats --json'
+
+check_match "process substitutions count their processes" 0 '^processes forked +4$' '/bin/cat <(/usr/bin/seq 3) <(/bin/echo x)
+/bin/true
+stats'
+
+check_match "stats --json" 0 '^\{"jobs_launched":1,.*"jobs_reaped":1,.*"jobs_active":0,' '/bin/true
+stats --json'
+
+check_match "stats --reset clears the counters" 0 '^\{"jobs_launched":0,"jobs_queued":0,"processes_forked":0,' '/bin/true
+stats --reset
+stats --json'
+
+check_err "stats rejects unknown options" 'Usage: stats' 'stats --bogus'
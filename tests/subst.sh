@@ -0,0 +1,22 @@
+# Sustitucion de comandos $(...) y `...`: la salida del comando reemplaza al texto, separada en campos
+
+check "substitution output replaces the text" 0 "a b c" '/bin/echo $(/bin/echo a b) c'
+
+check "backticks and nested substitutions expand" 0 "x y" '/bin/echo `/bin/echo x` $(/bin/echo $(/bin/echo y))'
+
+check "trailing newlines are removed" 0 "1 2 3" '/bin/echo $(/usr/bin/seq 3)'
+
+check "an assignment keeps the substitution output" 0 "v hi" 'X=$(/bin/echo hi)
+echo v $X'
+
+check "an assignment sets \$? to the substitution status" 0 "status 1" 'X=$(/bin/false)
+/bin/echo status $?'
+
+check "a successful substitution sets \$? to 0" 0 "status 0" '/bin/false
+X=$(/bin/true)
+/bin/echo status $?'
+
+check_err "the substitution's stderr is shown" "cannot access '/nonexistent'" 'X=$(/bin/ls /nonexistent)'
+
+check "the substitution's stderr is not captured" 0 "v" 'X=$(/bin/ls /nonexistent)
+/bin/echo v $X'
@@ -0,0 +1,10 @@
+# Trazado de las fases de ejecucion (MYSHELL_TRACE)
+
+check "trace does not change the output" 0 "x" '/bin/echo x' MYSHELL_TRACE="$WORK/trace.json"
+
+check_true "trace is written at exit" grep -q '"traceEvents"' "$WORK/trace.json"
+
+check_true "trace records the launch and the wait of a job" \
+    grep -q '"name":"launch_job".*"name":"wait_for_job"\|"name":"wait_for_job".*"name":"launch_job"' <(tr -d '\n' < "$WORK/trace.json")
+
+check "trace to an unwritable path is ignored" 0 "x" '/bin/echo x' MYSHELL_TRACE=/nonexistent/trace.json
@@ -0,0 +1,31 @@
+# Builtins wait y bg
+
+check_match "wait returns the status of the job" 0 '^st 124$' '/usr/bin/timeout 0.2 /bin/sleep 5 &
+wait
+echo st $?'
+
+check_match "wait %N waits only for that job" 0 '^st 1$' '/bin/sleep 0.2 &
+/bin/false &
+wait %2
+echo st $?'
+
+check_match "wait -n returns when the first job finishes" 0 '^\[1\] [0-9]+ running /bin/sleep$' '/bin/sleep 1 &
+/bin/sleep 0.05 &
+wait -n
+jobs'
+
+check_match "wait %N on a job that already finished" 0 '^st 1$' '/bin/false &
+/bin/sleep 0.2
+jobs
+wait %1
+echo st $?'
+
+check_match "wait on an unknown job" 0 '^st 127$' 'wait %9
+echo st $?'
+
+check_err "wait reports an unknown job" 'Job 9 not found' 'wait %9'
+
+check_match "wait with nothing to wait for" 0 '^st 0$' 'wait
+echo st $?'
+
+check_err "bg on an unknown job" 'Job not found' 'bg %1'
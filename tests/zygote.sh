@@ -0,0 +1,28 @@
+# Creacion de procesos con el zygote
+
+check_match "zygote is off by default" 0 '^zygote: off$' 'zygote'
+
+check_match "zygote on" 0 '^zygote: on$' 'zygote on
+zygote'
+
+check_match "MYSHELL_ZYGOTE starts the zygote" 0 '^zygote: on$' 'zygote' MYSHELL_ZYGOTE=1
+
+check "zygote runs commands and pipelines" 0 "hi
+a" '/bin/echo hi
+/bin/echo a | /bin/cat' MYSHELL_ZYGOTE=1
+
+check_match "zygote spawns are measured apart" 0 '^zygote spawn-to-exec count 3 ' '/bin/echo hi
+/bin/echo a | /bin/cat
+stats' MYSHELL_ZYGOTE=1
+
+check_match "zygote reports exec failures" 0 '^st 1$' '/nonexistent/command
+echo st $?' MYSHELL_ZYGOTE=1
+
+check_match "zygote keeps the working directory" 0 '^/tmp$' 'cd /tmp
+/bin/pwd' MYSHELL_ZYGOTE=1
+
+check_match "zygote off falls back to fork" 0 '^spawn-to-exec +count 1 ' 'zygote off
+/bin/true
+stats' MYSHELL_ZYGOTE=1
+
+check_err "zygote rejects unknown options" 'Usage: zygote' 'zygote bogus'